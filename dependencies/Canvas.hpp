@@ -233,9 +233,9 @@ namespace Canvas
         }
     }
 
-    // Print a command error message showing the invalid command
-    // and instructing the user to use the help option.
-    inline void PrintCommandError(int argc, char const *argv[])
+    // Print a command error message showing the invalid command, the lines
+    // of helpText (the help menu) about it, and how to get the full help.
+    inline void PrintCommandError(int argc, char const *argv[], const std::string &helpText)
     {
         // Build the command string from the arguments.
         std::ostringstream commandStream;
@@ -252,31 +252,15 @@ namespace Canvas
         // Print the error message.
         PrintError(commandStr);
 
-        // Execute the help command and capture its output.
-        std::string helpCommand = std::string(argv[0]) + " --help";
-        FILE *pipe = popen(helpCommand.c_str(), "r");
-        if (!pipe)
-        {
-            PrintError("Failed to run help command.");
-            exit(1);
-        }
-        char buffer[128];
-        std::string helpOutput;
-        while (fgets(buffer, sizeof(buffer), pipe) != nullptr)
-        {
-            helpOutput += buffer;
-        }
-        pclose(pipe);
-
         // Use regex to select all commands related to argv[1].
         // Here, we assume that any line containing argv[1] (case-insensitive)
         // corresponds to a relevant command from the help output.
         std::string command = argv[0];
         std::string searchTerm = argv[1];
-        std::string patternString = std::string(R"((devcore\s+)") + searchTerm + R"(\s+\S+.*)│)";
+        std::string patternString = std::string(R"((devcore\s+)") + searchTerm + R"(\s+\S+.*)$)";
         std::regex pattern(patternString, std::regex_constants::icase);
 
-        std::istringstream iss(helpOutput);
+        std::istringstream iss(helpText);
         std::string line;
         std::ostringstream relevantCommands;
 
@@ -328,6 +312,10 @@ namespace Canvas
             }
         }
 
+        // The title is drawn in the top border of the first column.
+        if (cols > 0 && DisplayLength(title) > colWidths[0] + 2)
+            colWidths[0] = DisplayLength(title) - 2;
+
         // Helper lambda to repeat a string.
         auto repeat = [](const std::string &s, size_t count) {
             std::string result;
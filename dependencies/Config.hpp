@@ -27,7 +27,15 @@ inline std::string github = "https://github.com/mathlon26/DevCore-project-manage
 
 const std::vector<std::string> validKeys{
     "projects_path",
-    "editor"
+    "editor",
+    "git_branch",
+    "git_template",
+    "maintenance_jobs",
+    "maintenance_ionice",
+    "build_jobs",
+    "build_cache",
+    "build_cache_size",
+    "source_path"
 };
 
 // Utility function to trim whitespace from both ends of a string.
@@ -122,36 +130,9 @@ inline void updateFile() {
 
 
 // Load configuration from a .conf file with lines in the format "key = value".
-// Lines starting with '#' or empty lines are ignored.
-inline bool load(const std::string &filename, bool install=false) {
-    if (install) {
-        Canvas::PrintInfo("Checking for required directories");
-        fs::path configPath = filename;
-        fs::path configDir = configPath.parent_path();
-    
-        if (!fs::exists(configDir)) {
-            fs::create_directories(configDir);
-        }
-    
-        // Always clone and overwrite the configuration file
-        Canvas::PrintInfo("Cloning the DevCore repository to retrieve the default config.");
-        std::string cloneCommand = "git clone " + github + " /tmp/devcore_repo";
-        if (std::system(cloneCommand.c_str()) != 0) {
-            Canvas::PrintErrorExit("Failed to clone repository from " + Canvas::LinkText(github));
-        }
-        
-        fs::path sourceConfig = "/tmp/devcore_repo/devcore.conf";
-        if (!fs::exists(sourceConfig)) {
-            Canvas::PrintErrorExit("Default configuration file not found in the cloned repository.");
-        }
-        Canvas::PrintInfo("Copying the new config to '" + Canvas::LinkText(filename, Canvas::Color::CYAN) + "'");
-        // Overwrite the configuration file regardless of its existence.
-        fs::copy_file(sourceConfig, configPath, fs::copy_options::overwrite_existing);
-        Canvas::PrintInfo("Removing the temporary cloned repository.");
-        fs::remove_all("/tmp/devcore_repo");
-        Canvas::PrintSuccess(Canvas::BoldText("Done installing the default config.") + Canvas::ColorToAnsi(Canvas::Color::GREEN) + "\n    You can edit the config by running `devcore config set <key> <value>`. \n    Or editing the config file manually at '" + Canvas::LinkText(filename, Canvas::Color::GREEN) + "'");
-    }
-
+// Lines starting with '#' or empty lines are ignored. Nothing is printed, so
+// libdevcore reads the configuration through here as well.
+inline bool load(const std::string &filename) {
     std::ifstream file(filename);
     if (!file.is_open()) {
         return false;
@@ -185,24 +166,11 @@ inline bool load(const std::string &filename, bool install=false) {
     return true;
 }
 
-inline int setup(const std::string &filename)
-{
-    Canvas::ClearConsole();
-    Canvas::PrintTitle("DevCore | Setup Zone");
-    Canvas::PrintWarning("It seems like you do not yet have a config file. Would you like to install a default config? \n    If not check out '" + Canvas::LinkText(filename, Canvas::Color::YELLOW) + "' to configure one manually.");
-    if(Canvas::GetBoolInput("    ")) {
-        load(filename, true);
-        return 0;
-    }
-    return 0;
-}
-
-void validate()
+inline void validate()
 {
     if (configMap.empty())
     {
-        setup(configFilename);
-        exit(0);
+        Canvas::PrintErrorExit("No configuration is loaded. Run devcore again to install the default config, or write one manually.");
     }
 }
 
@@ -221,6 +189,16 @@ inline std::string get(const std::string &key) {
     return ""; // Unreachable, but added to satisfy the return type.
 }
 
+// Retrieve an optional configuration value by key.
+// Returns the fallback when the key has not been set.
+inline std::string getOr(const std::string &key, const std::string &fallback) {
+    auto it = configMap.find(key);
+    if (it != configMap.end() && !it->second.empty()) {
+        return it->second;
+    }
+    return fallback;
+}
+
 // Set a configuration value by key and update the configuration file.
 // If the key is not among the validKeys, print an error and exit.
 inline void set(const std::string &key, const std::string &value) {
@@ -0,0 +1,220 @@
+#ifndef BINARY_HPP
+#define BINARY_HPP
+
+#include <string>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Small helpers for the binary cache files devcore keeps under ~/.cache/devcore.
+namespace Binary
+{
+    // Append an unsigned LEB128 varint.
+    inline void PutVarint(std::string &out, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    // Read an unsigned LEB128 varint, advancing pos. Returns false on truncated input.
+    inline bool GetVarint(const char *data, size_t size, size_t &pos, uint64_t &value)
+    {
+        value = 0;
+        for (int shift = 0; pos < size && shift < 64; shift += 7)
+        {
+            unsigned char c = static_cast<unsigned char>(data[pos++]);
+            value |= uint64_t(c & 0x7f) << shift;
+            if (!(c & 0x80))
+                return true;
+        }
+        return false;
+    }
+
+    // Fixed width little endian values.
+    template <typename T>
+    inline void Put(std::string &out, T value)
+    {
+        char raw[sizeof(T)];
+        std::memcpy(raw, &value, sizeof(T));
+        out.append(raw, sizeof(T));
+    }
+
+    template <typename T>
+    inline bool Get(const char *data, size_t size, size_t &pos, T &value)
+    {
+        if (pos + sizeof(T) > size)
+            return false;
+        std::memcpy(&value, data + pos, sizeof(T));
+        pos += sizeof(T);
+        return true;
+    }
+
+    inline void PutString(std::string &out, const std::string &value)
+    {
+        PutVarint(out, value.size());
+        out.append(value);
+    }
+
+    inline bool GetString(const char *data, size_t size, size_t &pos, std::string &value)
+    {
+        uint64_t length;
+        if (!GetVarint(data, size, pos, length) || length > size - pos)
+            return false;
+        value.assign(data + pos, length);
+        pos += length;
+        return true;
+    }
+
+    // Read-only memory mapping of a whole file. Empty files map to an empty view.
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        explicit MappedFile(const std::string &path) { open(path); }
+        ~MappedFile() { close(); }
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        bool open(const std::string &path)
+        {
+            close();
+            int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0)
+                return false;
+            struct stat st;
+            if (fstat(fd, &st) != 0)
+            {
+                ::close(fd);
+                return false;
+            }
+            size_ = static_cast<size_t>(st.st_size);
+            if (size_ > 0)
+            {
+                void *mapped = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapped == MAP_FAILED)
+                {
+                    ::close(fd);
+                    size_ = 0;
+                    return false;
+                }
+                data_ = static_cast<const char *>(mapped);
+            }
+            ::close(fd);
+            open_ = true;
+            return true;
+        }
+
+        void close()
+        {
+            if (data_)
+                munmap(const_cast<char *>(data_), size_);
+            data_ = nullptr;
+            size_ = 0;
+            open_ = false;
+        }
+
+        bool isOpen() const { return open_; }
+        const char *data() const { return data_; }
+        size_t size() const { return size_; }
+
+    private:
+        const char *data_ = nullptr;
+        size_t size_ = 0;
+        bool open_ = false;
+    };
+
+    // Read a whole file into buffer, reusing its capacity. Returns false on error.
+    inline bool ReadInto(const std::string &path, std::string &buffer)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            return false;
+        buffer.clear();
+        char chunk[1 << 16];
+        ssize_t got;
+        while ((got = ::read(fd, chunk, sizeof(chunk))) > 0)
+            buffer.append(chunk, static_cast<size_t>(got));
+        ::close(fd);
+        return got == 0;
+    }
+
+    // Whether two files have the same content. Sizes are compared first, then
+    // the files are read side by side in fixed-size chunks, so neither is held
+    // in memory and the first difference ends the comparison. False on error.
+    inline bool SameContent(const std::string &first, const std::string &second)
+    {
+        struct stat a, b;
+        if (stat(first.c_str(), &a) != 0 || stat(second.c_str(), &b) != 0 || a.st_size != b.st_size)
+            return false;
+        int fds[2] = {::open(first.c_str(), O_RDONLY | O_CLOEXEC), ::open(second.c_str(), O_RDONLY | O_CLOEXEC)};
+        bool same = fds[0] >= 0 && fds[1] >= 0;
+        static const size_t CHUNK = 1 << 16;
+        std::string chunks[2] = {std::string(CHUNK, '\0'), std::string(CHUNK, '\0')};
+        while (same)
+        {
+            // Fill both chunks completely (read may return less), or up to the end.
+            size_t got[2] = {0, 0};
+            for (int i = 0; i < 2 && same; i++)
+            {
+                while (got[i] < CHUNK)
+                {
+                    ssize_t n = ::read(fds[i], &chunks[i][got[i]], CHUNK - got[i]);
+                    if (n < 0 && errno == EINTR)
+                        continue;
+                    if (n < 0)
+                        same = false;
+                    if (n <= 0)
+                        break;
+                    got[i] += static_cast<size_t>(n);
+                }
+            }
+            if (!same || got[0] != got[1] || std::memcmp(chunks[0].data(), chunks[1].data(), got[0]) != 0)
+                same = false;
+            else if (got[0] < CHUNK)
+                break;
+        }
+        for (int fd : fds)
+        {
+            if (fd >= 0)
+                ::close(fd);
+        }
+        return same;
+    }
+
+    // Write a file atomically: write to a temporary file next to it and rename over it.
+    // The temporary name is unique per process and call, so concurrent writers
+    // of the same path (e.g. parallel `devcore cc` runs) do not clobber each other.
+    inline bool WriteAtomic(const std::string &path, const std::string &content)
+    {
+        static std::atomic<unsigned> counter{0};
+        std::string temp = path + ".tmp" + std::to_string(::getpid()) + "." + std::to_string(counter++);
+        int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0)
+            return false;
+        size_t written = 0;
+        while (written < content.size())
+        {
+            ssize_t n = ::write(fd, content.data() + written, content.size() - written);
+            if (n <= 0)
+            {
+                ::close(fd);
+                ::unlink(temp.c_str());
+                return false;
+            }
+            written += static_cast<size_t>(n);
+        }
+        ::close(fd);
+        return ::rename(temp.c_str(), path.c_str()) == 0;
+    }
+} // namespace Binary
+
+#endif // BINARY_HPP
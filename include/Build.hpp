@@ -0,0 +1,448 @@
+#ifndef BUILD_HPP
+#define BUILD_HPP
+
+#include "../dependencies/Canvas.hpp"
+#include "../dependencies/Config.hpp"
+#include "DevCore.hpp"
+#include "Graph.hpp"
+#include "Main.hpp"
+#include "Process.hpp"
+#include "Strings.hpp"
+#include <string>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+#include <set>
+#include <functional>
+#include <condition_variable>
+#include <mutex>
+#include <chrono>
+#include <thread>
+#include <iomanip>
+#include <sstream>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+// `devcore build`: run the builds of many projects at once. All make
+// processes share one GNU make jobserver, a pipe holding one token per job
+// slot, so the total number of compilers running across every project never
+// exceeds the configured job count. devcore holds one token for each make it
+// starts (the slot make uses without asking), and make takes further tokens
+// from the pipe for its parallel jobs.
+namespace Build
+{
+    // Upper bound for -j and build_jobs. The jobserver writes one token per
+    // slot before any make runs, so they must fit in the pipe buffer.
+    const unsigned MAX_JOBS = 4096;
+
+    // A pipe based GNU make jobserver with a fixed number of slots.
+    class Jobserver
+    {
+    public:
+        explicit Jobserver(unsigned slots) : slots_(slots)
+        {
+            // Close-on-exec, so only the make processes, which are handed
+            // the ends explicitly (Fds), inherit them.
+            if (slots == 0 || slots > MAX_JOBS || pipe2(fds_, O_CLOEXEC) != 0)
+            {
+                fds_[0] = fds_[1] = -1;
+                return;
+            }
+            // Nobody reads the pipe yet: more tokens than fit in its buffer
+            // would block forever, and a short write leaves too few slots.
+            std::string tokens(slots, '+');
+            ssize_t written;
+            while ((written = write(fds_[1], tokens.data(), tokens.size())) < 0 && errno == EINTR)
+            {
+            }
+            if (written != static_cast<ssize_t>(tokens.size()))
+            {
+                close(fds_[0]);
+                close(fds_[1]);
+                fds_[0] = fds_[1] = -1;
+            }
+        }
+
+        ~Jobserver()
+        {
+            if (fds_[0] >= 0)
+            {
+                close(fds_[0]);
+                close(fds_[1]);
+            }
+        }
+
+        Jobserver(const Jobserver &) = delete;
+        Jobserver &operator=(const Jobserver &) = delete;
+
+        bool Valid() const { return fds_[0] >= 0; }
+
+        // Block until a slot is free and take it.
+        void Acquire()
+        {
+            char token;
+            while (read(fds_[0], &token, 1) < 0 && errno == EINTR)
+            {
+            }
+        }
+
+        void Release()
+        {
+            char token = '+';
+            while (write(fds_[1], &token, 1) < 0 && errno == EINTR)
+            {
+            }
+        }
+
+        // The pipe ends a child make must inherit (Process::Options::inheritFds).
+        std::vector<int> Fds() const { return {fds_[0], fds_[1]}; }
+
+        // MAKEFLAGS that make a child make join this jobserver.
+        std::string MakeFlags() const
+        {
+            return "-j" + std::to_string(slots_) + " --jobserver-auth=" + std::to_string(fds_[0]) + "," + std::to_string(fds_[1]);
+        }
+
+    private:
+        unsigned slots_;
+        int fds_[2];
+    };
+
+    struct Job
+    {
+        size_t project;       // Index into the projects of the build.
+        std::string name;     // Name of the project.
+        fs::path directory;   // Project folder.
+        fs::path log;         // Output of the build.
+        bool hasMakefile = false;
+        std::string status;   // Final state shown in the summary.
+        size_t waiting = 0;   // Dependencies that still have to be built.
+        int exitCode = -1;
+        double seconds = 0;
+        time_t finished = 0;  // End of a successful build.
+    };
+
+    inline bool HasMakefile(const fs::path &directory)
+    {
+        std::error_code ec;
+        for (const char *name : {"GNUmakefile", "makefile", "Makefile"})
+        {
+            if (fs::is_regular_file(directory / name, ec))
+                return true;
+        }
+        return false;
+    }
+
+    // Value of a simple variable assignment (NAME = value, :=, ?=) in the
+    // Makefile of a project, or fallback.
+    inline std::string MakefileVariable(const fs::path &directory, const std::string &name, const std::string &fallback)
+    {
+        std::ifstream in(directory / "Makefile");
+        std::string line;
+        while (std::getline(in, line))
+        {
+            size_t start = line.find_first_not_of(" \t");
+            if (start == std::string::npos || line.compare(start, name.size(), name) != 0)
+                continue;
+            size_t op = line.find_first_not_of(" \t", start + name.size());
+            if (op == std::string::npos)
+                continue;
+            size_t valueStart;
+            if (line.compare(op, 2, ":=") == 0 || line.compare(op, 2, "?=") == 0)
+                valueStart = op + 2;
+            else if (line.compare(op, 1, "=") == 0)
+                valueStart = op + 1;
+            else
+                continue;
+            std::string value = line.substr(valueStart);
+            value.erase(0, value.find_first_not_of(" \t"));
+            value.erase(value.find_last_not_of(" \t\r") + 1);
+            if (!value.empty())
+                return value;
+        }
+        return fallback;
+    }
+
+    inline fs::path LogPath(const DevCore::Project &proj)
+    {
+        return fs::path(Main::HOME_PATH + Main::CACHE_PATH) / "build" / proj.lang / (proj.folderName + ".log");
+    }
+
+    inline std::string formatSeconds(double seconds)
+    {
+        std::ostringstream ss;
+        ss << std::fixed << std::setprecision(1) << seconds << " s";
+        return ss.str();
+    }
+
+    // Number of job slots: the build_jobs config key, or the core count.
+    inline unsigned JobSlots()
+    {
+        unsigned cores = std::thread::hardware_concurrency();
+        std::string configured = Config::getOr("build_jobs", "");
+        uint64_t value = 0;
+        if (!configured.empty())
+        {
+            if (Strings::ParseCount(configured, value, MAX_JOBS) && value > 0)
+                return static_cast<unsigned>(value);
+            Canvas::PrintWarning("build_jobs must be between 1 and " + std::to_string(MAX_JOBS) + ", using the number of cores.");
+        }
+        return std::min(cores ? cores : 4, MAX_JOBS);
+    }
+
+    // Run make for one job once a job slot is free.
+    // A word for a make variable that reaches the shell of a recipe: single
+    // quoted for sh, with '$' doubled for make.
+    inline std::string MakeShellWord(const std::string &text)
+    {
+        std::string word = "'";
+        for (char c : text)
+        {
+            if (c == '\'')
+                word += "'\\''";
+            else if (c == '$')
+                word += "$$";
+            else
+                word += c;
+        }
+        return word + "'";
+    }
+
+    // With a wrapper ("<devcore> cc "), CC and CXX are overridden on the make
+    // command line so every compilation goes through `devcore cc` (see
+    // CompileCache). With force set, make itself rebuilds every target (-B).
+    inline void BuildOne(Job &job, Jobserver &jobserver, const Process::Options &makeOptions, const std::string &wrapper, bool force, std::mutex &printMutex)
+    {
+        if (!job.hasMakefile)
+        {
+            job.exitCode = 0;
+            job.status = "No Makefile";
+            return;
+        }
+        const std::string &name = job.name;
+        std::error_code ec;
+        fs::create_directories(job.log.parent_path(), ec);
+
+        jobserver.Acquire();
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::string> argv{"make", "-C", job.directory.string()};
+        if (force)
+            argv.push_back("-B");
+        if (!wrapper.empty())
+        {
+            argv.push_back("CC=" + wrapper + MakefileVariable(job.directory, "CC", "cc"));
+            argv.push_back("CXX=" + wrapper + MakefileVariable(job.directory, "CXX", "c++"));
+        }
+        Process::Options options = makeOptions;
+        options.logFile = job.log.string();
+        job.exitCode = Process::Execute(argv, options).exitCode;
+        job.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        jobserver.Release();
+        job.status = job.exitCode == 0 ? "OK" : "Failed (" + std::to_string(job.exitCode) + ")";
+
+        std::lock_guard<std::mutex> lock(printMutex);
+        if (job.exitCode == 0)
+            Canvas::PrintInfo("Built '" + name + "' in " + formatSeconds(job.seconds) + ".");
+        else
+            Canvas::PrintError("Build of '" + name + "' failed, see " + Canvas::LinkText(job.log.string(), Canvas::Color::RED));
+    }
+
+    // Build the named projects (every project with a Makefile when names is
+    // empty) and the projects they depend on, with at most slots jobs running
+    // in total, optionally through the compilation cache. Only projects that
+    // changed since their last successful build, and everything downstream of
+    // them, are rebuilt unless force is set, which also passes -B to make so
+    // that up to date targets are rebuilt too. A project starts as soon as all
+    // of its dependencies are built, so independent branches run in parallel.
+    inline int Run(const std::vector<std::string> &names, unsigned slots, bool cache = false, bool force = false)
+    {
+        Canvas::PrintTitle("DevCore | Build", Canvas::Color::CYAN);
+
+        std::vector<DevCore::Project> projects = DevCore::Projects();
+        std::vector<std::string> missing;
+        Graph::Dag dag = Graph::FromProjects(projects, missing);
+        for (const auto &edge : missing)
+            Canvas::PrintWarning("Unknown dependency " + edge + " is ignored.");
+        std::vector<size_t> cycle = Graph::FindCycle(dag);
+        if (!cycle.empty())
+        {
+            Canvas::PrintError("Dependency cycle: " + Graph::CycleToString(projects, cycle) + ".");
+            return 1;
+        }
+
+        std::set<size_t> roots;
+        for (const auto &name : names)
+        {
+            auto it = std::find_if(projects.begin(), projects.end(), [&](const DevCore::Project &proj) { return proj.name == name; });
+            if (it != projects.end())
+                roots.insert(it - projects.begin());
+            else
+                Canvas::PrintWarning("Project '" + name + "' does not exist.");
+        }
+        for (size_t p = 0; p < projects.size() && names.empty(); p++)
+        {
+            if (HasMakefile(projects[p].path))
+                roots.insert(p);
+        }
+        std::set<size_t> selected = Graph::Closure(dag.dependencies, roots);
+        if (selected.empty())
+        {
+            Canvas::PrintInfo("No projects with a Makefile to build.");
+            return 0;
+        }
+
+        std::set<size_t> changed;
+        for (size_t p : selected)
+        {
+            const DevCore::Project &proj = projects[p];
+            if (force || proj.lastBuild == 0 || proj.lastActivity > proj.lastBuild)
+                changed.insert(p);
+        }
+        std::set<size_t> rebuild;
+        for (size_t p : Graph::Closure(dag.dependents, changed))
+        {
+            if (selected.count(p))
+                rebuild.insert(p);
+        }
+
+        // Jobs are indexed like the projects; only selected ones are used.
+        std::vector<Job> jobs(projects.size());
+        std::vector<size_t> ready, order;
+        for (size_t p : selected)
+        {
+            Job &job = jobs[p];
+            const DevCore::Project &proj = projects[p];
+            job.project = p;
+            job.name = proj.name;
+            job.directory = proj.path;
+            job.log = LogPath(proj);
+            job.hasMakefile = HasMakefile(job.directory);
+            if (!rebuild.count(p))
+            {
+                job.status = "Up to date";
+                order.push_back(p);
+                continue;
+            }
+            for (size_t dep : dag.dependencies[p])
+                job.waiting += rebuild.count(dep);
+            if (job.waiting == 0)
+                ready.push_back(p);
+        }
+        if (rebuild.empty())
+        {
+            Canvas::PrintSuccess("All " + std::to_string(selected.size()) + " projects are up to date (use --force to rebuild).");
+            return 0;
+        }
+
+        Jobserver jobserver(slots);
+        if (!jobserver.Valid())
+        {
+            Canvas::PrintError("Unable to set up the jobserver pipe.");
+            return 1;
+        }
+        Process::Options makeOptions;
+        makeOptions.env = {"MAKEFLAGS=" + jobserver.MakeFlags()};
+        makeOptions.closeInput = true;
+        makeOptions.inheritFds = jobserver.Fds();
+
+        std::string wrapper;
+        if (cache)
+        {
+            std::error_code ec;
+            fs::path exe = fs::read_symlink("/proc/self/exe", ec);
+            if (ec)
+            {
+                Canvas::PrintWarning("Unable to locate the devcore executable (" + ec.message() + "), building without the compilation cache.");
+                cache = false;
+            }
+            else
+                wrapper = MakeShellWord(exe.string()) + " cc ";
+        }
+        Canvas::PrintInfo("Building " + std::to_string(rebuild.size()) + " projects with " + std::to_string(slots) + " job slots" +
+                          (cache ? " through the compilation cache." : "."));
+        auto start = std::chrono::steady_clock::now();
+
+        // Projects downstream of a failed build are skipped.
+        std::function<void(size_t)> skipDependents = [&](size_t p) {
+            for (size_t next : dag.dependents[p])
+            {
+                if (rebuild.count(next) && jobs[next].status.empty())
+                {
+                    jobs[next].status = "Skipped";
+                    order.push_back(next);
+                    skipDependents(next);
+                }
+            }
+        };
+
+        std::mutex stateMutex, printMutex;
+        std::condition_variable wakeup;
+        size_t unfinished = rebuild.size();
+        auto worker = [&]() {
+            std::unique_lock<std::mutex> lock(stateMutex);
+            while (true)
+            {
+                wakeup.wait(lock, [&] { return !ready.empty() || unfinished == 0; });
+                if (ready.empty())
+                    break;
+                size_t p = ready.back();
+                ready.pop_back();
+                lock.unlock();
+                BuildOne(jobs[p], jobserver, makeOptions, wrapper, force, printMutex);
+                lock.lock();
+
+                order.push_back(p);
+                if (jobs[p].exitCode == 0)
+                {
+                    jobs[p].finished = std::time(nullptr);
+                    for (size_t next : dag.dependents[p])
+                    {
+                        if (rebuild.count(next) && --jobs[next].waiting == 0 && jobs[next].status.empty())
+                            ready.push_back(next);
+                    }
+                }
+                else
+                    skipDependents(p);
+                unfinished = rebuild.size();
+                for (size_t q : rebuild)
+                    unfinished -= !jobs[q].status.empty();
+                wakeup.notify_all();
+            }
+        };
+        // The workers only wait for make, so their number follows the job
+        // slots rather than the core count (Parallel::ForEach caps at cores).
+        std::vector<std::thread> pool;
+        for (size_t t = 0; t < std::min<size_t>(slots, rebuild.size()); t++)
+            pool.emplace_back(worker);
+        for (auto &thread : pool)
+            thread.join();
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        for (size_t p : rebuild)
+        {
+            if (jobs[p].exitCode == 0)
+                DevCore::RecordBuild(projects[p], jobs[p].finished);
+        }
+        DevCore::Save();
+
+        size_t failed = 0;
+        std::vector<std::vector<std::string>> rows;
+        for (size_t p : order)
+        {
+            const Job &job = jobs[p];
+            bool ran = rebuild.count(p) && job.hasMakefile && job.status != "Skipped";
+            if (rebuild.count(p) && job.exitCode != 0)
+                failed++;
+            rows.push_back({job.name, job.status, ran ? formatSeconds(job.seconds) : "", ran ? job.log.string() : ""});
+        }
+        Canvas::PrintTable(" Build ", {"Project", "Status", "Time", "Log"}, rows, failed ? Canvas::Color::RED : Canvas::Color::GREEN);
+        if (failed)
+            Canvas::PrintError(std::to_string(failed) + " of " + std::to_string(rebuild.size()) + " builds failed or were skipped (" + formatSeconds(elapsed) + " total).");
+        else
+            Canvas::PrintSuccess("Built " + std::to_string(rebuild.size()) + " projects in " + formatSeconds(elapsed) + ".");
+        return failed ? 1 : 0;
+    }
+} // namespace Build
+
+#endif // BUILD_HPP
@@ -0,0 +1,164 @@
+#ifndef CLEAN_HPP
+#define CLEAN_HPP
+
+#include "../dependencies/Canvas.hpp"
+#include "DevCore.hpp"
+#include "Main.hpp"
+#include "Parallel.hpp"
+#include "Strings.hpp"
+#include <string>
+#include <vector>
+#include <set>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <cstdio>
+#include <filesystem>
+#include <unistd.h>
+
+// `devcore clean`: remove build outputs (build/, target/, node_modules, ...)
+// from all projects. The candidates and their sizes come from the scan every
+// command runs on load (Scan::BuildDirVisitor), so nothing is walked twice.
+// Deleting goes through a trash directory: each output is first renamed into
+// ~/.cache/devcore/trash, which is instant and leaves the project clean even
+// if the process is interrupted, and the trash is then emptied in parallel.
+namespace Clean
+{
+    struct Target
+    {
+        size_t project;    // Index into the projects passed along.
+        std::string path;  // Relative to the project folder.
+        uint64_t size;     // Bytes allocated on disk.
+    };
+
+    inline fs::path TrashPath()
+    {
+        return fs::path(Main::HOME_PATH + Main::CACHE_PATH) / "trash";
+    }
+
+    // Move every target into the trash. Targets on another filesystem than
+    // the trash cannot be renamed and are queued for deletion in place.
+    // Returns the paths to delete.
+    inline std::vector<fs::path> MoveToTrash(const std::vector<DevCore::Project> &projects, const std::vector<Target> &targets)
+    {
+        fs::path trash = TrashPath();
+        std::error_code ec;
+        fs::create_directories(trash, ec);
+
+        std::vector<fs::path> pending;
+        std::string prefix = std::to_string(getpid()) + "-" + std::to_string(std::time(nullptr)) + "-";
+        for (size_t i = 0; i < targets.size(); i++)
+        {
+            fs::path source = fs::path(projects[targets[i].project].path) / targets[i].path;
+            fs::path destination = trash / (prefix + std::to_string(i));
+            if (std::rename(source.c_str(), destination.c_str()) == 0)
+                pending.push_back(destination);
+            else if (fs::exists(source, ec))
+                pending.push_back(source);
+        }
+
+        // Leftovers of an interrupted earlier run are emptied as well.
+        std::set<fs::path> queued(pending.begin(), pending.end());
+        for (const auto &entry : fs::directory_iterator(trash, ec))
+        {
+            if (!queued.count(entry.path()))
+                pending.push_back(entry.path());
+        }
+        return pending;
+    }
+
+    // Delete the given paths in parallel. Returns the number of paths that
+    // could not be removed completely.
+    inline size_t Reclaim(const std::vector<fs::path> &paths)
+    {
+        std::atomic<size_t> failed{0};
+        Parallel::ForEach(paths.size(), [&](size_t i) {
+            std::error_code ec;
+            fs::remove_all(paths[i], ec);
+            if (ec)
+                failed++;
+        });
+        return failed;
+    }
+
+    // List the build outputs of the selected projects (all when names is
+    // empty) and delete them unless dryRun is set. Without assumeYes the user
+    // confirms first.
+    inline void Run(const std::vector<std::string> &names, bool dryRun, bool assumeYes)
+    {
+        std::vector<DevCore::Project> projects = DevCore::Projects();
+        std::vector<Target> targets;
+        for (size_t p = 0; p < projects.size(); p++)
+        {
+            const DevCore::Project &proj = projects[p];
+            if (!names.empty() && std::find(names.begin(), names.end(), proj.name) == names.end())
+                continue;
+            for (const auto &dir : proj.buildDirs)
+                targets.push_back({p, dir.second, dir.first});
+        }
+        for (const auto &name : names)
+        {
+            DevCore::Project proj;
+            if (!DevCore::FindProject(name, proj))
+                Canvas::PrintWarning("Project '" + name + "' does not exist.");
+        }
+        if (targets.empty())
+        {
+            Canvas::PrintInfo("No build outputs found.");
+            return;
+        }
+
+        std::sort(targets.begin(), targets.end(), [](const Target &a, const Target &b) { return a.size > b.size; });
+        uint64_t total = 0;
+        std::vector<std::vector<std::string>> rows;
+        for (const auto &target : targets)
+        {
+            total += target.size;
+            rows.push_back({projects[target.project].name, target.path + "/", Strings::FormatSize(target.size)});
+        }
+        rows.push_back({Canvas::BoldText("Total"), "", Strings::FormatSize(total)});
+        Canvas::PrintTable(" Build outputs ", {"Project", "Directory", "Size"}, rows, Canvas::Color::CYAN);
+
+        if (dryRun)
+        {
+            Canvas::PrintInfo(Strings::FormatSize(total) + " reclaimable in " + std::to_string(targets.size()) + " directories (dry run, nothing deleted).");
+            return;
+        }
+        if (!assumeYes && !Canvas::GetBoolInput(u8"🧹 Delete these " + std::to_string(targets.size()) + " directories?", "", Canvas::Color::RED))
+        {
+            Canvas::PrintInfo("Nothing deleted.");
+            return;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<size_t> cleaned;
+        std::vector<DevCore::Project> rescan;
+        uint64_t before = 0;
+        for (const auto &target : targets)
+        {
+            if (std::find(cleaned.begin(), cleaned.end(), target.project) == cleaned.end())
+            {
+                cleaned.push_back(target.project);
+                rescan.push_back(projects[target.project]);
+                before += projects[target.project].allocatedSize;
+            }
+        }
+        size_t failed = Reclaim(MoveToTrash(projects, targets));
+
+        // Rescan the cleaned projects so sizes and build outputs are current.
+        DevCore::Rescan(rescan);
+        DevCore::Save();
+        uint64_t after = 0;
+        for (const auto &proj : rescan)
+            after += proj.allocatedSize;
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        if (failed)
+            Canvas::PrintWarning(std::to_string(failed) + " directories could not be removed completely.");
+        Canvas::PrintSuccess("Reclaimed " + Strings::FormatSize(before > after ? before - after : 0) + " from " + std::to_string(cleaned.size()) + " projects in " +
+                             std::to_string(elapsed) + " ms.");
+    }
+} // namespace Clean
+
+#endif // CLEAN_HPP
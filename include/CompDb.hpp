@@ -0,0 +1,321 @@
+#ifndef COMPDB_HPP
+#define COMPDB_HPP
+
+#include "../dependencies/Canvas.hpp"
+#include "Build.hpp"
+#include "CompileCache.hpp"
+#include "DevCore.hpp"
+#include "Parallel.hpp"
+#include "Process.hpp"
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <iterator>
+#include <cstdio>
+
+// `devcore compdb`: write compile_commands.json for every C/C++ project, and
+// a merged database in the projects folder for editors that open several
+// projects as one workspace. The commands of a project with a Makefile are
+// recorded from a dry run (`make -n -B`), so whatever flags and
+// configuration the Makefile computes are what the language server sees;
+// projects without one get a command per source file with the usual
+// include directories.
+namespace CompDb
+{
+    const std::string FILE_NAME = "compile_commands.json";
+
+    struct Command
+    {
+        std::string directory;
+        std::string file;
+        std::string output;
+        std::vector<std::string> arguments;
+    };
+
+    // Split a shell command line into simple commands (at &&, ||, ; and |)
+    // of unquoted words. Enough for the commands make prints.
+    inline std::vector<std::vector<std::string>> SplitShell(const std::string &line)
+    {
+        std::vector<std::vector<std::string>> commands(1);
+        std::string word;
+        bool inWord = false;
+        auto endWord = [&]() {
+            if (inWord)
+                commands.back().push_back(word);
+            word.clear();
+            inWord = false;
+        };
+        for (size_t i = 0; i < line.size(); i++)
+        {
+            char c = line[i];
+            if (c == '\'')
+            {
+                size_t end = line.find('\'', i + 1);
+                word += line.substr(i + 1, end == std::string::npos ? std::string::npos : end - i - 1);
+                inWord = true;
+                i = end == std::string::npos ? line.size() : end;
+            }
+            else if (c == '"')
+            {
+                inWord = true;
+                for (i++; i < line.size() && line[i] != '"'; i++)
+                {
+                    if (line[i] == '\\' && i + 1 < line.size() && std::string("\"\\$`").find(line[i + 1]) != std::string::npos)
+                        i++;
+                    word += line[i];
+                }
+            }
+            else if (c == '\\' && i + 1 < line.size())
+            {
+                word += line[++i];
+                inWord = true;
+            }
+            else if (c == ' ' || c == '\t')
+                endWord();
+            else if (c == ';' || c == '|' || c == '&')
+            {
+                endWord();
+                if (i + 1 < line.size() && line[i + 1] == c)
+                    i++;
+                if (!commands.back().empty())
+                    commands.emplace_back();
+            }
+            else
+            {
+                word += c;
+                inWord = true;
+            }
+        }
+        endWord();
+        if (commands.back().empty())
+            commands.pop_back();
+        return commands;
+    }
+
+    // A compiler invocation for exactly one source file with -c, or nothing.
+    inline bool ToCommand(const std::vector<std::string> &words, const std::string &directory, Command &command)
+    {
+        bool compileOnly = false;
+        size_t sources = 0;
+        command = Command();
+        for (size_t i = 1; i < words.size(); i++)
+        {
+            if (words[i] == "-c")
+                compileOnly = true;
+            else if (words[i] == "-o" && i + 1 < words.size())
+                command.output = words[++i];
+            else if (words[i][0] != '-' && CompileCache::IsSource(words[i]))
+            {
+                command.file = words[i];
+                sources++;
+            }
+        }
+        if (!compileOnly || sources != 1)
+            return false;
+        command.directory = directory;
+        command.arguments = words;
+        return true;
+    }
+
+    // Record the compile commands of a Makefile project from `make -n -B`.
+    // The directory lines printed by -w follow recursive makes.
+    inline std::vector<Command> FromDryRun(const fs::path &projectDir)
+    {
+        std::string out, err;
+        Process::Capture({"make", "-n", "-B", "-w", "-C", projectDir.string()}, &out, &err);
+
+        std::vector<Command> commands;
+        std::vector<std::string> directories{projectDir.string()};
+        std::istringstream lines(out);
+        std::string line;
+        while (std::getline(lines, line))
+        {
+            size_t entering = line.find(": Entering directory '");
+            if (entering != std::string::npos && line.rfind("make", 0) == 0)
+            {
+                size_t start = entering + 22;
+                directories.push_back(line.substr(start, line.rfind('\'') - start));
+                continue;
+            }
+            if (line.find(": Leaving directory '") != std::string::npos && line.rfind("make", 0) == 0)
+            {
+                if (directories.size() > 1)
+                    directories.pop_back();
+                continue;
+            }
+            Command command;
+            for (const auto &words : SplitShell(line))
+            {
+                if (ToCommand(words, directories.back(), command))
+                    commands.push_back(command);
+            }
+        }
+        return commands;
+    }
+
+    // Commands for the C/C++ sources of a project without a Makefile, with
+    // include/, dependencies/ and the project root on the include path.
+    inline std::vector<Command> FromSources(const DevCore::Project &proj, const fs::path &projectDir)
+    {
+        std::vector<std::string> includes{"-I."};
+        std::error_code ec;
+        for (const char *dir : {"include", "dependencies"})
+        {
+            if (fs::is_directory(projectDir / dir, ec))
+                includes.push_back(std::string("-I") + dir);
+        }
+
+        std::vector<Command> commands;
+        for (const auto &path : DevCore::Files(proj))
+        {
+            if (!CompileCache::IsSource(path))
+                continue;
+            bool isC = fs::path(path).extension() == ".c";
+            Command command;
+            command.directory = projectDir.string();
+            command.file = path;
+            command.output = fs::path(path).replace_extension(".o").string();
+            command.arguments = {isC ? "cc" : "c++", isC ? "-std=c11" : "-std=c++17"};
+            command.arguments.insert(command.arguments.end(), includes.begin(), includes.end());
+            command.arguments.insert(command.arguments.end(), {"-c", path, "-o", command.output});
+            commands.push_back(command);
+        }
+        return commands;
+    }
+
+    // A JSON string literal, escaped like nlohmann::json::dump does.
+    inline std::string Quote(const std::string &text)
+    {
+        std::string quoted = "\"";
+        for (char c : text)
+        {
+            switch (c)
+            {
+            case '"': quoted += "\\\""; break;
+            case '\\': quoted += "\\\\"; break;
+            case '\b': quoted += "\\b"; break;
+            case '\f': quoted += "\\f"; break;
+            case '\n': quoted += "\\n"; break;
+            case '\r': quoted += "\\r"; break;
+            case '\t': quoted += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    char code[8];
+                    std::snprintf(code, sizeof(code), "\\u%04x", static_cast<unsigned char>(c));
+                    quoted += code;
+                }
+                else
+                    quoted += c;
+            }
+        }
+        return quoted + "\"";
+    }
+
+    // The database as JSON, laid out like nlohmann::json::dump(2) (keys in
+    // order, two space indent) so files written before stay byte-identical.
+    inline std::string ToJson(const std::vector<Command> &commands)
+    {
+        if (commands.empty())
+            return "[]\n";
+        std::string text = "[\n";
+        for (size_t i = 0; i < commands.size(); i++)
+        {
+            const Command &command = commands[i];
+            text += "  {\n    \"arguments\": ";
+            if (command.arguments.empty())
+                text += "[]";
+            else
+            {
+                text += "[\n";
+                for (size_t a = 0; a < command.arguments.size(); a++)
+                    text += "      " + Quote(command.arguments[a]) + (a + 1 < command.arguments.size() ? ",\n" : "\n");
+                text += "    ]";
+            }
+            text += ",\n    \"directory\": " + Quote(command.directory);
+            text += ",\n    \"file\": " + Quote(command.file);
+            if (!command.output.empty())
+                text += ",\n    \"output\": " + Quote(command.output);
+            text += i + 1 < commands.size() ? "\n  },\n" : "\n  }\n";
+        }
+        return text + "]\n";
+    }
+
+    // Write a database, but leave the file alone when nothing changed so
+    // the project does not look modified (see `devcore build`).
+    inline bool Write(const fs::path &path, const std::string &text)
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (in && std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()) == text)
+            return true;
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << text;
+        return static_cast<bool>(out);
+    }
+
+    inline void Run(const std::vector<std::string> &names)
+    {
+        std::vector<DevCore::Project> projects = DevCore::Projects();
+        for (const auto &name : names)
+        {
+            DevCore::Project proj;
+            if (!DevCore::FindProject(name, proj))
+                Canvas::PrintWarning("Project '" + name + "' does not exist.");
+        }
+
+        struct Result
+        {
+            std::string source; // How the commands were found.
+            std::vector<Command> commands;
+        };
+        std::vector<Result> results(projects.size());
+        Parallel::ForEach(projects.size(), [&](size_t p) {
+            const DevCore::Project &proj = projects[p];
+            if (!names.empty() && std::find(names.begin(), names.end(), proj.name) == names.end())
+                return;
+            fs::path projectDir = proj.path;
+            if (Build::HasMakefile(projectDir))
+            {
+                results[p] = {"make -n", FromDryRun(projectDir)};
+                if (!results[p].commands.empty())
+                    return;
+            }
+            results[p] = {"sources", FromSources(proj, projectDir)};
+        });
+
+        std::vector<Command> merged;
+        std::vector<std::vector<std::string>> rows;
+        for (size_t p = 0; p < results.size(); p++)
+        {
+            const Result &result = results[p];
+            if (result.commands.empty())
+                continue;
+            const DevCore::Project &proj = projects[p];
+            fs::path projectDir = proj.path;
+            bool written = Write(projectDir / FILE_NAME, ToJson(result.commands));
+            rows.push_back({proj.name, result.source, std::to_string(result.commands.size()), written ? "Written" : "Failed"});
+            merged.insert(merged.end(), result.commands.begin(), result.commands.end());
+        }
+        if (rows.empty())
+        {
+            Canvas::PrintInfo("No C/C++ projects found.");
+            return;
+        }
+        Canvas::PrintTable(" Compilation databases ", {"Project", "Source", "Entries", "Status"}, rows, Canvas::Color::CYAN);
+
+        // The merged database covers every project, so it is only rewritten
+        // when no names were given; it refers to files by absolute path.
+        if (!names.empty())
+            return;
+        for (auto &command : merged)
+            command.file = (fs::path(command.directory) / command.file).lexically_normal().string();
+        fs::path mergedPath = fs::path(DevCore::ProjectsPath()) / FILE_NAME;
+        if (Write(mergedPath, ToJson(merged)))
+            Canvas::PrintSuccess("Wrote " + std::to_string(merged.size()) + " entries to " + Canvas::LinkText(mergedPath.string(), Canvas::Color::GREEN));
+        else
+            Canvas::PrintError("Unable to write " + mergedPath.string());
+    }
+} // namespace CompDb
+
+#endif // COMPDB_HPP
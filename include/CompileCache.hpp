@@ -0,0 +1,408 @@
+#ifndef COMPILE_CACHE_HPP
+#define COMPILE_CACHE_HPP
+
+#include "../dependencies/Canvas.hpp"
+#include "../dependencies/Config.hpp"
+#include "Binary.hpp"
+#include "Strings.hpp"
+#include "Hash.hpp"
+#include "Main.hpp"
+#include "Process.hpp"
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <cinttypes>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+namespace fs = std::filesystem;
+
+// `devcore cc <compiler> <args...>`: a compiler wrapper with a shared,
+// content-addressed object cache in ~/.cache/devcore/objects. The key of a
+// compilation hashes the preprocessed source, the compiler binary (path, size
+// and mtime) and the flags that affect code generation with XXH64 under two
+// seeds; the two digests name the object. That is a wide key against
+// accidental collisions, not a 128 bit hash. Include paths and macro
+// definitions are already reflected in the preprocessed source and are left
+// out, and so are its linemarkers (see KeySource), so the same vendored file
+// compiled in two projects is only compiled once. Everything that is not a
+// plain single-source `-c` compilation is passed straight to the compiler.
+namespace CompileCache
+{
+    const char *const KEY_VERSION = "devcore-cc-2";
+    const uint64_t DEFAULT_LIMIT_MIB = 5120;
+    const uint64_t MAX_LIMIT_MIB = uint64_t(1) << 30; // 1 PiB, far below where << 20 overflows.
+
+    inline fs::path CachePath()
+    {
+        return fs::path(Main::HOME_PATH + Main::CACHE_PATH) / "objects";
+    }
+
+    // A parsed compiler command line.
+    struct Invocation
+    {
+        bool cacheable = true;
+        bool compileOnly = false;    // -c
+        bool debug = false;          // -g (the object then embeds the working directory)
+        bool dependencies = false;   // -MD or -MMD
+        bool hasDepFile = false;     // -MF
+        bool hasDepTarget = false;   // -MT or -MQ
+        std::string source;
+        std::string output;
+        std::vector<std::string> keyArgs; // Flags that are part of the key.
+    };
+
+    inline bool IsSource(const std::string &arg)
+    {
+        std::string ext = fs::path(arg).extension().string();
+        for (const char *known : {".c", ".cc", ".cpp", ".cxx", ".c++", ".C", ".cp", ".CPP"})
+        {
+            if (ext == known)
+                return true;
+        }
+        return false;
+    }
+
+    inline bool StartsWith(const std::string &text, const char *prefix)
+    {
+        return text.rfind(prefix, 0) == 0;
+    }
+
+    inline Invocation Parse(const std::vector<std::string> &args)
+    {
+        // Preprocessor options followed by a value, either attached or separate.
+        static const char *const preprocessorWithValue[] = {"-I", "-D", "-U", "-include", "-imacros", "-isystem", "-iquote", "-idirafter", "-iprefix", "-MF", "-MT", "-MQ"};
+        Invocation inv;
+        size_t sources = 0;
+        for (size_t i = 0; i < args.size(); i++)
+        {
+            const std::string &arg = args[i];
+            if (arg == "-c")
+                inv.compileOnly = true;
+            else if (arg == "-o" && i + 1 < args.size())
+                inv.output = args[++i];
+            else if (StartsWith(arg, "-o") && arg.size() > 2)
+                inv.output = arg.substr(2);
+            else if (arg == "-E" || arg == "-S" || arg == "-M" || arg == "-MM" || arg == "-" || StartsWith(arg, "@") ||
+                     StartsWith(arg, "-fprofile-") || StartsWith(arg, "-fauto-profile") || arg == "--coverage" ||
+                     arg == "-ftest-coverage" || StartsWith(arg, "-save-temps") || StartsWith(arg, "-Wp,") ||
+                     StartsWith(arg, "-X") || arg == "-x")
+                inv.cacheable = false;
+            else if (arg == "-MD" || arg == "-MMD")
+                inv.dependencies = true;
+            else if (arg == "-MP")
+                continue;
+            else if (arg[0] == '-')
+            {
+                bool preprocessor = false;
+                for (const char *option : preprocessorWithValue)
+                {
+                    if (StartsWith(arg, option))
+                    {
+                        preprocessor = true;
+                        inv.hasDepFile = inv.hasDepFile || StartsWith(arg, "-MF");
+                        inv.hasDepTarget = inv.hasDepTarget || StartsWith(arg, "-MT") || StartsWith(arg, "-MQ");
+                        if (arg == option && i + 1 < args.size())
+                            i++;
+                        break;
+                    }
+                }
+                if (preprocessor)
+                    continue;
+                if (StartsWith(arg, "-g") && arg != "-g0")
+                    inv.debug = true;
+                inv.keyArgs.push_back(arg);
+            }
+            else if (IsSource(arg))
+            {
+                inv.source = arg;
+                sources++;
+            }
+            else
+                inv.cacheable = false; // Object files or libraries: a link step.
+        }
+        if (!inv.compileOnly || sources != 1)
+            inv.cacheable = false;
+        if (inv.output.empty() && !inv.source.empty())
+            inv.output = fs::path(inv.source).stem().string() + ".o";
+        if (inv.output == "-")
+            inv.cacheable = false;
+        return inv;
+    }
+
+    // Locate a compiler in PATH like execvp would.
+    inline std::string Resolve(const std::string &compiler)
+    {
+        if (compiler.find('/') != std::string::npos)
+            return compiler;
+        const char *path = std::getenv("PATH");
+        std::stringstream dirs(path ? path : "/usr/bin:/bin");
+        std::string dir;
+        while (std::getline(dirs, dir, ':'))
+        {
+            std::string candidate = (dir.empty() ? "." : dir) + "/" + compiler;
+            if (access(candidate.c_str(), X_OK) == 0)
+                return candidate;
+        }
+        return compiler;
+    }
+
+    // Counters kept in objects/stats ("size hits misses uncacheable"),
+    // updated under an exclusive lock.
+    struct Stats
+    {
+        uint64_t size = 0;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t uncacheable = 0;
+    };
+
+    // Apply fn to the counters while holding the lock; returns the new counters.
+    template <typename Fn>
+    inline Stats UpdateStats(Fn &&fn)
+    {
+        std::error_code ec;
+        fs::create_directories(CachePath(), ec);
+        Stats stats;
+        int fd = open((CachePath() / "stats").c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0)
+            return stats;
+        flock(fd, LOCK_EX);
+        char buffer[128] = {};
+        ssize_t got = pread(fd, buffer, sizeof(buffer) - 1, 0);
+        if (got > 0)
+            std::sscanf(buffer, "%" SCNu64 " %" SCNu64 " %" SCNu64 " %" SCNu64, &stats.size, &stats.hits, &stats.misses, &stats.uncacheable);
+        fn(stats);
+        std::string text = std::to_string(stats.size) + " " + std::to_string(stats.hits) + " " +
+                           std::to_string(stats.misses) + " " + std::to_string(stats.uncacheable) + "\n";
+        if (ftruncate(fd, 0) == 0 && pwrite(fd, text.data(), text.size(), 0) < 0)
+            std::perror("devcore cc");
+        close(fd); // Releases the lock.
+        return stats;
+    }
+
+    // The build_cache_size limit in bytes. Invalid values fall back to the
+    // default; only `devcore cc --stats` warns about them, since the compile
+    // path must not add noise to every compilation.
+    inline uint64_t LimitBytes(bool warn = false)
+    {
+        uint64_t mib = 0;
+        if (Strings::ParseCount(Config::getOr("build_cache_size", std::to_string(DEFAULT_LIMIT_MIB)), mib, MAX_LIMIT_MIB) && mib > 0)
+            return mib << 20;
+        if (warn)
+            Canvas::PrintWarning("build_cache_size must be between 1 and " + std::to_string(MAX_LIMIT_MIB) + " MiB, using " + std::to_string(DEFAULT_LIMIT_MIB) + ".");
+        return DEFAULT_LIMIT_MIB << 20;
+    }
+
+    // Remove the least recently used entries until the cache is at 80% of
+    // its limit. Hits refresh the mtime of an entry, so mtime order is LRU.
+    inline void Evict(uint64_t limit)
+    {
+        UpdateStats([&](Stats &stats) {
+            struct Item
+            {
+                time_t mtime;
+                uint64_t size;
+                fs::path path;
+            };
+            std::vector<Item> items;
+            uint64_t total = 0;
+            std::error_code ec;
+            for (auto it = fs::recursive_directory_iterator(CachePath(), ec); it != fs::recursive_directory_iterator(); it.increment(ec))
+            {
+                struct stat st;
+                if (!it->is_regular_file(ec) || it->path().filename() == "stats" || stat(it->path().c_str(), &st) != 0)
+                    continue;
+                items.push_back({st.st_mtime, static_cast<uint64_t>(st.st_size), it->path()});
+                total += static_cast<uint64_t>(st.st_size);
+            }
+            std::sort(items.begin(), items.end(), [](const Item &a, const Item &b) { return a.mtime < b.mtime; });
+            for (const auto &item : items)
+            {
+                if (total <= limit / 10 * 8)
+                    break;
+                if (fs::remove(item.path, ec))
+                    total -= item.size;
+            }
+            stats.size = total;
+        });
+    }
+
+    // Copy a file through a temporary name so readers never see it half written.
+    inline bool CopyAtomic(const fs::path &from, const fs::path &to)
+    {
+        std::string content;
+        return Binary::ReadInto(from.string(), content) && Binary::WriteAtomic(to.string(), content);
+    }
+
+    // The preprocessed source as it goes into the key. Linemarkers
+    // (`# 12 "/home/me/app/include/x.hpp" 2`) carry the absolute paths of the
+    // source and its headers, which differ between project folders, so they
+    // are dropped. They are kept when the object can depend on them: debug
+    // info records them, and __builtin_FILE/__builtin_LINE (behind
+    // std::source_location) expand to them. Diagnostics replayed on a hit then
+    // name the paths of the compilation that filled the cache.
+    inline std::string KeySource(const std::string &preprocessed, bool debug)
+    {
+        if (debug || preprocessed.find("__builtin_FILE") != std::string::npos ||
+            preprocessed.find("__builtin_LINE") != std::string::npos)
+            return preprocessed;
+        std::string source;
+        source.reserve(preprocessed.size());
+        size_t pos = 0;
+        while (pos < preprocessed.size())
+        {
+            size_t end = preprocessed.find('\n', pos);
+            end = end == std::string::npos ? preprocessed.size() : end + 1;
+            bool marker = preprocessed.compare(pos, 2, "# ") == 0 && pos + 2 < preprocessed.size() &&
+                          std::isdigit(static_cast<unsigned char>(preprocessed[pos + 2]));
+            if (!marker && preprocessed.compare(pos, 5, "#line") != 0)
+                source.append(preprocessed, pos, end - pos);
+            pos = end;
+        }
+        return source;
+    }
+
+    // Replace the wrapper with the compiler itself.
+    inline int Exec(const std::vector<std::string> &argv)
+    {
+        std::vector<char *> args;
+        for (const auto &arg : argv)
+            args.push_back(const_cast<char *>(arg.c_str()));
+        args.push_back(nullptr);
+        execvp(args[0], args.data());
+        std::perror(("devcore cc: " + argv[0]).c_str());
+        return 127;
+    }
+
+    // Compile through the cache. argv is the compiler followed by its arguments.
+    inline int Compile(const std::vector<std::string> &argv)
+    {
+        std::vector<std::string> args(argv.begin() + 1, argv.end());
+        Invocation inv = Parse(args);
+        if (!inv.cacheable)
+        {
+            UpdateStats([](Stats &stats) { stats.uncacheable++; });
+            return Exec(argv);
+        }
+
+        // Preprocess. A requested dependency file is written by this step,
+        // with the object as its target, so hits do not need to store it.
+        std::vector<std::string> preprocess{argv[0]};
+        for (size_t i = 0; i < args.size(); i++)
+        {
+            if (args[i] == "-c")
+                continue;
+            if (args[i] == "-o")
+            {
+                i++;
+                continue;
+            }
+            if (StartsWith(args[i], "-o"))
+                continue;
+            preprocess.push_back(args[i]);
+        }
+        preprocess.push_back("-E");
+        if (inv.dependencies && !inv.hasDepFile)
+            preprocess.insert(preprocess.end(), {"-MF", fs::path(inv.output).replace_extension(".d").string()});
+        if (inv.dependencies && !inv.hasDepTarget)
+            preprocess.insert(preprocess.end(), {"-MT", inv.output});
+        std::string preprocessed, ignored;
+        if (Process::Capture(preprocess, &preprocessed, &ignored) != 0)
+            return Exec(argv); // Let the compiler report the error.
+
+        std::string compiler = Resolve(argv[0]);
+        struct stat st;
+        std::string identity = compiler;
+        if (stat(compiler.c_str(), &st) == 0)
+            identity += "\n" + std::to_string(st.st_size) + "\n" + std::to_string(st.st_mtime);
+        Hash::XXH64 low(0), high(1);
+        auto feed = [&](const std::string &data) {
+            low.Update(data.data(), data.size() + 1); // Include the terminator as separator.
+            high.Update(data.data(), data.size() + 1);
+        };
+        feed(KEY_VERSION);
+        feed(identity);
+        for (const auto &arg : inv.keyArgs)
+            feed(arg);
+        if (inv.debug)
+            feed(fs::current_path().string());
+        feed(KeySource(preprocessed, inv.debug));
+        char key[33];
+        std::snprintf(key, sizeof(key), "%016" PRIx64 "%016" PRIx64, high.Digest(), low.Digest());
+
+        fs::path object = CachePath() / std::string(key, 2) / (std::string(key + 2) + ".o");
+        fs::path diagnostics = object;
+        diagnostics.replace_extension(".stderr");
+        std::error_code ec;
+        if (fs::is_regular_file(object, ec) && CopyAtomic(object, inv.output))
+        {
+            utimensat(AT_FDCWD, object.c_str(), nullptr, 0); // Mark as recently used.
+            std::string cached;
+            if (Binary::ReadInto(diagnostics.string(), cached))
+                std::cerr << cached;
+            UpdateStats([](Stats &stats) { stats.hits++; });
+            return 0;
+        }
+
+        std::string errors;
+        int code = Process::Capture(argv, nullptr, &errors);
+        std::cerr << errors;
+        if (code != 0)
+            return code;
+
+        fs::create_directories(object.parent_path(), ec);
+        uint64_t added = 0;
+        if (CopyAtomic(inv.output, object))
+        {
+            added += fs::file_size(object, ec);
+            if (!errors.empty())
+            {
+                Binary::WriteAtomic(diagnostics.string(), errors);
+                added += errors.size();
+            }
+        }
+        uint64_t limit = LimitBytes();
+        Stats stats = UpdateStats([&](Stats &s) {
+            s.misses++;
+            s.size += added;
+        });
+        if (stats.size > limit)
+            Evict(limit);
+        return 0;
+    }
+
+    // Print the counters of the cache.
+    inline void PrintStats()
+    {
+        Stats stats = UpdateStats([](Stats &) {});
+        uint64_t lookups = stats.hits + stats.misses;
+        std::ostringstream rate;
+        rate.precision(1);
+        rate << std::fixed << (lookups ? 100.0 * stats.hits / lookups : 0.0) << "%";
+        Canvas::PrintTable(" Compilation cache ", {"Size", "Limit", "Hits", "Misses", "Hit rate", "Uncacheable"},
+                           {{Strings::FormatSize(stats.size), Strings::FormatSize(LimitBytes(true)), std::to_string(stats.hits),
+                             std::to_string(stats.misses), rate.str(), std::to_string(stats.uncacheable)}},
+                           Canvas::Color::CYAN);
+    }
+
+    inline void Clear()
+    {
+        std::error_code ec;
+        fs::remove_all(CachePath(), ec);
+        if (ec)
+            Canvas::PrintError("Unable to clear " + CachePath().string() + ": " + ec.message());
+        else
+            Canvas::PrintSuccess("Cleared the compilation cache.");
+    }
+} // namespace CompileCache
+
+#endif // COMPILE_CACHE_HPP
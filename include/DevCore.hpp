@@ -0,0 +1,160 @@
+#ifndef DEVCORE_HPP
+#define DEVCORE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+// libdevcore: the project store without the command line around it. This
+// header only depends on the standard library; the implementation
+// (source/DevCore.cpp and source/DevMap.cpp, built into libdevcore.a by
+// run.sh) holds the DevMap, scanning, persistence and templates. Nothing
+// here prints, prompts or exits: what the core notices is passed to the
+// callbacks and failures return false with a message in LastError().
+// The devcore CLI is a client of this API like any other.
+//
+// There is one store per process. Calls are not thread-safe among
+// themselves, although progress callbacks may come from scanning threads
+// (one at a time). The callbacks given to Open and Sync stay installed for
+// the calls that follow.
+//
+// Projects are returned as copies. Functions taking a Project find it in
+// the store by language and folder. The Record functions, SetDependencies,
+// Rescan and CountLines change the store in memory; Save() writes the
+// DevMap. Functions that change folders on disk write it themselves.
+namespace DevCore
+{
+    // Sizes and counts describe the whole folder: ignored files and
+    // directories (.git, build outputs, .gitignore/.devcoreignore patterns)
+    // are included, as they take disk space. lastActivity, largestFiles and
+    // Files() leave them out, since they describe the project's own files.
+    struct Project
+    {
+        std::string name;         // Name in the DevMap.
+        std::string folderName;   // Folder inside the language directory.
+        std::string lang;         // Language (the directory the folder is in).
+        std::string path;         // Absolute path of the project folder.
+        std::string createdBy;
+        time_t createdAt = 0;
+        uint64_t size = 0;          // Bytes in all files.
+        uint64_t allocatedSize = 0; // Bytes allocated on disk.
+        uint64_t fileCount = 0;     // Regular files.
+        uint64_t dirCount = 0;      // Directories.
+        uint64_t lines = 0;         // Lines of code, counted by the last scan.
+        time_t lastActivity = 0;    // Newest modification of a file that is not ignored.
+        bool usesGit = false;
+        std::string gitBranch;
+        time_t lastCommit = 0;
+        bool gitDirty = false;
+        time_t lastBuild = 0;       // End of the last successful `devcore build`.
+        std::vector<std::string> dependencies;
+        uint64_t gitReclaimed = 0;  // Bytes reclaimed by the last git maintenance.
+        time_t gitMaintainedAt = 0; // Time of the last git maintenance (0 if never).
+        std::vector<std::pair<uint64_t, std::string>> largestFiles; // (size, path) of files that are not ignored, biggest first.
+        std::vector<std::pair<uint64_t, std::string>> largestDirs;  // (recursive size, path).
+        std::vector<std::pair<uint64_t, std::string>> buildDirs;    // Build outputs (allocated bytes, path).
+    };
+
+    // Lines of one language, as counted by CountLines.
+    struct LineCounts
+    {
+        uint64_t files = 0;
+        uint64_t code = 0;
+        uint64_t comment = 0;
+        uint64_t blank = 0;
+    };
+
+    // A file found in the filename index.
+    struct FileMatch
+    {
+        std::string project; // Name of the project.
+        std::string folder;  // Language and folder of the project ("C++/app").
+        std::string path;    // Relative to the project folder.
+    };
+
+    struct Callbacks
+    {
+        std::function<void(const std::string &)> info;           // Changes noticed, e.g. a project that was moved.
+        std::function<void(const std::string &)> error;          // Failures, also kept in LastError().
+        std::function<void(size_t done, size_t total)> progress; // Projects scanned during a sync.
+    };
+
+    // Load the config and the DevMap and synchronize it with the projects
+    // folder (scanning every project). Empty paths mean the files of the
+    // current user (~/.config/devcore/devcore.conf and devmap.json).
+    bool Open(const std::string &configFile = "", const std::string &devmapFile = "", const Callbacks &callbacks = Callbacks());
+    bool IsOpen();
+
+    // Rescan every project and write the DevMap.
+    bool Sync(const Callbacks &callbacks = Callbacks());
+
+    // Write the DevMap file.
+    bool Save();
+
+    // Write an empty DevMap (no projects, languages or users) to devmapFile
+    // (empty for the file of the current user). Open it afterwards.
+    bool CreateDevMap(const std::string &devmapFile = "");
+
+    // The DevMap as it is stored (pretty printed JSON).
+    std::string DevMapText();
+
+    // Message of the last failure.
+    const std::string &LastError();
+
+    std::string ProjectsPath();
+    std::vector<Project> Projects();
+    std::vector<Project> ProjectsByLanguage(const std::string &lang);
+    std::vector<Project> ProjectsByUser(const std::string &user);
+    bool FindProject(const std::string &name, Project &project);
+    std::vector<std::string> Languages();
+    std::vector<std::string> Users();
+    std::vector<std::string> Templates(const std::string &lang);
+    std::vector<std::string> Templates(); // Every template as "lang/name".
+
+    // Create a project folder (from a template when templateName is set,
+    // with a git repository when initGit is set) and add it to the DevMap.
+    // An empty folderName uses the name.
+    bool CreateProject(const std::string &name, const std::string &lang, const std::string &folderName = "",
+                       const std::string &templateName = "", bool initGit = false);
+    // Delete the folder of a project and its DevMap entry.
+    bool DeleteProject(const Project &project);
+
+    // Create the projects and templates folders of a language. Creating a
+    // language that exists succeeds and changes nothing.
+    bool CreateLanguage(const std::string &lang);
+    // Delete a language. Its projects and templates folders must be empty.
+    bool DeleteLanguage(const std::string &lang);
+
+    // Copy the folder source into a new template of a language.
+    bool AddTemplate(const std::string &lang, const std::string &name, const std::string &source);
+    bool RemoveTemplate(const std::string &lang, const std::string &name);
+
+    // Replace the dependencies of a project. Unknown names and changes that
+    // would create a cycle are refused.
+    bool SetDependencies(const Project &project, const std::vector<std::string> &dependencies);
+    // Note a successful build that ended at finished.
+    bool RecordBuild(const Project &project, time_t finished);
+    // Note a git maintenance run that reclaimed some bytes.
+    bool RecordMaintenance(const Project &project, uint64_t reclaimed, time_t when);
+    // Scan projects again (in parallel), e.g. after their files changed,
+    // and update both the store and the given records.
+    bool Rescan(std::vector<Project> &projects);
+    // Recount lines of code (only files changed since the last count are
+    // read) and store the total of every project. With byLanguage, the
+    // counts per language of every project, in the order of Projects().
+    bool CountLines(std::vector<std::map<std::string, LineCounts>> *byLanguage = nullptr);
+
+    // Paths of the files of a project, from the index the last scan wrote
+    // (ignored files are left out).
+    std::vector<std::string> Files(const Project &project);
+    // The indexed files whose name or path matches a glob, by project.
+    std::vector<FileMatch> FindFiles(const std::string &glob);
+    size_t IndexedFileCount();
+} // namespace DevCore
+
+#endif // DEVCORE_HPP
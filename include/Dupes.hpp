@@ -0,0 +1,280 @@
+#ifndef DUPES_HPP
+#define DUPES_HPP
+
+#include "../dependencies/Canvas.hpp"
+#include "DevCore.hpp"
+#include "Hash.hpp"
+#include "Parallel.hpp"
+#include "Scan.hpp"
+#include "Strings.hpp"
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <algorithm>
+#include <chrono>
+#include <tuple>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/fs.h>
+
+// `devcore dupes`: identical files across all projects, including vendored
+// and ignored directories (only VCS metadata is skipped). Candidates are
+// narrowed in stages so most files are never read in full:
+//   1. equal size (from the scan, no reads),
+//   2. equal hash of the first and last block (two small preads),
+//   3. equal hash of the whole content (large sequential reads, in parallel).
+// With --dedupe the copies are turned into reflinks of the first file with
+// FIDEDUPERANGE; the kernel compares the bytes itself before sharing them.
+namespace Dupes
+{
+    const size_t EDGE_BLOCK = 4096;         // Bytes hashed at each end in stage 2.
+    const size_t READ_BLOCK = 1 << 20;      // Read size for full hashes.
+    const uint64_t DEDUPE_CHUNK = 16 << 20; // Bytes per FIDEDUPERANGE call (filesystems cap it).
+    const size_t MAX_ROWS = 20;             // Groups shown in the table.
+
+    struct File
+    {
+        size_t project;
+        std::string relative;
+        std::string path;
+        uint64_t size;
+        dev_t device;
+        ino_t inode;
+        uint64_t hash = 0;
+    };
+
+    // Collects the regular files of one project outside VCS metadata.
+    struct FileVisitor : Scan::Visitor
+    {
+        size_t project;
+        uint64_t minSize;
+        std::vector<File> files;
+
+        FileVisitor(size_t project, uint64_t minSize) : project(project), minSize(minSize) {}
+
+        void OnFile(const Scan::Entry &entry) override
+        {
+            if (static_cast<uint64_t>(entry.st.st_size) < minSize)
+                return;
+            for (const char *vcs : {".git", ".hg", ".svn"})
+            {
+                std::string dir = std::string(vcs) + "/";
+                if (entry.relative.compare(0, dir.size(), dir) == 0 || entry.relative.find("/" + dir) != std::string::npos)
+                    return;
+            }
+            files.push_back({project, entry.relative, entry.path, static_cast<uint64_t>(entry.st.st_size), entry.st.st_dev, entry.st.st_ino});
+        }
+    };
+
+    // Hash of the first and last EDGE_BLOCK bytes. For files up to two blocks
+    // this covers the whole content.
+    inline bool HashEdges(File &file)
+    {
+        int fd = open(file.path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            return false;
+        char buffer[2 * EDGE_BLOCK];
+        size_t head = std::min<uint64_t>(file.size, EDGE_BLOCK);
+        size_t tail = file.size > 2 * EDGE_BLOCK ? EDGE_BLOCK : file.size - head;
+        bool ok = pread(fd, buffer, head, 0) == static_cast<ssize_t>(head) &&
+                  pread(fd, buffer + head, tail, file.size - tail) == static_cast<ssize_t>(tail);
+        close(fd);
+        file.hash = Hash::Of(buffer, head + tail, file.size);
+        return ok;
+    }
+
+    inline bool HashContent(File &file)
+    {
+        int fd = open(file.path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            return false;
+        posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        thread_local std::vector<char> buffer(READ_BLOCK);
+        Hash::XXH64 state(file.size);
+        ssize_t got;
+        while ((got = read(fd, buffer.data(), buffer.size())) > 0)
+            state.Update(buffer.data(), static_cast<size_t>(got));
+        close(fd);
+        file.hash = state.Digest();
+        return got == 0;
+    }
+
+    // Split groups further by the hash computed by hashFn (run in parallel).
+    // Files that cannot be read are dropped; groups of one are discarded.
+    template <typename HashFn>
+    inline std::vector<std::vector<File>> Refine(std::vector<std::vector<File>> groups, HashFn &&hashFn)
+    {
+        std::vector<File *> work;
+        for (auto &group : groups)
+            for (auto &file : group)
+                work.push_back(&file);
+        std::vector<char> ok(work.size());
+        Parallel::ForEach(work.size(), [&](size_t i) { ok[i] = hashFn(*work[i]); });
+
+        std::vector<std::vector<File>> refined;
+        size_t index = 0;
+        for (auto &group : groups)
+        {
+            std::unordered_map<uint64_t, std::vector<File>> byHash;
+            for (auto &file : group)
+            {
+                if (ok[index++])
+                    byHash[file.hash].push_back(std::move(file));
+            }
+            for (auto &entry : byHash)
+            {
+                if (entry.second.size() > 1)
+                    refined.push_back(std::move(entry.second));
+            }
+        }
+        return refined;
+    }
+
+    // Share the extents of every copy with the first file of its group.
+    // Returns the number of bytes the kernel reported as deduplicated.
+    inline uint64_t Dedupe(const std::vector<File> &group, std::string &error)
+    {
+        int source = open(group[0].path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (source < 0)
+            return 0;
+        uint64_t deduped = 0;
+        std::vector<char> storage(sizeof(file_dedupe_range) + sizeof(file_dedupe_range_info));
+        auto *range = reinterpret_cast<file_dedupe_range *>(storage.data());
+        for (size_t i = 1; i < group.size() && error.empty(); i++)
+        {
+            if (group[i].device != group[0].device)
+                continue; // Extents cannot be shared across filesystems.
+            int target = open(group[i].path.c_str(), O_RDWR | O_CLOEXEC);
+            if (target < 0)
+                target = open(group[i].path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (target < 0)
+                continue;
+            for (uint64_t offset = 0; offset < group[0].size; offset += DEDUPE_CHUNK)
+            {
+                std::fill(storage.begin(), storage.end(), 0);
+                range->src_offset = offset;
+                range->src_length = std::min<uint64_t>(DEDUPE_CHUNK, group[0].size - offset);
+                range->dest_count = 1;
+                range->info[0].dest_fd = target;
+                range->info[0].dest_offset = offset;
+                if (ioctl(source, FIDEDUPERANGE, range) != 0)
+                {
+                    // Unsupported by the filesystem: give up. Anything else
+                    // (permissions, busy file) only skips this copy.
+                    if (errno == EOPNOTSUPP || errno == EINVAL || errno == ENOTTY)
+                        error = std::strerror(errno);
+                    break;
+                }
+                if (range->info[0].status != FILE_DEDUPE_RANGE_SAME)
+                    break;
+                deduped += range->info[0].bytes_deduped;
+            }
+            close(target);
+        }
+        close(source);
+        return deduped;
+    }
+
+    inline void Run(uint64_t minSize, bool dedupe)
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        // Stage 0: list the files of every project in parallel.
+        std::vector<DevCore::Project> projects = DevCore::Projects();
+        std::vector<std::vector<File>> perProject(projects.size());
+        Parallel::ForEach(projects.size(), [&](size_t p) {
+            FileVisitor visitor(p, std::max<uint64_t>(minSize, 1));
+            Scan::Walk(projects[p].path, Ignore::Rules(), {&visitor});
+            perProject[p] = std::move(visitor.files);
+        });
+
+        // Stage 1: group by size. Hard links of one inode are a single file.
+        std::unordered_map<uint64_t, std::vector<File>> bySize;
+        std::set<std::pair<dev_t, ino_t>> seen;
+        size_t scanned = 0;
+        for (auto &files : perProject)
+        {
+            for (auto &file : files)
+            {
+                scanned++;
+                if (seen.insert({file.device, file.inode}).second)
+                    bySize[file.size].push_back(std::move(file));
+            }
+        }
+        std::vector<std::vector<File>> groups;
+        for (auto &entry : bySize)
+        {
+            if (entry.second.size() > 1)
+                groups.push_back(std::move(entry.second));
+        }
+
+        // Stage 2 and 3: edges, then the full content of files larger than the edges.
+        groups = Refine(std::move(groups), HashEdges);
+        std::vector<std::vector<File>> small, large;
+        for (auto &group : groups)
+            (group[0].size <= 2 * EDGE_BLOCK ? small : large).push_back(std::move(group));
+        groups = Refine(std::move(large), HashContent);
+        for (auto &group : small)
+            groups.push_back(std::move(group));
+
+        std::sort(groups.begin(), groups.end(), [](const auto &a, const auto &b) {
+            return a[0].size * (a.size() - 1) > b[0].size * (b.size() - 1);
+        });
+
+        uint64_t wasted = 0;
+        size_t copies = 0;
+        std::vector<std::vector<std::string>> rows;
+        for (auto &group : groups)
+        {
+            std::sort(group.begin(), group.end(), [](const File &a, const File &b) {
+                return std::tie(a.project, a.relative) < std::tie(b.project, b.relative);
+            });
+            wasted += group[0].size * (group.size() - 1);
+            copies += group.size() - 1;
+            if (rows.size() >= MAX_ROWS)
+                continue;
+            std::set<std::string> projectNames;
+            for (const auto &file : group)
+                projectNames.insert(projects[file.project].name);
+            std::string names;
+            for (const auto &name : projectNames)
+                names += (names.empty() ? "" : ", ") + name;
+            rows.push_back({Strings::FormatSize(group[0].size), std::to_string(group.size()),
+                            Strings::FormatSize(group[0].size * (group.size() - 1)),
+                            group[0].relative, names});
+        }
+
+        if (groups.empty())
+        {
+            Canvas::PrintInfo("No duplicate files found in " + std::to_string(scanned) + " files.");
+            return;
+        }
+        Canvas::PrintTable(" Duplicates ", {"Size", "Copies", "Wasted", "File", "Projects"}, rows, Canvas::Color::CYAN);
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        Canvas::PrintInfo(std::to_string(groups.size()) + " groups, " + std::to_string(copies) + " redundant copies, " +
+                          Strings::FormatSize(wasted) + " reclaimable (" + std::to_string(scanned) + " files scanned in " +
+                          std::to_string(elapsed) + " ms).");
+
+        if (!dedupe)
+            return;
+        uint64_t deduped = 0;
+        std::string error;
+        for (const auto &group : groups)
+        {
+            deduped += Dedupe(group, error);
+            if (!error.empty())
+                break;
+        }
+        if (!error.empty())
+            Canvas::PrintError("Deduplication stopped: " + error + " (the filesystem may not support reflinks).");
+        if (error.empty() || deduped > 0)
+            Canvas::PrintSuccess("Shared " + Strings::FormatSize(deduped) + " of duplicate data.");
+    }
+} // namespace Dupes
+
+#endif // DUPES_HPP
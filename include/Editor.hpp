@@ -0,0 +1,69 @@
+#ifndef EDITOR_HPP
+#define EDITOR_HPP
+
+#include "../dependencies/Canvas.hpp"
+#include "../dependencies/Config.hpp"
+#include "Process.hpp"
+#include <string>
+#include <vector>
+#include <sstream>
+#include <cstring>
+#include <algorithm>
+
+// Opening a folder in the editor from the `editor` config key (default
+// `code`). The value may carry arguments ("code -n"). GUI editors are
+// spawned detached so devcore returns at once and the editor outlives the
+// terminal; editors that run inside the terminal are run in the foreground.
+namespace Editor
+{
+    const std::vector<std::string> TERMINAL_EDITORS{"vi", "vim", "nvim", "nano", "micro", "hx", "helix", "kak", "joe", "ne", "mg"};
+
+    inline std::vector<std::string> Command()
+    {
+        std::istringstream words(Config::getOr("editor", "code"));
+        std::vector<std::string> command;
+        std::string word;
+        while (words >> word)
+            command.push_back(word);
+        return command;
+    }
+
+    inline bool RunsInTerminal(const std::vector<std::string> &command)
+    {
+        std::string program = fs::path(command[0]).filename().string();
+        if (program == "emacs" || program == "emacsclient")
+        {
+            for (const auto &arg : command)
+            {
+                if (arg == "-nw" || arg == "-t" || arg == "--tty")
+                    return true;
+            }
+            return false;
+        }
+        return std::find(TERMINAL_EDITORS.begin(), TERMINAL_EDITORS.end(), program) != TERMINAL_EDITORS.end();
+    }
+
+    inline bool Open(const fs::path &path)
+    {
+        std::vector<std::string> command = Command();
+        command.push_back(path.string());
+        std::string reason;
+        bool opened;
+        if (RunsInTerminal(command))
+            opened = Process::Run(command) != -1;
+        else
+        {
+            Process::Options options;
+            options.detached = true;
+            Process::Result result = Process::Execute(command, options);
+            if (!(opened = result.exitCode == 0))
+                reason = std::string(": ") + std::strerror(result.error);
+        }
+        if (!opened)
+            Canvas::PrintError(u8"❌ Failed to open '" + path.string() + "' with '" + command[0] + "'" + reason +
+                               ". Make sure it is installed and on your PATH, or choose another editor with 'devcore config set editor <editor>'.");
+        return opened;
+    }
+} // namespace Editor
+
+#endif // EDITOR_HPP
@@ -0,0 +1,196 @@
+#ifndef FILECACHE_HPP
+#define FILECACHE_HPP
+
+#include "Main.hpp"
+#include "Binary.hpp"
+#include "Parallel.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <atomic>
+#include <filesystem>
+#include <sys/stat.h>
+namespace fs = std::filesystem;
+
+// Per-project caches of a result computed for every file, shared by
+// `devcore symbol` (Symbols) and the line counts (Stats). Every project has
+// its own file in ~/.cache/devcore/<directory>/<lang>/<folder>.idx, and a file
+// is read again only when its mtime or size changed.
+//
+// Layout (little endian): 4 byte magic, u32 version, u32 fileCount, then per
+// file: string path, i64 mtime (ns), u64 size and the payload of the format.
+//
+// A format supplies only the per-file part:
+//   using Entry             with std::string path, int64_t mtime, uint64_t size
+//   MAGIC, DIRECTORY        "DCSY", "symbols"
+//   VERSION                 bumped when the payload changes
+//   Put(out, entry)         append the payload
+//   Get(data, size, pos, entry)  read the payload, false when it is damaged
+//   Read(path, entry)       compute the payload of a changed file
+namespace FileCache
+{
+    // The files of one project to bring up to date. paths are relative to root.
+    struct Project
+    {
+        std::string key; // "lang/folder"
+        fs::path root;
+        std::vector<std::string> paths;
+    };
+
+    // Modification time in nanoseconds, so that a same-size edit within the
+    // same second is still seen as a change.
+    inline int64_t MTime(const struct stat &st)
+    {
+        return static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+    }
+
+    template <typename Format>
+    inline std::string IndexPath(const std::string &key)
+    {
+        return Main::HOME_PATH + Main::CACHE_PATH + "/" + Format::DIRECTORY + "/" + key + ".idx";
+    }
+
+    // The cached entries of a project, or none when the file is missing,
+    // from another version or damaged.
+    template <typename Format>
+    inline std::vector<typename Format::Entry> Load(const std::string &key)
+    {
+        std::vector<typename Format::Entry> files;
+        Binary::MappedFile index(IndexPath<Format>(key));
+        const char *data = index.data();
+        size_t size = index.size();
+        size_t pos = 4;
+        uint32_t version, fileCount;
+        if (size < 12 || std::memcmp(data, Format::MAGIC, 4) != 0 ||
+            !Binary::Get(data, size, pos, version) || version != Format::VERSION ||
+            !Binary::Get(data, size, pos, fileCount))
+            return files;
+
+        // Every record takes at least a byte for each of its fixed fields, so
+        // a damaged count cannot make us allocate more than the file holds.
+        if (fileCount > size - pos)
+            return files;
+        files.resize(fileCount);
+        for (auto &file : files)
+        {
+            if (!Binary::GetString(data, size, pos, file.path) || !Binary::Get(data, size, pos, file.mtime) ||
+                !Binary::Get(data, size, pos, file.size) || !Format::Get(data, size, pos, file))
+                return {};
+        }
+        return files;
+    }
+
+    template <typename Format>
+    inline bool Write(const std::string &key, const std::vector<typename Format::Entry> &files)
+    {
+        std::string out(Format::MAGIC, 4);
+        Binary::Put<uint32_t>(out, Format::VERSION);
+        Binary::Put<uint32_t>(out, static_cast<uint32_t>(files.size()));
+        for (const auto &file : files)
+        {
+            Binary::PutString(out, file.path);
+            Binary::Put<int64_t>(out, file.mtime);
+            Binary::Put<uint64_t>(out, file.size);
+            Format::Put(out, file);
+        }
+        std::error_code ec;
+        fs::create_directories(fs::path(IndexPath<Format>(key)).parent_path(), ec);
+        return Binary::WriteAtomic(IndexPath<Format>(key), out);
+    }
+
+    // Bring the cache of every project up to date. Files of all projects are
+    // stat'ed and read in parallel; a project's cache is rewritten only when
+    // one of its files changed, appeared or disappeared. Returns the entries
+    // per project (in the order of projects) and sets refreshed to the number
+    // of files that were read.
+    template <typename Format>
+    inline std::vector<std::vector<typename Format::Entry>> Update(const std::vector<Project> &projects, size_t &refreshed)
+    {
+        using Entry = typename Format::Entry;
+        struct Work
+        {
+            size_t project;
+            size_t slot;
+            const Entry *cached;
+        };
+
+        std::vector<std::vector<Entry>> cached(projects.size()), files(projects.size());
+        std::vector<Work> work;
+        for (size_t p = 0; p < projects.size(); p++)
+        {
+            cached[p] = Load<Format>(projects[p].key);
+            std::unordered_map<std::string_view, const Entry *> byPath;
+            for (const auto &entry : cached[p])
+                byPath[entry.path] = &entry;
+
+            files[p].resize(projects[p].paths.size());
+            for (size_t f = 0; f < projects[p].paths.size(); f++)
+            {
+                auto it = byPath.find(projects[p].paths[f]);
+                work.push_back({p, f, it == byPath.end() ? nullptr : it->second});
+                files[p][f].path = projects[p].paths[f];
+            }
+        }
+
+        std::vector<std::atomic<bool>> changed(projects.size()); // Set by any worker, so atomic.
+        std::atomic<size_t> read{0};
+        Parallel::ForEach(work.size(), [&](size_t w) {
+            const Work &item = work[w];
+            Entry &entry = files[item.project][item.slot];
+            std::string path = (projects[item.project].root / entry.path).string();
+            struct stat st;
+            if (stat(path.c_str(), &st) != 0)
+                return;
+            entry.mtime = MTime(st);
+            entry.size = static_cast<uint64_t>(st.st_size);
+            if (item.cached && item.cached->mtime == entry.mtime && item.cached->size == entry.size)
+            {
+                entry = *item.cached;
+                return;
+            }
+            changed[item.project].store(true, std::memory_order_relaxed);
+            read++;
+            Format::Read(path, entry);
+        });
+
+        for (size_t p = 0; p < projects.size(); p++)
+        {
+            if (changed[p] || files[p].size() != cached[p].size() || !fs::exists(IndexPath<Format>(projects[p].key)))
+                Write<Format>(projects[p].key, files[p]);
+        }
+        refreshed = read.load();
+        return files;
+    }
+
+    // Bring the cache of one project up to date from entries whose path,
+    // mtime and size a walk already found (Scan), so nothing is stat'ed
+    // again. Changed files are read on the calling thread.
+    template <typename Format>
+    inline std::vector<typename Format::Entry> UpdateProject(const Project &project, std::vector<typename Format::Entry> files, size_t &refreshed)
+    {
+        using Entry = typename Format::Entry;
+        std::vector<Entry> cached = Load<Format>(project.key);
+        std::unordered_map<std::string_view, const Entry *> byPath;
+        for (const auto &entry : cached)
+            byPath[entry.path] = &entry;
+
+        refreshed = 0;
+        for (auto &entry : files)
+        {
+            auto it = byPath.find(entry.path);
+            if (it != byPath.end() && it->second->mtime == entry.mtime && it->second->size == entry.size)
+            {
+                entry = *it->second;
+                continue;
+            }
+            refreshed++;
+            Format::Read((project.root / entry.path).string(), entry);
+        }
+        if (refreshed || files.size() != cached.size() || !fs::exists(IndexPath<Format>(project.key)))
+            Write<Format>(project.key, files);
+        return files;
+    }
+} // namespace FileCache
+
+#endif // FILECACHE_HPP
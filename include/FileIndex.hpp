@@ -0,0 +1,213 @@
+#ifndef FILEINDEX_HPP
+#define FILEINDEX_HPP
+
+#include "Main.hpp"
+#include "Binary.hpp"
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <mutex>
+#include <algorithm>
+#include <filesystem>
+#include <fnmatch.h>
+namespace fs = std::filesystem;
+
+// Locate-style index of every file path in every project. It is filled by the
+// size scan in DevMap::syncDevMap(), so keeping it current costs no extra
+// walk, and `devcore find` answers from it without touching the projects.
+//
+// Layout (little endian): "DCFI", u32 version, u32 projectCount, then per
+// project: string key ("C++/app"), u32 pathCount, string block. The block holds
+// the sorted paths front coded: varint shared prefix length, string suffix.
+namespace FileIndex
+{
+    const uint32_t INDEX_VERSION = 1;
+
+    // Encoded path lists per project key, loaded lazily.
+    inline std::map<std::string, std::pair<uint32_t, std::string>> blocks;
+    inline bool loaded = false;
+    inline bool dirty = false;
+    inline std::mutex mutex;
+
+    inline std::string IndexPath()
+    {
+        return Main::HOME_PATH + Main::CACHE_PATH + "/files.idx";
+    }
+
+    inline void Load()
+    {
+        if (loaded)
+            return;
+        loaded = true;
+        Binary::MappedFile index(IndexPath());
+        const char *data = index.data();
+        size_t size = index.size();
+        size_t pos = 4;
+        uint32_t version, projectCount;
+        if (size < 12 || std::memcmp(data, "DCFI", 4) != 0 ||
+            !Binary::Get(data, size, pos, version) || version != INDEX_VERSION ||
+            !Binary::Get(data, size, pos, projectCount))
+            return;
+
+        for (uint32_t i = 0; i < projectCount; i++)
+        {
+            std::string key, block;
+            uint32_t count;
+            if (!Binary::GetString(data, size, pos, key) || !Binary::Get(data, size, pos, count) ||
+                !Binary::GetString(data, size, pos, block))
+            {
+                blocks.clear();
+                return;
+            }
+            blocks[key] = {count, std::move(block)};
+        }
+    }
+
+    // Front code a list of paths (sorted in place).
+    inline std::string Encode(std::vector<std::string> &paths)
+    {
+        std::sort(paths.begin(), paths.end());
+        std::string block;
+        const std::string *previous = nullptr;
+        for (const auto &path : paths)
+        {
+            size_t shared = 0;
+            if (previous)
+            {
+                size_t limit = std::min(previous->size(), path.size());
+                while (shared < limit && (*previous)[shared] == path[shared])
+                    shared++;
+            }
+            Binary::PutVarint(block, shared);
+            Binary::PutVarint(block, path.size() - shared);
+            block.append(path, shared, std::string::npos);
+            previous = &path;
+        }
+        return block;
+    }
+
+    // Call fn(path) for every path of an encoded block.
+    template <typename Fn>
+    inline void Decode(const std::string &block, Fn &&fn)
+    {
+        std::string path;
+        size_t pos = 0;
+        uint64_t shared, length;
+        while (pos < block.size() &&
+               Binary::GetVarint(block.data(), block.size(), pos, shared) &&
+               Binary::GetVarint(block.data(), block.size(), pos, length) &&
+               pos + length <= block.size() && shared <= path.size())
+        {
+            path.resize(shared);
+            path.append(block, pos, length);
+            pos += length;
+            fn(path);
+        }
+    }
+
+    // Replace the file list of one project. Safe to call from scan threads.
+    inline void Update(const std::string &key, std::vector<std::string> paths)
+    {
+        std::string block = Encode(paths);
+        std::lock_guard<std::mutex> lock(mutex);
+        Load();
+        auto it = blocks.find(key);
+        if (it != blocks.end() && it->second.second == block)
+            return;
+        blocks[key] = {static_cast<uint32_t>(paths.size()), std::move(block)};
+        dirty = true;
+    }
+
+    // Drop projects that no longer exist.
+    inline void Prune(const std::set<std::string> &keys)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        Load();
+        for (auto it = blocks.begin(); it != blocks.end();)
+        {
+            if (keys.count(it->first) == 0)
+            {
+                it = blocks.erase(it);
+                dirty = true;
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    // Write the index if anything changed.
+    inline bool Save()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!dirty)
+            return true;
+        std::string out = "DCFI";
+        Binary::Put<uint32_t>(out, INDEX_VERSION);
+        Binary::Put<uint32_t>(out, static_cast<uint32_t>(blocks.size()));
+        for (const auto &entry : blocks)
+        {
+            Binary::PutString(out, entry.first);
+            Binary::Put<uint32_t>(out, entry.second.first);
+            Binary::PutString(out, entry.second.second);
+        }
+        std::error_code ec;
+        fs::create_directories(fs::path(IndexPath()).parent_path(), ec);
+        dirty = false;
+        return Binary::WriteAtomic(IndexPath(), out);
+    }
+
+    // Find paths matching a glob. A pattern without '/' is matched against the
+    // file name, otherwise against the path inside the project. A pattern
+    // without wildcards matches any file name containing it.
+    // Returns (project key, path) pairs.
+    inline std::vector<std::pair<std::string, std::string>> Find(const std::string &glob)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        Load();
+        std::string pattern = glob;
+        if (pattern.find_first_of("*?[") == std::string::npos)
+            pattern = "*" + pattern + "*";
+        bool matchPath = pattern.find('/') != std::string::npos;
+
+        std::vector<std::pair<std::string, std::string>> matches;
+        for (const auto &entry : blocks)
+        {
+            Decode(entry.second.second, [&](const std::string &path) {
+                const char *subject = matchPath ? path.c_str() : path.c_str() + (path.find_last_of('/') + 1);
+                if (fnmatch(pattern.c_str(), subject, 0) == 0)
+                    matches.push_back({entry.first, path});
+            });
+        }
+        return matches;
+    }
+
+    // All indexed paths of one project, sorted.
+    inline std::vector<std::string> Paths(const std::string &key)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        Load();
+        std::vector<std::string> paths;
+        auto it = blocks.find(key);
+        if (it != blocks.end())
+        {
+            paths.reserve(it->second.first);
+            Decode(it->second.second, [&](const std::string &path) { paths.push_back(path); });
+        }
+        return paths;
+    }
+
+    inline size_t FileCount()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        Load();
+        size_t count = 0;
+        for (const auto &entry : blocks)
+            count += entry.second.first;
+        return count;
+    }
+} // namespace FileIndex
+
+#endif // FILEINDEX_HPP
@@ -0,0 +1,655 @@
+#ifndef GIT_HPP
+#define GIT_HPP
+
+#include <algorithm>
+#include <string>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <ctime>
+#include <cstdint>
+#include <cstring>
+#include <cctype>
+#include <zlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+namespace fs = std::filesystem;
+
+// Native reader for the on-disk .git metadata. Everything in here reads the
+// repository files directly, so listing hundreds of projects never forks git.
+namespace Git
+{
+    // Object database statistics, the numbers `git count-objects -v` reports.
+    struct ObjectStats
+    {
+        size_t looseObjects = 0; // Number of loose objects.
+        size_t looseBytes = 0;   // Disk space taken by loose objects.
+        size_t packs = 0;        // Number of pack files.
+        size_t packBytes = 0;    // Disk space taken by packs and their indexes.
+    };
+
+    // Git status of a single project folder.
+    struct Status
+    {
+        bool present = false;  // Wether the folder is a git worktree.
+        std::string branch;    // Current branch, or a short hash when detached.
+        time_t lastCommit = 0; // Committer time of HEAD (0 when unknown).
+        bool dirty = false;    // Tracked files differ from the index stat data.
+    };
+
+    // Helper: Read a whole (small) file into a string.
+    inline bool ReadFile(const fs::path &path, std::string &out)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open())
+            return false;
+        std::ostringstream ss;
+        ss << file.rdbuf();
+        out = ss.str();
+        return true;
+    }
+
+    // Helper: Read the first line of a file without the trailing newline.
+    inline std::string ReadFirstLine(const fs::path &path)
+    {
+        std::ifstream file(path);
+        std::string line;
+        if (file.is_open())
+            std::getline(file, line);
+        while (!line.empty() && (line.back() == '\r' || line.back() == ' '))
+            line.pop_back();
+        return line;
+    }
+
+    inline uint32_t ReadBE32(const unsigned char *p)
+    {
+        return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+    }
+
+    inline bool HexToSha(const std::string &hex, unsigned char sha[20])
+    {
+        if (hex.size() < 40)
+            return false;
+        for (int i = 0; i < 20; i++)
+        {
+            unsigned value = 0;
+            for (int j = 0; j < 2; j++)
+            {
+                char c = hex[i * 2 + j];
+                value <<= 4;
+                if (c >= '0' && c <= '9')
+                    value |= c - '0';
+                else if (c >= 'a' && c <= 'f')
+                    value |= c - 'a' + 10;
+                else if (c >= 'A' && c <= 'F')
+                    value |= c - 'A' + 10;
+                else
+                    return false;
+            }
+            sha[i] = static_cast<unsigned char>(value);
+        }
+        return true;
+    }
+
+    // Resolve the git directory of a worktree. Handles both a regular `.git`
+    // directory and a `.git` file ("gitdir: <path>") used by worktrees and submodules.
+    inline fs::path FindGitDir(const fs::path &worktree)
+    {
+        std::error_code ec;
+        fs::path dotGit = worktree / ".git";
+        if (fs::is_directory(dotGit, ec))
+            return dotGit;
+        if (!fs::is_regular_file(dotGit, ec))
+            return {};
+
+        std::string line = ReadFirstLine(dotGit);
+        const std::string prefix = "gitdir:";
+        if (line.compare(0, prefix.size(), prefix) != 0)
+            return {};
+        size_t start = line.find_first_not_of(' ', prefix.size());
+        if (start == std::string::npos)
+            return {};
+        fs::path gitDir = line.substr(start);
+        if (gitDir.is_relative())
+            gitDir = worktree / gitDir;
+        return fs::is_directory(gitDir, ec) ? gitDir : fs::path{};
+    }
+
+    // The directory holding objects, refs and packed-refs. For linked
+    // worktrees this is the main repository, pointed to by `commondir`.
+    inline fs::path FindCommonDir(const fs::path &gitDir)
+    {
+        std::string common = ReadFirstLine(gitDir / "commondir");
+        if (common.empty())
+            return gitDir;
+        fs::path commonDir = common;
+        if (commonDir.is_relative())
+            commonDir = gitDir / commonDir;
+        return commonDir.lexically_normal();
+    }
+
+    // Resolve a ref name ("refs/heads/main") to a 40 character hex hash.
+    // Looks at loose refs first and falls back to packed-refs.
+    inline std::string ResolveRef(const fs::path &gitDir, const fs::path &commonDir, std::string ref)
+    {
+        for (int depth = 0; depth < 8; depth++)
+        {
+            std::string value = ReadFirstLine(gitDir / ref);
+            if (value.empty() && commonDir != gitDir)
+                value = ReadFirstLine(commonDir / ref);
+
+            if (value.empty())
+            {
+                std::ifstream packed(commonDir / "packed-refs");
+                std::string line;
+                while (std::getline(packed, line))
+                {
+                    if (line.size() > 41 && line[0] != '#' && line[0] != '^' &&
+                        line.compare(41, std::string::npos, ref) == 0)
+                        return line.substr(0, 40);
+                }
+                return "";
+            }
+
+            if (value.compare(0, 5, "ref: ") != 0)
+                return value.size() >= 40 ? value.substr(0, 40) : "";
+            ref = value.substr(5);
+        }
+        return "";
+    }
+
+    // Inflate a zlib stream read from fd at offset into out. Stops at the end
+    // of the stream or once maxOut bytes have been produced.
+    inline bool InflateAt(int fd, off_t offset, std::string &out, size_t maxOut)
+    {
+        z_stream zs{};
+        if (inflateInit(&zs) != Z_OK)
+            return false;
+
+        unsigned char in[16384];
+        out.clear();
+        int ret = Z_OK;
+        while (ret != Z_STREAM_END && out.size() < maxOut)
+        {
+            ssize_t got = pread(fd, in, sizeof(in), offset);
+            if (got <= 0)
+                break;
+            offset += got;
+            zs.next_in = in;
+            zs.avail_in = static_cast<uInt>(got);
+            do
+            {
+                char chunk[16384];
+                zs.next_out = reinterpret_cast<Bytef *>(chunk);
+                zs.avail_out = sizeof(chunk);
+                ret = inflate(&zs, Z_NO_FLUSH);
+                if (ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR)
+                {
+                    inflateEnd(&zs);
+                    return false;
+                }
+                out.append(chunk, sizeof(chunk) - zs.avail_out);
+            } while (zs.avail_out == 0 && ret != Z_STREAM_END);
+        }
+        inflateEnd(&zs);
+        return ret == Z_STREAM_END || out.size() >= maxOut;
+    }
+
+    // Read a loose object and return its body (without the "<type> <size>\0" header).
+    inline bool ReadLooseObject(const fs::path &commonDir, const std::string &hex, std::string &body)
+    {
+        fs::path objectPath = commonDir / "objects" / hex.substr(0, 2) / hex.substr(2);
+        int fd = open(objectPath.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            return false;
+        std::string raw;
+        bool ok = InflateAt(fd, 0, raw, 1 << 20);
+        close(fd);
+        size_t nul = raw.find('\0');
+        if (!ok || nul == std::string::npos)
+            return false;
+        body = raw.substr(nul + 1);
+        return true;
+    }
+
+    // Look up an object in a version 2 pack index. Returns the pack offset.
+    inline bool FindInPackIndex(int fd, const unsigned char sha[20], uint64_t &offset)
+    {
+        unsigned char header[8];
+        if (pread(fd, header, sizeof(header), 0) != sizeof(header) ||
+            ReadBE32(header) != 0xff744f63 || ReadBE32(header + 4) != 2)
+            return false;
+
+        unsigned char fanout[256 * 4];
+        if (pread(fd, fanout, sizeof(fanout), 8) != sizeof(fanout))
+            return false;
+        uint32_t total = ReadBE32(fanout + 255 * 4);
+        uint32_t lo = sha[0] == 0 ? 0 : ReadBE32(fanout + (sha[0] - 1) * 4);
+        uint32_t hi = ReadBE32(fanout + sha[0] * 4);
+
+        const off_t shaTable = 8 + sizeof(fanout);
+        while (lo < hi)
+        {
+            uint32_t mid = lo + (hi - lo) / 2;
+            unsigned char entry[20];
+            if (pread(fd, entry, 20, shaTable + off_t(mid) * 20) != 20)
+                return false;
+            int cmp = std::memcmp(entry, sha, 20);
+            if (cmp == 0)
+            {
+                const off_t offsetTable = shaTable + off_t(total) * 24; // Skip hashes and CRCs.
+                unsigned char raw[8];
+                if (pread(fd, raw, 4, offsetTable + off_t(mid) * 4) != 4)
+                    return false;
+                uint32_t small = ReadBE32(raw);
+                if (!(small & 0x80000000u))
+                {
+                    offset = small;
+                    return true;
+                }
+                const off_t largeTable = offsetTable + off_t(total) * 4;
+                if (pread(fd, raw, 8, largeTable + off_t(small & 0x7fffffffu) * 8) != 8)
+                    return false;
+                offset = (uint64_t(ReadBE32(raw)) << 32) | ReadBE32(raw + 4);
+                return true;
+            }
+            if (cmp < 0)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return false;
+    }
+
+    // Apply a git delta to base, producing the target object.
+    inline bool ApplyDelta(const std::string &base, const std::string &delta, std::string &out)
+    {
+        size_t pos = 0;
+        auto readSize = [&](uint64_t &value) {
+            value = 0;
+            int shift = 0;
+            unsigned char c;
+            do
+            {
+                if (pos >= delta.size() || shift > 63)
+                    return false;
+                c = delta[pos++];
+                value |= uint64_t(c & 0x7f) << shift;
+                shift += 7;
+            } while (c & 0x80);
+            return true;
+        };
+
+        uint64_t baseSize, targetSize;
+        if (!readSize(baseSize) || !readSize(targetSize) || baseSize != base.size())
+            return false;
+
+        // Every read below is bounds checked: a corrupt delta fails instead
+        // of reading past the delta or the base.
+        auto readByte = [&](uint64_t &value, int shift) {
+            if (pos >= delta.size())
+                return false;
+            value |= uint64_t(static_cast<unsigned char>(delta[pos++])) << shift;
+            return true;
+        };
+
+        out.clear();
+        out.reserve(std::min<uint64_t>(targetSize, base.size() + delta.size()));
+        while (pos < delta.size())
+        {
+            unsigned char op = delta[pos++];
+            if (op & 0x80)
+            {
+                uint64_t copyOffset = 0, copySize = 0;
+                for (int i = 0; i < 4; i++)
+                    if ((op & (1 << i)) && !readByte(copyOffset, 8 * i))
+                        return false;
+                for (int i = 0; i < 3; i++)
+                    if ((op & (0x10 << i)) && !readByte(copySize, 8 * i))
+                        return false;
+                if (copySize == 0)
+                    copySize = 0x10000;
+                if (copyOffset > base.size() || copySize > base.size() - copyOffset ||
+                    copySize > targetSize - out.size())
+                    return false;
+                out.append(base, copyOffset, copySize);
+            }
+            else if (op)
+            {
+                if (op > delta.size() - pos || op > targetSize - out.size())
+                    return false;
+                out.append(delta, pos, op);
+                pos += op;
+            }
+            else
+            {
+                return false;
+            }
+        }
+        return out.size() == targetSize;
+    }
+
+    // Read the object stored at offset in an open pack, resolving deltas.
+    inline bool ReadPackObjectAt(int packFd, int idxFd, uint64_t offset, std::string &body, int depth = 0)
+    {
+        if (depth > 64)
+            return false;
+
+        unsigned char header[32];
+        ssize_t got = pread(packFd, header, sizeof(header), offset);
+        if (got <= 0)
+            return false;
+
+        // The header varints are checked against the bytes actually read,
+        // so a truncated pack fails instead of reading past them.
+        const size_t available = size_t(got);
+        size_t pos = 0;
+        unsigned char c = header[pos++];
+        int type = (c >> 4) & 7;
+        uint64_t size = c & 15;
+        int shift = 4;
+        while (c & 0x80)
+        {
+            if (pos >= available || shift > 57)
+                return false;
+            c = header[pos++];
+            size |= uint64_t(c & 0x7f) << shift;
+            shift += 7;
+        }
+
+        if (type >= 1 && type <= 4)
+            return InflateAt(packFd, offset + pos, body, size) && body.size() == size;
+
+        std::string base;
+        if (type == 6) // OFS_DELTA: base is at a negative offset in this pack.
+        {
+            if (pos >= available)
+                return false;
+            c = header[pos++];
+            uint64_t back = c & 0x7f;
+            while (c & 0x80)
+            {
+                if (pos >= available || back >= (UINT64_MAX >> 7))
+                    return false;
+                c = header[pos++];
+                back = ((back + 1) << 7) | (c & 0x7f);
+            }
+            if (back > offset || !ReadPackObjectAt(packFd, idxFd, offset - back, base, depth + 1))
+                return false;
+        }
+        else if (type == 7) // REF_DELTA: base is named by hash.
+        {
+            if (available - pos < 20)
+                return false;
+            unsigned char baseSha[20];
+            std::memcpy(baseSha, header + pos, 20);
+            pos += 20;
+            uint64_t baseOffset;
+            if (!FindInPackIndex(idxFd, baseSha, baseOffset) ||
+                !ReadPackObjectAt(packFd, idxFd, baseOffset, base, depth + 1))
+                return false;
+        }
+        else
+        {
+            return false;
+        }
+
+        std::string delta;
+        if (!InflateAt(packFd, offset + pos, delta, size) || delta.size() != size)
+            return false;
+        return ApplyDelta(base, delta, body);
+    }
+
+    // Search every pack of the repository for an object.
+    inline bool ReadPackedObject(const fs::path &commonDir, const std::string &hex, std::string &body)
+    {
+        unsigned char sha[20];
+        if (!HexToSha(hex, sha))
+            return false;
+
+        std::error_code ec;
+        fs::path packDir = commonDir / "objects" / "pack";
+        for (const auto &entry : fs::directory_iterator(packDir, ec))
+        {
+            if (entry.path().extension() != ".idx")
+                continue;
+            int idxFd = open(entry.path().c_str(), O_RDONLY | O_CLOEXEC);
+            if (idxFd < 0)
+                continue;
+            uint64_t offset;
+            bool found = false;
+            if (FindInPackIndex(idxFd, sha, offset))
+            {
+                fs::path packPath = entry.path();
+                packPath.replace_extension(".pack");
+                int packFd = open(packPath.c_str(), O_RDONLY | O_CLOEXEC);
+                if (packFd >= 0)
+                {
+                    found = ReadPackObjectAt(packFd, idxFd, offset, body);
+                    close(packFd);
+                }
+            }
+            close(idxFd);
+            if (found)
+                return true;
+        }
+        return false;
+    }
+
+    // Parse the committer timestamp from a commit object body.
+    inline time_t ParseCommitTime(const std::string &body)
+    {
+        size_t pos = body.find("\ncommitter ");
+        if (pos == std::string::npos)
+            return 0;
+        size_t end = body.find('\n', pos + 1);
+        std::string line = body.substr(pos + 1, end - pos - 1);
+        size_t email = line.rfind('>');
+        if (email == std::string::npos)
+            return 0;
+        return static_cast<time_t>(std::strtoll(line.c_str() + email + 1, nullptr, 10));
+    }
+
+    // Fallback when the commit object is unreadable: the newest HEAD reflog entry.
+    inline time_t ReflogTime(const fs::path &gitDir)
+    {
+        std::ifstream log(gitDir / "logs" / "HEAD");
+        std::string line, last;
+        while (std::getline(log, line))
+            if (!line.empty())
+                last = line;
+        size_t email = last.find('>');
+        if (email == std::string::npos)
+            return 0;
+        return static_cast<time_t>(std::strtoll(last.c_str() + email + 1, nullptr, 10));
+    }
+
+    // Cheap dirty check: compare the stat data cached in the index with the
+    // worktree, the same shortcut `git status` takes before hashing content.
+    // Untracked files are not considered.
+    inline bool IsDirty(const fs::path &worktree, const fs::path &gitDir)
+    {
+        std::string index;
+        if (!ReadFile(gitDir / "index", index) || index.size() < 12 || index.compare(0, 4, "DIRC") != 0)
+            return false;
+
+        const unsigned char *data = reinterpret_cast<const unsigned char *>(index.data());
+        uint32_t version = ReadBE32(data + 4);
+        uint32_t entries = ReadBE32(data + 8);
+        if (version < 2 || version > 4)
+            return false;
+
+        size_t pos = 12;
+        std::string name;
+        for (uint32_t i = 0; i < entries; i++)
+        {
+            const size_t fixed = 62; // 10 stat fields, hash and flags.
+            if (pos + fixed > index.size())
+                return false;
+            const unsigned char *entry = data + pos;
+            uint32_t mtime = ReadBE32(entry + 8);
+            uint32_t mode = ReadBE32(entry + 24);
+            uint32_t size = ReadBE32(entry + 36);
+            uint16_t flags = (uint16_t(entry[60]) << 8) | entry[61];
+            size_t cursor = pos + fixed;
+            bool skipWorktree = false;
+            if ((flags & 0x4000) && version >= 3)
+            {
+                if (cursor + 2 > index.size())
+                    return false;
+                uint16_t extended = (uint16_t(data[cursor]) << 8) | data[cursor + 1];
+                skipWorktree = extended & 0x4000;
+                cursor += 2;
+            }
+
+            if (version == 4)
+            {
+                // Path is prefix compressed against the previous entry.
+                if (cursor >= index.size())
+                    return false;
+                uint64_t strip = data[cursor] & 0x7f;
+                while (data[cursor++] & 0x80)
+                {
+                    if (cursor >= index.size())
+                        return false;
+                    strip = ((strip + 1) << 7) | (data[cursor] & 0x7f);
+                }
+                size_t end = index.find('\0', cursor);
+                if (end == std::string::npos || strip > name.size())
+                    return false;
+                name.resize(name.size() - strip);
+                name.append(index, cursor, end - cursor);
+                pos = end + 1;
+            }
+            else
+            {
+                size_t end = index.find('\0', cursor);
+                if (end == std::string::npos)
+                    return false;
+                name.assign(index, cursor, end - cursor);
+                pos += ((end - pos) + 8) & ~size_t(7); // Entries are NUL padded to 8 bytes.
+            }
+
+            if (skipWorktree || (mode & 0170000) == 0160000) // Sparse entries and submodules.
+                continue;
+
+            struct stat st;
+            fs::path file = worktree / name;
+            if (lstat(file.c_str(), &st) != 0)
+                return true;
+            if (uint32_t(st.st_mtime) != mtime || uint32_t(st.st_size) != size)
+                return true;
+        }
+        return false;
+    }
+
+    // Read the git status of a project folder.
+    inline Status ReadStatus(const fs::path &worktree)
+    {
+        Status status;
+        fs::path gitDir = FindGitDir(worktree);
+        if (gitDir.empty())
+            return status;
+        status.present = true;
+        fs::path commonDir = FindCommonDir(gitDir);
+
+        std::string head = ReadFirstLine(gitDir / "HEAD");
+        std::string hash;
+        if (head.compare(0, 5, "ref: ") == 0)
+        {
+            std::string ref = head.substr(5);
+            const std::string heads = "refs/heads/";
+            status.branch = ref.compare(0, heads.size(), heads) == 0 ? ref.substr(heads.size()) : ref;
+            hash = ResolveRef(gitDir, commonDir, ref);
+        }
+        else if (head.size() >= 40)
+        {
+            hash = head.substr(0, 40);
+            status.branch = "(" + hash.substr(0, 7) + ")";
+        }
+
+        std::string commit;
+        if (!hash.empty() && (ReadLooseObject(commonDir, hash, commit) || ReadPackedObject(commonDir, hash, commit)))
+            status.lastCommit = ParseCommitTime(commit);
+        if (status.lastCommit == 0 && !hash.empty())
+            status.lastCommit = ReflogTime(gitDir);
+
+        status.dirty = IsDirty(worktree, gitDir);
+        return status;
+    }
+
+    // Count loose objects and packs by reading objects/ directly.
+    inline ObjectStats CountObjects(const fs::path &commonDir)
+    {
+        ObjectStats stats;
+        std::error_code ec;
+        fs::path objects = commonDir / "objects";
+        for (const auto &fanout : fs::directory_iterator(objects, ec))
+        {
+            std::string name = fanout.path().filename().string();
+            if (name.size() != 2 || !std::isxdigit(name[0]) || !std::isxdigit(name[1]))
+                continue;
+            for (const auto &object : fs::directory_iterator(fanout.path(), ec))
+            {
+                stats.looseObjects++;
+                stats.looseBytes += object.file_size(ec);
+            }
+        }
+        for (const auto &pack : fs::directory_iterator(objects / "pack", ec))
+        {
+            if (pack.path().extension() == ".pack")
+                stats.packs++;
+            stats.packBytes += pack.file_size(ec);
+        }
+        return stats;
+    }
+
+    // Initialize an empty repository in worktree by writing the minimal .git
+    // layout directly. Files from templateDir (hooks, info/exclude, description)
+    // are copied first, like `git init --template`. An existing repository is left untouched.
+    inline bool Init(const fs::path &worktree, const std::string &branch = "master", const fs::path &templateDir = {})
+    {
+        std::error_code ec;
+        fs::path gitDir = worktree / ".git";
+        if (fs::exists(gitDir, ec))
+            return true;
+
+        if (!templateDir.empty() && fs::is_directory(templateDir, ec))
+        {
+            fs::copy(templateDir, gitDir, fs::copy_options::recursive | fs::copy_options::skip_existing, ec);
+            if (ec)
+                return false;
+        }
+
+        for (const char *dir : {"objects/info", "objects/pack", "refs/heads", "refs/tags", "info", "hooks"})
+        {
+            fs::create_directories(gitDir / dir, ec);
+            if (ec)
+                return false;
+        }
+
+        auto writeFile = [&](const fs::path &path, const std::string &content, bool overwrite) {
+            if (!overwrite && fs::exists(path, ec))
+                return true;
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            file << content;
+            return file.good();
+        };
+
+        std::string config =
+            "[core]\n"
+            "\trepositoryformatversion = 0\n"
+            "\tfilemode = true\n"
+            "\tbare = false\n"
+            "\tlogallrefupdates = true\n";
+
+        return writeFile(gitDir / "HEAD", "ref: refs/heads/" + (branch.empty() ? std::string("master") : branch) + "\n", true) &&
+               writeFile(gitDir / "config", config, true) &&
+               writeFile(gitDir / "description", "Unnamed repository; edit this file 'description' to name the repository.\n", false) &&
+               writeFile(gitDir / "info" / "exclude", "# git ls-files --others --exclude-from=.git/info/exclude\n", false);
+    }
+} // namespace Git
+
+#endif // GIT_HPP
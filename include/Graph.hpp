@@ -0,0 +1,134 @@
+#ifndef GRAPH_HPP
+#define GRAPH_HPP
+
+#include <string>
+#include <vector>
+#include <set>
+#include <algorithm>
+
+// Dependency graph between projects. Nodes are indices into a list of
+// projects; an edge from a project to one of its dependencies means the
+// dependency has to be built first.
+namespace Graph
+{
+    struct Dag
+    {
+        std::vector<std::vector<size_t>> dependencies; // Per project: the projects it depends on.
+        std::vector<std::vector<size_t>> dependents;   // Per project: the projects depending on it.
+    };
+
+    // Build the graph from the dependency names of every project. nameOf(i)
+    // and dependsOf(i) return the name and the declared dependencies of
+    // project i; unknown names are collected in missing ("project -> name").
+    template <typename NameFn, typename DependsFn>
+    inline Dag Build(size_t count, NameFn &&nameOf, DependsFn &&dependsOf, std::vector<std::string> &missing)
+    {
+        Dag dag;
+        dag.dependencies.resize(count);
+        dag.dependents.resize(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            for (const std::string &name : dependsOf(i))
+            {
+                size_t j = 0;
+                while (j < count && nameOf(j) != name)
+                    j++;
+                if (j == count)
+                {
+                    missing.push_back(nameOf(i) + " -> " + name);
+                    continue;
+                }
+                dag.dependencies[i].push_back(j);
+                dag.dependents[j].push_back(i);
+            }
+        }
+        return dag;
+    }
+
+    // The graph of a list of projects (anything with name and dependencies
+    // members, e.g. DevCore::Project).
+    template <typename Projects>
+    inline Dag FromProjects(const Projects &projects, std::vector<std::string> &missing)
+    {
+        return Build(
+            projects.size(), [&](size_t i) -> const std::string & { return projects[i].name; },
+            [&](size_t i) -> const auto & { return projects[i].dependencies; }, missing);
+    }
+
+    // A cycle as a list of nodes (first node repeated at the end), or an
+    // empty list when the graph is acyclic. Iterative depth first search
+    // with the usual white/grey/black colouring.
+    inline std::vector<size_t> FindCycle(const Dag &dag)
+    {
+        enum Color : char { WHITE, GREY, BLACK };
+        size_t count = dag.dependencies.size();
+        std::vector<char> color(count, WHITE);
+        std::vector<size_t> parent(count, count);
+        for (size_t root = 0; root < count; root++)
+        {
+            if (color[root] != WHITE)
+                continue;
+            std::vector<std::pair<size_t, size_t>> stack{{root, 0}}; // (node, next edge)
+            color[root] = GREY;
+            while (!stack.empty())
+            {
+                auto &[node, edge] = stack.back();
+                if (edge == dag.dependencies[node].size())
+                {
+                    color[node] = BLACK;
+                    stack.pop_back();
+                    continue;
+                }
+                size_t next = dag.dependencies[node][edge++];
+                if (color[next] == GREY)
+                {
+                    std::vector<size_t> cycle{next};
+                    for (size_t at = node; at != next; at = parent[at])
+                        cycle.push_back(at);
+                    cycle.push_back(next);
+                    std::reverse(cycle.begin(), cycle.end());
+                    return cycle;
+                }
+                if (color[next] == WHITE)
+                {
+                    color[next] = GREY;
+                    parent[next] = node;
+                    stack.push_back({next, 0});
+                }
+            }
+        }
+        return {};
+    }
+
+    // Format a cycle of project indices as "a -> b -> a".
+    template <typename Projects>
+    inline std::string CycleToString(const Projects &projects, const std::vector<size_t> &cycle)
+    {
+        std::string text;
+        for (size_t node : cycle)
+            text += (text.empty() ? "" : " -> ") + projects[node].name;
+        return text;
+    }
+
+    // All nodes reachable from seeds along edges (seeds included): with
+    // dag.dependencies the upstream projects, with dag.dependents the
+    // downstream ones.
+    inline std::set<size_t> Closure(const std::vector<std::vector<size_t>> &edges, const std::set<size_t> &seeds)
+    {
+        std::set<size_t> reached(seeds);
+        std::vector<size_t> stack(seeds.begin(), seeds.end());
+        while (!stack.empty())
+        {
+            size_t node = stack.back();
+            stack.pop_back();
+            for (size_t next : edges[node])
+            {
+                if (reached.insert(next).second)
+                    stack.push_back(next);
+            }
+        }
+        return reached;
+    }
+} // namespace Graph
+
+#endif // GRAPH_HPP
@@ -0,0 +1,142 @@
+#ifndef GREP_HPP
+#define GREP_HPP
+
+#include "../dependencies/Canvas.hpp"
+#include "DevCore.hpp"
+#include "Binary.hpp"
+#include "Ignore.hpp"
+#include "Search.hpp"
+#include "Simd.hpp"
+#include "Walker.hpp"
+#include <string>
+#include <vector>
+#include <mutex>
+#include <regex>
+#include <memory>
+#include <chrono>
+#include <atomic>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+
+// `devcore grep`: index-free search of every project, straight from disk.
+// Files are found by the work stealing walker, read with one large read (or
+// mmap for big files), checked for binary content and scanned with the SIMD
+// literal finder. Results are printed per project as soon as it is finished.
+namespace Grep
+{
+    const size_t MMAP_THRESHOLD = 1 << 20;  // Files from this size on are mapped instead of read.
+    const size_t BINARY_PROBE = 8192;       // Bytes checked for NUL to detect binary files.
+
+    struct Options
+    {
+        std::string pattern;
+        bool ignoreCase = false;
+        bool regex = false;
+    };
+
+    // Scan one file and append "relative:line: text" lines for every matching line.
+    inline size_t ScanFile(const char *data, size_t size, const std::string &relative, const Options &options,
+                           const std::string &prefilter, const std::regex *regex, std::string &out)
+    {
+        if (size == 0 || std::memchr(data, '\0', std::min(size, BINARY_PROBE)))
+            return 0;
+
+        return Search::ScanLines(data, size, options.pattern, regex, prefilter, options.ignoreCase, [&](size_t line, const char *lineStart, const char *lineEnd) {
+            out += "  " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + relative +
+                   Canvas::ColorToAnsi(Canvas::Color::YELLOW) + ":" + std::to_string(line) + ":" + Canvas::ResetColor() + " ";
+            out.append(lineStart, std::min<size_t>(lineEnd - lineStart, 200));
+            out += "\n";
+        });
+    }
+
+    inline void Run(const Options &options)
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        std::unique_ptr<std::regex> regex;
+        std::string prefilter;
+        if (options.regex)
+        {
+            try
+            {
+                auto flags = std::regex::ECMAScript | std::regex::optimize;
+                if (options.ignoreCase)
+                    flags |= std::regex::icase;
+                regex = std::make_unique<std::regex>(options.pattern, flags);
+            }
+            catch (const std::regex_error &e)
+            {
+                Canvas::PrintError("Invalid regular expression: " + std::string(e.what()));
+                return;
+            }
+            // Lines without the longest required literal cannot match.
+            prefilter = Search::Prefilter(options.pattern);
+        }
+
+        std::vector<DevCore::Project> projects = DevCore::Projects();
+        std::vector<Walker::Root> roots;
+        for (const auto &proj : projects)
+            roots.push_back({proj.path, Ignore::Load(proj.path)});
+
+        struct ProjectOutput
+        {
+            std::mutex mutex;
+            std::string text;
+            size_t matches = 0;
+            size_t files = 0;
+        };
+        std::vector<ProjectOutput> outputs(roots.size());
+        std::vector<std::string> buffers(Walker::WorkerCount());
+        std::atomic<size_t> scanned{0};
+        std::mutex printMutex;
+        size_t totalMatches = 0, totalFiles = 0, totalProjects = 0;
+
+        Walker::Walk(roots,
+            [&](size_t root, unsigned worker, const std::string &path, const std::string &relative) {
+                scanned++;
+                std::string found;
+                size_t matches = 0;
+                struct stat st;
+                if (stat(path.c_str(), &st) != 0)
+                    return;
+                if (static_cast<size_t>(st.st_size) >= MMAP_THRESHOLD)
+                {
+                    Binary::MappedFile mapped(path);
+                    if (mapped.isOpen())
+                        matches = ScanFile(mapped.data(), mapped.size(), relative, options, prefilter, regex.get(), found);
+                }
+                else if (Binary::ReadInto(path, buffers[worker]))
+                {
+                    matches = ScanFile(buffers[worker].data(), buffers[worker].size(), relative, options, prefilter, regex.get(), found);
+                }
+                if (matches == 0)
+                    return;
+
+                ProjectOutput &output = outputs[root];
+                std::lock_guard<std::mutex> lock(output.mutex);
+                output.text += found;
+                output.matches += matches;
+                output.files++;
+            },
+            [&](size_t root) {
+                ProjectOutput &output = outputs[root];
+                if (output.matches == 0)
+                    return;
+                const DevCore::Project &proj = projects[root];
+                std::lock_guard<std::mutex> lock(printMutex);
+                Canvas::PrintColoredLine(Canvas::BoldText(proj.name) + Canvas::ColorToAnsi(Canvas::Color::CYAN) + " (" + proj.lang + "/" + proj.folderName + ")", Canvas::Color::CYAN);
+                std::cout << output.text << std::flush;
+                totalMatches += output.matches;
+                totalFiles += output.files;
+                totalProjects++;
+            });
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        Canvas::PrintInfo(std::to_string(totalMatches) + " matches in " + std::to_string(totalFiles) + " files across " +
+                          std::to_string(totalProjects) + " projects (" + std::to_string(scanned.load()) + " files scanned) in " +
+                          std::to_string(elapsed) + " ms.");
+    }
+} // namespace Grep
+
+#endif // GREP_HPP
@@ -0,0 +1,155 @@
+#ifndef HASH_HPP
+#define HASH_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+// Fast non-cryptographic hashing (XXH64). Used to compare file contents; it is
+// not meant to resist deliberately crafted collisions.
+namespace Hash
+{
+    const uint64_t PRIME1 = 11400714785074694791ULL;
+    const uint64_t PRIME2 = 14029467366897019727ULL;
+    const uint64_t PRIME3 = 1609587929392839161ULL;
+    const uint64_t PRIME4 = 9650029242287828579ULL;
+    const uint64_t PRIME5 = 2870177450012600261ULL;
+
+    inline uint64_t Rotl(uint64_t value, int bits)
+    {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    inline uint64_t Read64(const unsigned char *p)
+    {
+        uint64_t value;
+        std::memcpy(&value, p, 8);
+        return value;
+    }
+
+    inline uint32_t Read32(const unsigned char *p)
+    {
+        uint32_t value;
+        std::memcpy(&value, p, 4);
+        return value;
+    }
+
+    inline uint64_t Round(uint64_t acc, uint64_t input)
+    {
+        acc += input * PRIME2;
+        acc = Rotl(acc, 31);
+        return acc * PRIME1;
+    }
+
+    inline uint64_t MergeRound(uint64_t acc, uint64_t value)
+    {
+        acc ^= Round(0, value);
+        return acc * PRIME1 + PRIME4;
+    }
+
+    // Streaming XXH64: Update() any number of times, then Digest().
+    class XXH64
+    {
+    public:
+        explicit XXH64(uint64_t seed = 0)
+            : seed_(seed),
+              v1_(seed + PRIME1 + PRIME2), v2_(seed + PRIME2), v3_(seed), v4_(seed - PRIME1)
+        {
+        }
+
+        void Update(const void *data, size_t size)
+        {
+            const unsigned char *p = static_cast<const unsigned char *>(data);
+            const unsigned char *end = p + size;
+            total_ += size;
+
+            if (buffered_ + size < 32)
+            {
+                std::memcpy(buffer_ + buffered_, p, size);
+                buffered_ += size;
+                return;
+            }
+            if (buffered_)
+            {
+                size_t fill = 32 - buffered_;
+                std::memcpy(buffer_ + buffered_, p, fill);
+                Consume(buffer_);
+                p += fill;
+                buffered_ = 0;
+            }
+            for (; p + 32 <= end; p += 32)
+                Consume(p);
+            buffered_ = static_cast<size_t>(end - p);
+            std::memcpy(buffer_, p, buffered_);
+        }
+
+        uint64_t Digest() const
+        {
+            uint64_t h;
+            if (total_ >= 32)
+            {
+                h = Rotl(v1_, 1) + Rotl(v2_, 7) + Rotl(v3_, 12) + Rotl(v4_, 18);
+                h = MergeRound(h, v1_);
+                h = MergeRound(h, v2_);
+                h = MergeRound(h, v3_);
+                h = MergeRound(h, v4_);
+            }
+            else
+            {
+                h = seed_ + PRIME5;
+            }
+            h += total_;
+
+            const unsigned char *p = buffer_;
+            const unsigned char *end = buffer_ + buffered_;
+            for (; p + 8 <= end; p += 8)
+            {
+                h ^= Round(0, Read64(p));
+                h = Rotl(h, 27) * PRIME1 + PRIME4;
+            }
+            if (p + 4 <= end)
+            {
+                h ^= static_cast<uint64_t>(Read32(p)) * PRIME1;
+                h = Rotl(h, 23) * PRIME2 + PRIME3;
+                p += 4;
+            }
+            for (; p < end; p++)
+            {
+                h ^= *p * PRIME5;
+                h = Rotl(h, 11) * PRIME1;
+            }
+
+            h ^= h >> 33;
+            h *= PRIME2;
+            h ^= h >> 29;
+            h *= PRIME3;
+            h ^= h >> 32;
+            return h;
+        }
+
+    private:
+        void Consume(const unsigned char *p)
+        {
+            v1_ = Round(v1_, Read64(p));
+            v2_ = Round(v2_, Read64(p + 8));
+            v3_ = Round(v3_, Read64(p + 16));
+            v4_ = Round(v4_, Read64(p + 24));
+        }
+
+        uint64_t seed_;
+        uint64_t v1_, v2_, v3_, v4_;
+        uint64_t total_ = 0;
+        unsigned char buffer_[32];
+        size_t buffered_ = 0;
+    };
+
+    // One-shot XXH64 of a buffer.
+    inline uint64_t Of(const void *data, size_t size, uint64_t seed = 0)
+    {
+        XXH64 state(seed);
+        state.Update(data, size);
+        return state.Digest();
+    }
+} // namespace Hash
+
+#endif // HASH_HPP
@@ -0,0 +1,150 @@
+#ifndef IGNORE_HPP
+#define IGNORE_HPP
+
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <fstream>
+#include <fnmatch.h>
+namespace fs = std::filesystem;
+
+// Ignore rules shared by every command that walks project contents, so VCS
+// metadata and build outputs are never searched or indexed.
+namespace Ignore
+{
+    // VCS metadata, skipped in every project whatever the ignore files say.
+    const std::vector<std::string> VCS_DIRS{".git", ".hg", ".svn"};
+
+    // Usual build outputs, environments and editor state. They are skipped
+    // as if they were the first lines of the project's ignore file, so a
+    // "!build/" rule brings a source directory with one of these names back.
+    const std::vector<std::string> DEFAULT_DIRS{
+        "build", "target", "node_modules", "__pycache__", ".gradle",
+        ".venv", "venv", ".cache", ".idea", ".vscode"
+    };
+
+    // A single pattern from .gitignore or .devcoreignore.
+    struct Pattern
+    {
+        std::string glob;
+        bool negate = false;   // "!pattern" re-includes a path.
+        bool dirOnly = false;  // "pattern/" only matches directories.
+        bool anchored = false; // Contains a '/', so it matches the whole relative path.
+    };
+
+    // The ignore rules of one project. Only the patterns in the root .gitignore
+    // and .devcoreignore are used; nested ignore files are not read.
+    struct Rules
+    {
+        std::vector<Pattern> patterns;
+
+        bool Matches(const std::string &relative, bool isDir) const
+        {
+            std::string name = relative.substr(relative.find_last_of('/') + 1);
+            if (isDir)
+            {
+                for (const auto &dir : VCS_DIRS)
+                {
+                    if (name == dir)
+                        return true;
+                }
+            }
+
+            bool ignored = false;
+            for (const auto &pattern : patterns)
+            {
+                if (pattern.dirOnly && !isDir)
+                    continue;
+                bool match = pattern.anchored
+                                 ? fnmatch(pattern.glob.c_str(), relative.c_str(), FNM_PATHNAME) == 0
+                                 : fnmatch(pattern.glob.c_str(), name.c_str(), 0) == 0;
+                if (match)
+                    ignored = !pattern.negate;
+            }
+            return ignored;
+        }
+    };
+
+    inline void LoadFile(const fs::path &file, Rules &rules)
+    {
+        std::ifstream in(file);
+        std::string line;
+        while (std::getline(in, line))
+        {
+            while (!line.empty() && (line.back() == '\r' || line.back() == ' '))
+                line.pop_back();
+            if (line.empty() || line[0] == '#')
+                continue;
+
+            Pattern pattern;
+            if (line[0] == '!')
+            {
+                pattern.negate = true;
+                line.erase(0, 1);
+            }
+            if (!line.empty() && line.back() == '/')
+            {
+                pattern.dirOnly = true;
+                line.pop_back();
+            }
+            if (line.compare(0, 3, "**/") == 0)
+                line.erase(0, 3);
+            if (!line.empty() && line[0] == '/')
+            {
+                pattern.anchored = true;
+                line.erase(0, 1);
+            }
+            else if (line.find('/') != std::string::npos)
+            {
+                pattern.anchored = true;
+            }
+            if (line.empty())
+                continue;
+            pattern.glob = line;
+            rules.patterns.push_back(pattern);
+        }
+    }
+
+    // Load the ignore rules of a project folder: DEFAULT_DIRS, then the
+    // patterns of its ignore files.
+    inline Rules Load(const fs::path &projectRoot)
+    {
+        Rules rules;
+        for (const auto &dir : DEFAULT_DIRS)
+        {
+            Pattern pattern;
+            pattern.glob = dir;
+            pattern.dirOnly = true;
+            rules.patterns.push_back(pattern);
+        }
+        LoadFile(projectRoot / ".gitignore", rules);
+        LoadFile(projectRoot / ".devcoreignore", rules);
+        return rules;
+    }
+
+    // Call fn(entry, relativePath) for every regular file under root that is
+    // not ignored. Ignored directories are not descended into.
+    template <typename Fn>
+    inline void ForEachFile(const fs::path &root, const Rules &rules, Fn &&fn)
+    {
+        std::error_code ec;
+        fs::recursive_directory_iterator it(root, fs::directory_options::skip_permission_denied, ec);
+        for (; !ec && it != fs::recursive_directory_iterator(); it.increment(ec))
+        {
+            const fs::directory_entry &entry = *it;
+            std::string relative = entry.path().lexically_relative(root).generic_string();
+            if (entry.is_symlink(ec))
+                continue;
+            if (entry.is_directory(ec))
+            {
+                if (rules.Matches(relative, true))
+                    it.disable_recursion_pending();
+                continue;
+            }
+            if (entry.is_regular_file(ec) && !rules.Matches(relative, false))
+                fn(entry, relative);
+        }
+    }
+} // namespace Ignore
+
+#endif // IGNORE_HPP
@@ -1,13 +1,16 @@
 #ifndef MAIN__H
 #define MAIN__H
 #include <string.h>
+#include <cstdlib>
+#include <string>
 
 namespace Main
 {
     const std::string TEMPLATE_PATH = "/.config/devcore/templates";
     const std::string CONFIG_PATH = "/.config/devcore/devcore.conf";
     const std::string DEVMAP_PATH = "/.config/devcore/devmap.json";
-    const std::string HOME_PATH = getenv("HOME");
+    const std::string CACHE_PATH = "/.cache/devcore";
+    const std::string HOME_PATH = getenv("HOME") ? getenv("HOME") : ""; // Unset for some daemons loading libdevcore.
 }
 
 #endif // MAIN__H
\ No newline at end of file
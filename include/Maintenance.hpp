@@ -0,0 +1,177 @@
+#ifndef MAINTENANCE_HPP
+#define MAINTENANCE_HPP
+
+#include "../dependencies/Canvas.hpp"
+#include "../dependencies/Config.hpp"
+#include "DevCore.hpp"
+#include "Git.hpp"
+#include "Parallel.hpp"
+#include "Process.hpp"
+#include "Strings.hpp"
+#include <string>
+#include <vector>
+#include <mutex>
+#include <set>
+#include <ctime>
+
+// `devcore git-maintenance`: garbage collect the repositories that need it.
+namespace Maintenance
+{
+    // Same thresholds git uses for `git gc --auto` (gc.auto and gc.autoPackLimit).
+    const size_t LOOSE_OBJECT_LIMIT = 6700;
+    const size_t PACK_LIMIT = 50;
+
+    // Concurrent jobs (maintenance_jobs): few by default, since every job is I/O heavy.
+    const unsigned DEFAULT_JOBS = 2;
+    const unsigned MAX_JOBS = 64;
+
+    // A repository selected for maintenance.
+    struct Job
+    {
+        size_t project;            // Index into the projects passed to SelectJobs.
+        fs::path worktree;         // Project folder.
+        fs::path commonDir;        // Repository holding the objects.
+        Git::ObjectStats before;   // Object statistics before maintenance.
+        Git::ObjectStats after;    // Object statistics after maintenance.
+        std::string action;        // "gc" or "repack".
+        int exitCode = 0;          // Exit code of the git command.
+    };
+
+    inline size_t objectBytes(const Git::ObjectStats &stats)
+    {
+        return stats.looseBytes + stats.packBytes;
+    }
+
+    // Select the repositories whose object database needs maintenance.
+    // With all set, every git project is selected.
+    inline std::vector<Job> SelectJobs(const std::vector<DevCore::Project> &projects, bool all)
+    {
+        std::vector<Job> candidates(projects.size());
+        std::vector<bool> selected(projects.size(), false);
+
+        Parallel::ForEach(projects.size(), [&](size_t i) {
+            fs::path worktree = projects[i].path;
+            fs::path gitDir = Git::FindGitDir(worktree);
+            if (gitDir.empty())
+                return;
+
+            Job &job = candidates[i];
+            job.project = i;
+            job.worktree = worktree;
+            job.commonDir = fs::weakly_canonical(Git::FindCommonDir(gitDir));
+            job.before = Git::CountObjects(job.commonDir);
+            if (job.before.looseObjects > LOOSE_OBJECT_LIMIT)
+                job.action = "gc";
+            else if (job.before.packs > PACK_LIMIT)
+                job.action = "repack";
+            else if (all)
+                job.action = "gc";
+            selected[i] = !job.action.empty();
+        });
+
+        // Linked worktrees share one object database; maintain it only once.
+        std::vector<Job> jobs;
+        std::set<fs::path> repositories;
+        for (size_t i = 0; i < candidates.size(); i++)
+        {
+            if (selected[i] && repositories.insert(candidates[i].commonDir).second)
+                jobs.push_back(candidates[i]);
+        }
+        return jobs;
+    }
+
+    inline void Run(bool all = false, bool dryRun = false)
+    {
+        Canvas::PrintTitle("DevCore | Git Maintenance", Canvas::Color::CYAN);
+
+        std::vector<DevCore::Project> projects = DevCore::Projects();
+        std::vector<Job> jobs = SelectJobs(projects, all);
+        if (jobs.empty())
+        {
+            Canvas::PrintSuccess("No repository needs maintenance (loose objects <= " + std::to_string(LOOSE_OBJECT_LIMIT) +
+                                 ", packs <= " + std::to_string(PACK_LIMIT) + "). Use --all to force it.");
+            return;
+        }
+
+        std::vector<std::string> header = {"Name", "Loose Objects", "Packs", "Object Size", "Action"};
+        std::vector<std::vector<std::string>> rows;
+        for (const auto &job : jobs)
+        {
+            rows.push_back({projects[job.project].name,
+                            std::to_string(job.before.looseObjects),
+                            std::to_string(job.before.packs),
+                            Strings::FormatSize(objectBytes(job.before)),
+                            job.action});
+        }
+        Canvas::PrintTable(" Selected ", header, rows, Canvas::Color::CYAN);
+        if (dryRun)
+            return;
+
+        // 0 would mean one job per core to ForEach, which is what this
+        // command must not do, so the value is checked before it gets there.
+        unsigned concurrency = DEFAULT_JOBS;
+        uint64_t configured = 0;
+        if (Strings::ParseCount(Config::getOr("maintenance_jobs", std::to_string(DEFAULT_JOBS)), configured, MAX_JOBS) && configured > 0)
+            concurrency = static_cast<unsigned>(configured);
+        else
+            Canvas::PrintWarning("maintenance_jobs must be between 1 and " + std::to_string(MAX_JOBS) + ", using " + std::to_string(DEFAULT_JOBS) + ".");
+        Process::IoClass ioClass = Process::ParseIoClass(Config::getOr("maintenance_ionice", "idle"));
+
+        // The I/O priority is set on the thread that runs a job and inherited
+        // by the git processes it spawns. ForEach also runs jobs on the
+        // calling thread (all of them with a single job slot), so each job
+        // restores the priority it found: the rest of devcore, the DevMap
+        // save included, keeps its normal I/O priority.
+        std::mutex printMutex;
+        Parallel::ForEach(jobs.size(), [&](size_t i) {
+            Job &job = jobs[i];
+            int previousPriority = Process::GetIoPriority();
+            if (ioClass != Process::IoClass::DEFAULT)
+                Process::SetIoPriority(ioClass);
+
+            std::vector<std::string> argv = {"git", "-C", job.worktree.string()};
+            if (job.action == "repack")
+                argv.insert(argv.end(), {"repack", "-a", "-d", "-q"});
+            else
+                argv.insert(argv.end(), {"gc", "--quiet"});
+            job.exitCode = Process::Run(argv, true);
+            job.after = Git::CountObjects(job.commonDir);
+            if (ioClass != Process::IoClass::DEFAULT)
+                Process::SetIoPriority(previousPriority);
+
+            std::lock_guard<std::mutex> lock(printMutex);
+            if (job.exitCode == 0)
+                Canvas::PrintInfo("Finished " + job.action + " of '" + projects[job.project].name + "'.");
+            else
+                Canvas::PrintError("git " + job.action + " failed for '" + projects[job.project].name + "'.");
+        }, concurrency);
+
+        // Record the outcome in the DevMap.
+        rows.clear();
+        size_t totalReclaimed = 0;
+        time_t now = std::time(nullptr);
+        for (const auto &job : jobs)
+        {
+            const DevCore::Project &proj = projects[job.project];
+            size_t before = objectBytes(job.before);
+            size_t after = objectBytes(job.after);
+            size_t reclaimed = before > after ? before - after : 0;
+            if (job.exitCode == 0)
+            {
+                DevCore::RecordMaintenance(proj, reclaimed, now);
+                totalReclaimed += reclaimed;
+            }
+            rows.push_back({proj.name,
+                            Strings::FormatSize(before),
+                            Strings::FormatSize(after),
+                            Strings::FormatSize(reclaimed),
+                            job.exitCode == 0 ? "OK" : "Failed (" + std::to_string(job.exitCode) + ")"});
+        }
+        DevCore::Save();
+
+        Canvas::PrintTable(" Maintenance ", {"Name", "Before", "After", "Reclaimed", "Status"}, rows, Canvas::Color::GREEN);
+        Canvas::PrintSuccess("Reclaimed " + Strings::FormatSize(totalReclaimed) + " across " + std::to_string(jobs.size()) + " repositories.");
+    }
+} // namespace Maintenance
+
+#endif // MAINTENANCE_HPP
@@ -0,0 +1,241 @@
+#ifndef OPEN_HPP
+#define OPEN_HPP
+
+#include "../dependencies/Canvas.hpp"
+#include "Binary.hpp"
+#include "DevCore.hpp"
+#include "Editor.hpp"
+#include "Main.hpp"
+#include "Strings.hpp"
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <cmath>
+#include <cctype>
+#include <ctime>
+
+// `devcore open [query]`: open a project in the editor. Projects are ranked
+// by how well their name matches the query (exact, prefix, substring, then
+// a fuzzy subsequence) plus their frecency: how often and how recently they
+// were opened, kept in a small access log in ~/.cache/devcore/frecency.
+// The top hit is opened directly when it clearly wins, otherwise the best
+// candidates are listed to choose from.
+namespace Open
+{
+    struct Access
+    {
+        double rank = 0;   // Number of opens, aged (see Record).
+        time_t last = 0;   // Last open.
+    };
+
+    // Once the ranks add up to more than this, all of them are aged by 10%
+    // and projects that fall below 1 are forgotten, so the log stays small
+    // and old habits fade.
+    constexpr double MAX_TOTAL_RANK = 1000;
+    // The top hit is opened without asking when it leads by this many points.
+    constexpr int CLEAR_LEAD = 15;
+    constexpr size_t MAX_CANDIDATES = 10;
+
+    inline fs::path LogPath()
+    {
+        return fs::path(Main::HOME_PATH + Main::CACHE_PATH) / "frecency";
+    }
+
+    // One "rank<TAB>last<TAB>name" line per project.
+    inline std::map<std::string, Access> Load()
+    {
+        std::map<std::string, Access> log;
+        std::ifstream in(LogPath());
+        std::string line;
+        while (std::getline(in, line))
+        {
+            std::istringstream fields(line);
+            Access access;
+            std::string name;
+            if (fields >> access.rank >> access.last && fields.get() == '\t' && std::getline(fields, name) && !name.empty())
+                log[name] = access;
+        }
+        return log;
+    }
+
+    // Write through a temporary file so a concurrent reader never sees half a log.
+    inline void Save(const std::map<std::string, Access> &log)
+    {
+        fs::path path = LogPath();
+        std::error_code ec;
+        fs::create_directories(path.parent_path(), ec);
+        std::ostringstream out;
+        for (const auto &[name, access] : log)
+            out << access.rank << '\t' << access.last << '\t' << name << '\n';
+        Binary::WriteAtomic(path.string(), out.str());
+    }
+
+    inline void Record(const std::string &name)
+    {
+        std::map<std::string, Access> log = Load();
+        Access &access = log[name];
+        access.rank += 1;
+        access.last = std::time(nullptr);
+
+        double total = 0;
+        for (const auto &entry : log)
+            total += entry.second.rank;
+        for (auto it = log.begin(); it != log.end();)
+        {
+            DevCore::Project proj;
+            bool known = DevCore::FindProject(it->first, proj);
+            if (total > MAX_TOTAL_RANK)
+                it->second.rank *= 0.9;
+            it = (!known || it->second.rank < 1) ? log.erase(it) : std::next(it);
+        }
+        Save(log);
+    }
+
+    // Rank weighted by the age of the last open.
+    inline double Frecency(const Access &access, time_t now)
+    {
+        time_t age = now - access.last;
+        double weight = age < 3600 ? 4 : age < 86400 ? 2 : age < 7 * 86400 ? 0.5 : 0.25;
+        return access.rank * weight;
+    }
+
+    // Start of a word: after a separator or at a lower to upper case step.
+    inline bool IsBoundary(const std::string &text, size_t i)
+    {
+        if (i == 0)
+            return true;
+        unsigned char previous = text[i - 1], current = text[i];
+        return !std::isalnum(previous) || (std::islower(previous) && std::isupper(current));
+    }
+
+    // How well a query matches a name, from 100 (exact) down to 1, or -1
+    // when the query characters do not all appear in order. Case is ignored.
+    inline int MatchScore(const std::string &query, const std::string &name)
+    {
+        if (query.empty())
+            return 0;
+        std::string q = Strings::Lower(query), n = Strings::Lower(name);
+        if (q == n)
+            return 100;
+        if (n.rfind(q, 0) == 0)
+            return 80 + static_cast<int>(19 * q.size() / n.size());
+        size_t at = n.find(q);
+        if (at != std::string::npos)
+            return (IsBoundary(name, at) ? 70 : 60) + static_cast<int>(9 * q.size() / n.size());
+
+        // Subsequence: a point per character, one more for following the
+        // previous match directly and one for starting a word.
+        int points = 0;
+        size_t previous = std::string::npos;
+        size_t i = 0;
+        for (char c : q)
+        {
+            while (i < n.size() && n[i] != c)
+                i++;
+            if (i == n.size())
+                return -1;
+            points += 1 + (previous != std::string::npos && i == previous + 1) + IsBoundary(name, i);
+            previous = i++;
+        }
+        return 10 + 40 * points / static_cast<int>(3 * q.size());
+    }
+
+    struct Candidate
+    {
+        size_t project;     // Index into the ranked projects.
+        int match;          // MatchScore of the best matching name.
+        double frecency;
+        double score;
+    };
+
+    // Matching projects, best first. Frecency adds up to 40 points, growing
+    // logarithmically so a favourite cannot outweigh a much better match.
+    inline std::vector<Candidate> Rank(const std::vector<DevCore::Project> &projects, const std::string &query)
+    {
+        std::map<std::string, Access> log = Load();
+        time_t now = std::time(nullptr);
+        std::vector<Candidate> candidates;
+        for (size_t p = 0; p < projects.size(); p++)
+        {
+            const DevCore::Project &proj = projects[p];
+            int match = std::max(MatchScore(query, proj.name), MatchScore(query, proj.folderName));
+            if (match < 0)
+                continue;
+            auto it = log.find(proj.name);
+            double frecency = it == log.end() ? 0 : Frecency(it->second, now);
+            double score = match + std::min(40.0, 10 * std::log2(1 + frecency));
+            candidates.push_back({p, match, frecency, score});
+        }
+        // An exact name always comes first, whatever the frecency of the rest.
+        std::sort(candidates.begin(), candidates.end(), [&](const Candidate &a, const Candidate &b) {
+            if ((a.match == 100) != (b.match == 100))
+                return a.match == 100;
+            if (a.score != b.score)
+                return a.score > b.score;
+            return projects[a.project].name < projects[b.project].name;
+        });
+        return candidates;
+    }
+
+    // The top candidate is taken without asking when it is the only one, the
+    // only exact match, or leads the next one clearly.
+    inline bool IsClearWinner(const std::vector<Candidate> &candidates, const std::string &query)
+    {
+        if (candidates.size() == 1)
+            return true;
+        if (query.empty())
+            return false;
+        if (candidates[0].match == 100 && candidates[1].match < 100)
+            return true;
+        return candidates[0].score - candidates[1].score >= CLEAR_LEAD;
+    }
+
+    inline int Run(const std::string &query)
+    {
+        std::vector<DevCore::Project> projects = DevCore::Projects();
+        std::vector<Candidate> candidates = Rank(projects, query);
+        if (candidates.empty())
+        {
+            if (query.empty())
+                Canvas::PrintInfo("No projects found.");
+            else
+                Canvas::PrintError("No project matches '" + query + "'.");
+            return 1;
+        }
+
+        size_t chosen = candidates[0].project;
+        if (!IsClearWinner(candidates, query))
+        {
+            if (candidates.size() > MAX_CANDIDATES)
+                candidates.resize(MAX_CANDIDATES);
+            std::vector<std::vector<std::string>> rows;
+            for (size_t i = 0; i < candidates.size(); i++)
+            {
+                const DevCore::Project &proj = projects[candidates[i].project];
+                rows.push_back({std::to_string(i + 1), proj.name, proj.lang, proj.lastActivity ? Strings::FormatTime(proj.lastActivity) : ""});
+            }
+            Canvas::PrintTable(" Projects ", {"#", "Project", "Language", "Last activity"}, rows, Canvas::Color::CYAN);
+
+            std::string answer = Canvas::GetStringInput(u8"👉 Which project do you want to open? (number, Enter for 1) ");
+            uint64_t choice = 1;
+            if (!answer.empty() && (!Strings::ParseCount(answer, choice, candidates.size()) || choice == 0))
+            {
+                Canvas::PrintError("Invalid choice '" + answer + "': enter a number between 1 and " + std::to_string(candidates.size()) + ".");
+                return 1;
+            }
+            chosen = candidates[choice - 1].project;
+        }
+
+        const DevCore::Project &proj = projects[chosen];
+        Record(proj.name);
+        if (!Editor::Open(proj.path))
+            return 1;
+        Canvas::PrintSuccess("Opened " + proj.name + ".");
+        return 0;
+    }
+} // namespace Open
+
+#endif // OPEN_HPP
@@ -0,0 +1,58 @@
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace Parallel
+{
+    // Number of worker threads to use for a given amount of work items.
+    // Never returns more threads than there is work, and at least one.
+    inline unsigned ThreadCount(size_t work, unsigned limit = 0)
+    {
+        unsigned threads = std::thread::hardware_concurrency();
+        if (threads == 0)
+            threads = 4;
+        if (limit > 0 && threads > limit)
+            threads = limit;
+        if (work < threads)
+            threads = static_cast<unsigned>(work);
+        return threads == 0 ? 1 : threads;
+    }
+
+    // Run fn(i) for every i in [0, count) on a pool of threads.
+    // Work items are handed out one at a time from a shared counter, so a few
+    // slow items (huge projects) do not stall the remaining threads.
+    template <typename Fn>
+    inline void ForEach(size_t count, Fn &&fn, unsigned limit = 0)
+    {
+        if (count == 0)
+            return;
+
+        unsigned threads = ThreadCount(count, limit);
+        if (threads == 1)
+        {
+            for (size_t i = 0; i < count; i++)
+                fn(i);
+            return;
+        }
+
+        std::atomic<size_t> next{0};
+        auto worker = [&]() {
+            for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1))
+                fn(i);
+        };
+
+        std::vector<std::thread> pool;
+        pool.reserve(threads - 1);
+        for (unsigned t = 1; t < threads; t++)
+            pool.emplace_back(worker);
+        worker();
+        for (auto &thread : pool)
+            thread.join();
+    }
+} // namespace Parallel
+
+#endif // PARALLEL_HPP
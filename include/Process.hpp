@@ -0,0 +1,366 @@
+#ifndef PROCESS_HPP
+#define PROCESS_HPP
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <cerrno>
+#include <csignal>
+#include <poll.h>
+#include <spawn.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/syscall.h>
+
+extern char **environ;
+
+// Spawning of external programs with argument vectors (no shell involved).
+// Execute runs one program (capture, log file, timeout, environment,
+// working directory, or detached without waiting) and ExecuteAll runs many
+// with a concurrency limit.
+namespace Process
+{
+    // I/O scheduling classes understood by the Linux ioprio_set syscall.
+    enum class IoClass { DEFAULT = 0, REALTIME = 1, BEST_EFFORT = 2, IDLE = 3 };
+
+    const int IOPRIO_WHO_PROCESS = 1;
+    const int IOPRIO_CLASS_SHIFT = 13;
+
+    // The raw I/O priority of the calling thread (as ioprio_get returns it),
+    // or -1 when it cannot be read.
+    inline int GetIoPriority()
+    {
+    #ifdef SYS_ioprio_get
+        return static_cast<int>(syscall(SYS_ioprio_get, IOPRIO_WHO_PROCESS, 0));
+    #else
+        return -1;
+    #endif
+    }
+
+    // Set the raw I/O priority of the calling thread, e.g. to restore what
+    // GetIoPriority returned.
+    inline bool SetIoPriority(int prio)
+    {
+    #ifdef SYS_ioprio_set
+        if (prio < 0)
+            return false;
+        // The "none" class takes no level.
+        if ((prio >> IOPRIO_CLASS_SHIFT) == 0)
+            prio = 0;
+        return syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, 0, prio) == 0;
+    #else
+        (void)prio;
+        return false;
+    #endif
+    }
+
+    // Set the I/O priority of the calling thread. Children spawned from this
+    // thread afterwards inherit it, which keeps background jobs from starving
+    // interactive disk access.
+    inline bool SetIoPriority(IoClass ioClass, int level = 7)
+    {
+        return SetIoPriority((static_cast<int>(ioClass) << IOPRIO_CLASS_SHIFT) | (level & 7));
+    }
+
+    // Parse an I/O class name from the config ("idle", "best-effort", "realtime", "none").
+    inline IoClass ParseIoClass(const std::string &name)
+    {
+        if (name == "idle")
+            return IoClass::IDLE;
+        if (name == "best-effort" || name == "be")
+            return IoClass::BEST_EFFORT;
+        if (name == "realtime" || name == "rt")
+            return IoClass::REALTIME;
+        return IoClass::DEFAULT;
+    }
+
+    // The environment of this process with the NAME=value entries of overrides
+    // added, replacing existing entries of the same name.
+    inline std::vector<std::string> Environment(const std::vector<std::string> &overrides)
+    {
+        std::vector<std::string> env;
+        for (char **entry = environ; *entry; entry++)
+        {
+            std::string value = *entry;
+            std::string name = value.substr(0, value.find('='));
+            bool replaced = false;
+            for (const auto &override : overrides)
+                replaced = replaced || override.compare(0, name.size() + 1, name + "=") == 0;
+            if (!replaced)
+                env.push_back(value);
+        }
+        env.insert(env.end(), overrides.begin(), overrides.end());
+        return env;
+    }
+
+    // Wait for a spawned child and return its exit code (-1 when it did not exit normally).
+    inline int Wait(pid_t pid)
+    {
+        int status = 0;
+        while (waitpid(pid, &status, 0) < 0)
+        {
+            if (errno != EINTR)
+                return -1;
+        }
+        return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    }
+
+    struct Options
+    {
+        std::vector<std::string> env; // NAME=value entries added to (or replacing) our environment.
+        std::string directory;        // Working directory of the child, if not ours.
+        bool captureOut = false;      // Collect stdout in Result::out instead of passing it through.
+        bool captureErr = false;      // Collect stderr in Result::err.
+        bool quiet = false;           // Send stdout and stderr that are not captured to /dev/null.
+        bool closeInput = false;      // Read stdin from /dev/null.
+        std::string logFile;          // Write stdout and stderr that are not captured to this file (truncated).
+        bool detached = false;        // Start in a new session with stdio on /dev/null and do not wait.
+        double timeout = 0;           // Seconds until the child is killed; 0 waits for ever. Not with detached.
+        std::vector<int> inheritFds;  // Close-on-exec descriptors this child (and only this one) keeps open.
+    };
+
+    struct Result
+    {
+        int exitCode = -1;     // -1 when it did not start, did not exit normally or timed out; 0 once a detached child started.
+        int error = 0;         // errno when it did not start.
+        bool timedOut = false;
+        std::string out;
+        std::string err;
+        double seconds = 0;
+    };
+
+    // Run a program (argv[0] looked up in PATH, no shell) and wait for it.
+    // Captured streams are drained together so a full pipe cannot block the
+    // child. With a timeout the child gets its own process group, so killing
+    // it also stops whatever it started (make, compilers, ...). A detached
+    // child survives the terminal closing; nothing waits for it.
+    inline Result Execute(const std::vector<std::string> &argv, const Options &options = Options())
+    {
+        Result result;
+        auto start = std::chrono::steady_clock::now();
+        if (argv.empty())
+        {
+            result.error = EINVAL;
+            return result;
+        }
+
+        std::vector<char *> args, envp;
+        for (const auto &arg : argv)
+            args.push_back(const_cast<char *>(arg.c_str()));
+        args.push_back(nullptr);
+        std::vector<std::string> env;
+        if (!options.env.empty())
+        {
+            env = Environment(options.env);
+            for (const auto &entry : env)
+                envp.push_back(const_cast<char *>(entry.c_str()));
+            envp.push_back(nullptr);
+        }
+
+        int pipes[2][2] = {{-1, -1}, {-1, -1}};
+        std::string *targets[2] = {options.captureOut && !options.detached ? &result.out : nullptr,
+                                   options.captureErr && !options.detached ? &result.err : nullptr};
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        if (options.closeInput || options.detached)
+            posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+        for (int i = 0; i < 2; i++)
+        {
+            int fd = i == 0 ? STDOUT_FILENO : STDERR_FILENO;
+            if (targets[i] && pipe2(pipes[i], O_CLOEXEC) == 0)
+                posix_spawn_file_actions_adddup2(&actions, pipes[i][1], fd);
+            else if (!targets[i] && !options.logFile.empty() && !options.detached)
+            {
+                // stderr joins stdout in the log unless stdout is captured.
+                if (i == 0 || targets[0])
+                    posix_spawn_file_actions_addopen(&actions, fd, options.logFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+                else
+                    posix_spawn_file_actions_adddup2(&actions, STDOUT_FILENO, STDERR_FILENO);
+            }
+            else if (targets[i] || options.quiet || options.detached)
+                posix_spawn_file_actions_addopen(&actions, fd, "/dev/null", O_WRONLY, 0);
+        }
+        // dup2 of a descriptor onto itself clears its close-on-exec flag in
+        // the child only (POSIX.1-2024, glibc 2.29).
+        for (int fd : options.inheritFds)
+            posix_spawn_file_actions_adddup2(&actions, fd, fd);
+        if (!options.directory.empty())
+            posix_spawn_file_actions_addchdir_np(&actions, options.directory.c_str());
+
+        posix_spawnattr_t attributes;
+        posix_spawnattr_init(&attributes);
+        if (options.detached)
+        {
+        #ifdef POSIX_SPAWN_SETSID
+            posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETSID);
+        #endif
+        }
+        else if (options.timeout > 0)
+        {
+            posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETPGROUP);
+            posix_spawnattr_setpgroup(&attributes, 0);
+        }
+
+        pid_t pid;
+        int spawnErr = posix_spawnp(&pid, args[0], &actions, &attributes, args.data(), envp.empty() ? environ : envp.data());
+        posix_spawnattr_destroy(&attributes);
+        posix_spawn_file_actions_destroy(&actions);
+        for (auto &fds : pipes)
+        {
+            if (fds[1] >= 0)
+                close(fds[1]);
+        }
+        if (options.detached)
+        {
+            result.error = spawnErr;
+            result.exitCode = spawnErr == 0 ? 0 : -1;
+            result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            return result;
+        }
+
+        auto deadline = options.timeout > 0
+                            ? start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(options.timeout))
+                            : std::chrono::steady_clock::time_point::max();
+        // Milliseconds left until the deadline, or -1 without a timeout.
+        auto remaining = [&]() -> int {
+            if (options.timeout <= 0)
+                return -1;
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+            return left > 0 ? static_cast<int>(left) : 0;
+        };
+
+        int status = 0;
+        bool reaped = false;
+        char buffer[65536];
+        while (spawnErr == 0 && !result.timedOut)
+        {
+            pollfd fds[2];
+            int count = 0;
+            std::string *sinks[2];
+            for (int i = 0; i < 2; i++)
+            {
+                if (pipes[i][0] >= 0)
+                {
+                    fds[count] = {pipes[i][0], POLLIN, 0};
+                    sinks[count++] = targets[i];
+                }
+            }
+            if (count == 0 && options.timeout <= 0)
+                break;
+            if (count == 0)
+            {
+                // Nothing to read: check on the child until the deadline.
+                pid_t done = waitpid(pid, &status, WNOHANG);
+                if (done == pid || (done < 0 && errno != EINTR))
+                {
+                    reaped = done == pid;
+                    break;
+                }
+                if (remaining() == 0)
+                    result.timedOut = true;
+                else
+                    std::this_thread::sleep_for(std::chrono::milliseconds(std::min(10, remaining())));
+                continue;
+            }
+            int ready = poll(fds, count, remaining());
+            if (ready < 0 && errno == EINTR)
+                continue;
+            if (ready == 0)
+            {
+                result.timedOut = true;
+                break;
+            }
+            if (ready < 0)
+                break;
+            for (int i = 0; i < count; i++)
+            {
+                if (!fds[i].revents)
+                    continue;
+                ssize_t got = read(fds[i].fd, buffer, sizeof(buffer));
+                if (got > 0)
+                    sinks[i]->append(buffer, static_cast<size_t>(got));
+                else if (got == 0 || errno != EINTR)
+                {
+                    for (auto &pair : pipes)
+                    {
+                        if (pair[0] == fds[i].fd)
+                        {
+                            close(pair[0]);
+                            pair[0] = -1;
+                        }
+                    }
+                }
+            }
+        }
+        for (auto &fds : pipes)
+        {
+            if (fds[0] >= 0)
+                close(fds[0]);
+        }
+
+        if (spawnErr != 0)
+            result.error = spawnErr;
+        else if (result.timedOut)
+        {
+            kill(-pid, SIGKILL);
+            Wait(pid);
+        }
+        else if (reaped)
+            result.exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+        else
+            result.exitCode = Wait(pid);
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return result;
+    }
+
+    // Execute every command with at most limit of them running at once.
+    // The workers only wait on their child, so the limit is not tied to the
+    // number of cores. Results are in the order of the commands.
+    inline std::vector<Result> ExecuteAll(const std::vector<std::vector<std::string>> &commands, const Options &options, size_t limit)
+    {
+        std::vector<Result> results(commands.size());
+        std::atomic<size_t> next{0};
+        auto worker = [&]() {
+            for (size_t i = next++; i < commands.size(); i = next++)
+                results[i] = Execute(commands[i], options);
+        };
+        size_t threads = std::min(std::max<size_t>(limit, 1), commands.size());
+        std::vector<std::thread> pool;
+        for (size_t t = 1; t < threads; t++)
+            pool.emplace_back(worker);
+        worker();
+        for (auto &thread : pool)
+            thread.join();
+        return results;
+    }
+
+    // Run a program and collect its stdout and stderr (either may be null to
+    // pass that stream through). Returns the exit code, or -1.
+    inline int Capture(const std::vector<std::string> &argv, std::string *out, std::string *err)
+    {
+        Options options;
+        options.captureOut = out != nullptr;
+        options.captureErr = err != nullptr;
+        Result result = Execute(argv, options);
+        if (out)
+            *out = std::move(result.out);
+        if (err)
+            *err = std::move(result.err);
+        return result.exitCode;
+    }
+
+    // Run a program and wait for it to finish. When quiet is set, its
+    // stdout and stderr go to /dev/null.
+    inline int Run(const std::vector<std::string> &argv, bool quiet = false)
+    {
+        Options options;
+        options.quiet = quiet;
+        return Execute(argv, options).exitCode;
+    }
+} // namespace Process
+
+#endif // PROCESS_HPP
@@ -0,0 +1,512 @@
+#ifndef PROJECTS_HPP
+#define PROJECTS_HPP
+
+#include "../dependencies/Canvas.hpp"
+#include "DevCore.hpp"
+#include "Editor.hpp"
+#include "Graph.hpp"
+#include "Main.hpp"
+#include "Strings.hpp"
+#include <string>
+#include <filesystem>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <set>
+#include <map>
+#include <algorithm>
+
+namespace fs = std::filesystem;
+
+// The terminal side of the project commands: tables, wizards and prompts.
+// The projects themselves are read and changed through DevCore.hpp.
+namespace Projects
+{
+    // Columns of the project table: the short listing, or every detail.
+    inline std::vector<std::string> Header(bool extra)
+    {
+        if (!extra)
+            return {"Created By", "Name", "Language"};
+        return {"Created By", "Name", "Folder", "Language", "Created At", "Size", "Files", "Lines", "Last Activity", "Git", "Branch", "Last Commit", "Dirty"};
+    }
+
+    inline std::vector<std::string> Row(const DevCore::Project &proj, bool extra)
+    {
+        if (!extra)
+            return {proj.createdBy, proj.name, proj.lang};
+        return {proj.createdBy,
+                proj.name,
+                proj.folderName,
+                proj.lang,
+                Strings::FormatTime(proj.createdAt),
+                std::to_string(proj.size),
+                std::to_string(proj.fileCount),
+                std::to_string(proj.lines),
+                proj.lastActivity ? Strings::FormatTime(proj.lastActivity) : "-",
+                proj.usesGit ? "Yes" : "No",
+                proj.usesGit ? proj.gitBranch : "-",
+                proj.lastCommit ? Strings::FormatTime(proj.lastCommit) : "-",
+                proj.usesGit ? (proj.gitDirty ? "Yes" : "No") : "-"};
+    }
+
+    inline void ListProjects(bool extra = false)
+    {
+        std::vector<std::vector<std::string>> rows;
+        for (const auto &proj : DevCore::Projects())
+            rows.push_back(Row(proj, extra));
+        // Display the table with the default color.
+        Canvas::PrintTable(" Projects ", Header(extra), rows, Canvas::Color::CYAN);
+    }
+
+    inline void ListUsers()
+    {
+        std::vector<std::vector<std::string>> rows;
+        for (const auto &user : DevCore::Users())
+            rows.push_back({user});
+        Canvas::PrintTable("", {"Users"}, rows, Canvas::Color::CYAN);
+    }
+
+    inline void ListTemplates()
+    {
+        std::vector<std::vector<std::string>> rows;
+        for (const auto &name : DevCore::Templates())
+            rows.push_back({name});
+        Canvas::PrintTable("", {"Templates"}, rows, Canvas::Color::CYAN);
+    }
+
+    inline void ListLanguages()
+    {
+        std::vector<std::vector<std::string>> rows;
+        for (const auto &lang : DevCore::Languages())
+            rows.push_back({lang});
+        Canvas::PrintTable("", {"Languages   "}, rows, Canvas::Color::CYAN);
+    }
+
+    inline bool HasLanguage(const std::string &lang)
+    {
+        std::vector<std::string> languages = DevCore::Languages();
+        return std::find(languages.begin(), languages.end(), lang) != languages.end();
+    }
+
+    inline void CreateLang(const std::string &lang)
+    {
+        if (DevCore::CreateLanguage(lang))
+            Canvas::PrintInfo("DevMap updated successfully.");
+    }
+
+    inline void DeleteLanguage(const std::string &lang)
+    {
+        if (DevCore::DeleteLanguage(lang))
+            Canvas::PrintInfo("DevMap updated successfully.");
+    }
+
+    // Print the files matching a glob from the filename index, grouped by project.
+    inline void FindFiles(const std::string &glob)
+    {
+        fs::path projectsPath = DevCore::ProjectsPath();
+        std::vector<DevCore::FileMatch> matches = DevCore::FindFiles(glob);
+        std::string current;
+        for (const auto &match : matches)
+        {
+            if (match.folder != current)
+            {
+                current = match.folder;
+                Canvas::PrintColoredLine(Canvas::BoldText(match.project) + Canvas::ColorToAnsi(Canvas::Color::CYAN) + " (" + current + ")", Canvas::Color::CYAN);
+            }
+            std::cout << "  " << (projectsPath / current / match.path).string() << "\n";
+        }
+        std::cout << std::flush;
+        Canvas::PrintInfo(std::to_string(matches.size()) + " of " + std::to_string(DevCore::IndexedFileCount()) + " indexed files match '" + glob + "'.");
+    }
+
+    // Print the lines of code per language of one project, or of all projects
+    // when name is empty.
+    inline void ShowStats(const std::string &name)
+    {
+        std::vector<std::map<std::string, DevCore::LineCounts>> counts;
+        if (!DevCore::CountLines(&counts))
+            return;
+        std::vector<DevCore::Project> projects = DevCore::Projects();
+        std::map<std::string, DevCore::LineCounts> totals;
+        bool found = name.empty();
+        for (size_t i = 0; i < projects.size() && i < counts.size(); i++)
+        {
+            if (!name.empty() && projects[i].name != name)
+                continue;
+            found = true;
+            for (const auto &entry : counts[i])
+            {
+                DevCore::LineCounts &total = totals[entry.first];
+                total.files += entry.second.files;
+                total.code += entry.second.code;
+                total.comment += entry.second.comment;
+                total.blank += entry.second.blank;
+            }
+        }
+        if (!found)
+        {
+            Canvas::PrintError("Project '" + name + "' does not exist.");
+            return;
+        }
+
+        std::vector<std::pair<std::string, DevCore::LineCounts>> sorted(totals.begin(), totals.end());
+        std::sort(sorted.begin(), sorted.end(), [](const auto &a, const auto &b) { return a.second.code > b.second.code; });
+        DevCore::LineCounts sum;
+        std::vector<std::vector<std::string>> rows;
+        for (const auto &entry : sorted)
+        {
+            const DevCore::LineCounts &c = entry.second;
+            rows.push_back({entry.first, std::to_string(c.files), std::to_string(c.code), std::to_string(c.comment), std::to_string(c.blank)});
+            sum.files += c.files;
+            sum.code += c.code;
+            sum.comment += c.comment;
+            sum.blank += c.blank;
+        }
+        rows.push_back({"Total", std::to_string(sum.files), std::to_string(sum.code),
+                        std::to_string(sum.comment), std::to_string(sum.blank)});
+        Canvas::PrintTable(name.empty() ? " All projects " : " " + name + " ", {"Language", "Files", "Code", "Comment", "Blank"}, rows, Canvas::Color::CYAN);
+    }
+
+    // Proportional bar for a share in [0, 1]. Plain ASCII, so table columns
+    // (which are sized in bytes) stay aligned.
+    inline std::string ShareBar(double share, size_t width = 30)
+    {
+        size_t filled = std::min(width, static_cast<size_t>(share * width + 0.5));
+        return std::string(filled, '#') + std::string(width - filled, '.');
+    }
+
+    inline std::string SharePercent(uint64_t part, uint64_t total)
+    {
+        std::ostringstream ss;
+        ss << std::fixed << std::setprecision(1) << (total ? 100.0 * part / total : 0.0) << "%";
+        return ss.str();
+    }
+
+    // Disk usage of one project: its largest directories and files, straight
+    // from the data of the last scan (every command rescans on load). .git
+    // and build outputs appear as single directories; the files are the
+    // project's own, without ignored ones.
+    inline void DiskUsage(const DevCore::Project &proj)
+    {
+        Canvas::PrintInfo(proj.name + ": " + Strings::FormatSize(proj.size) + " in " + std::to_string(proj.fileCount) + " files and " +
+                          std::to_string(proj.dirCount) + " directories, " + Strings::FormatSize(proj.allocatedSize) + " allocated on disk.");
+
+        std::vector<std::vector<std::string>> rows;
+        for (const auto &dir : proj.largestDirs)
+            rows.push_back({dir.second + "/", Strings::FormatSize(dir.first), SharePercent(dir.first, proj.size), ShareBar(proj.size ? double(dir.first) / proj.size : 0)});
+        if (!rows.empty())
+            Canvas::PrintTable(" Largest directories ", {"Directory", "Size", "Share", ""}, rows, Canvas::Color::CYAN);
+
+        rows.clear();
+        for (const auto &file : proj.largestFiles)
+            rows.push_back({file.second, Strings::FormatSize(file.first), SharePercent(file.first, proj.size), ShareBar(proj.size ? double(file.first) / proj.size : 0)});
+        if (!rows.empty())
+            Canvas::PrintTable(" Largest files ", {"File", "Size", "Share", ""}, rows, Canvas::Color::CYAN);
+    }
+
+    // Treemap style breakdown of all projects: languages by total size, each
+    // followed by its projects, with bars relative to the grand total.
+    inline void DiskUsage()
+    {
+        std::vector<DevCore::Project> projects = DevCore::Projects();
+        std::map<std::string, std::vector<const DevCore::Project *>> byLanguage;
+        std::map<std::string, uint64_t> languageSize;
+        uint64_t total = 0;
+        for (const auto &proj : projects)
+        {
+            byLanguage[proj.lang].push_back(&proj);
+            languageSize[proj.lang] += proj.size;
+            total += proj.size;
+        }
+
+        std::vector<std::string> order;
+        for (const auto &entry : byLanguage)
+            order.push_back(entry.first);
+        std::sort(order.begin(), order.end(), [&](const std::string &a, const std::string &b) { return languageSize[a] > languageSize[b]; });
+
+        std::vector<std::vector<std::string>> rows;
+        for (const auto &lang : order)
+        {
+            uint64_t size = languageSize[lang];
+            rows.push_back({Canvas::BoldText(lang), Strings::FormatSize(size), SharePercent(size, total), ShareBar(total ? double(size) / total : 0)});
+            auto &members = byLanguage[lang];
+            std::sort(members.begin(), members.end(), [](const DevCore::Project *a, const DevCore::Project *b) { return a->size > b->size; });
+            for (const DevCore::Project *proj : members)
+                rows.push_back({"  " + proj->name, Strings::FormatSize(proj->size), SharePercent(proj->size, total), ShareBar(total ? double(proj->size) / total : 0)});
+        }
+        rows.push_back({Canvas::BoldText("Total"), Strings::FormatSize(total), "100.0%", ""});
+        Canvas::PrintTable(" Disk usage ", {"Language / Project", "Size", "Share", ""}, rows, Canvas::Color::CYAN);
+    }
+
+    // Show what a project depends on and which projects depend on it.
+    inline void ShowDependencies(const DevCore::Project &proj)
+    {
+        std::vector<DevCore::Project> projects = DevCore::Projects();
+        size_t index = 0;
+        while (index < projects.size() && projects[index].name != proj.name)
+            index++;
+        if (index == projects.size())
+            return;
+        std::vector<std::string> missing;
+        Graph::Dag dag = Graph::FromProjects(projects, missing);
+        std::set<size_t> upstream = Graph::Closure(dag.dependencies, {index});
+        std::set<size_t> downstream = Graph::Closure(dag.dependents, {index});
+
+        std::vector<std::vector<std::string>> rows;
+        for (size_t i : upstream)
+        {
+            if (i != index)
+            {
+                bool direct = std::find(dag.dependencies[index].begin(), dag.dependencies[index].end(), i) != dag.dependencies[index].end();
+                rows.push_back({projects[i].name, "Dependency", direct ? "Direct" : "Indirect"});
+            }
+        }
+        for (size_t i : downstream)
+        {
+            if (i != index)
+            {
+                bool direct = std::find(dag.dependents[index].begin(), dag.dependents[index].end(), i) != dag.dependents[index].end();
+                rows.push_back({projects[i].name, "Dependent", direct ? "Direct" : "Indirect"});
+            }
+        }
+        for (const auto &edge : missing)
+        {
+            if (edge.compare(0, proj.name.size() + 4, proj.name + " -> ") == 0)
+                rows.push_back({edge.substr(proj.name.size() + 4), "Dependency", "Missing"});
+        }
+        if (rows.empty())
+        {
+            Canvas::PrintInfo("'" + proj.name + "' has no dependencies and no dependents.");
+            return;
+        }
+        Canvas::PrintTable(" " + proj.name + " ", {"Project", "Relation", "Kind"}, rows, Canvas::Color::CYAN);
+    }
+
+    // Add (or remove) dependencies of a project. Additions that would create
+    // a cycle are refused.
+    inline bool EditDependencies(const DevCore::Project &proj, const std::vector<std::string> &names, bool add)
+    {
+        std::vector<std::string> dependencies = proj.dependencies;
+        for (const auto &name : names)
+        {
+            auto it = std::find(dependencies.begin(), dependencies.end(), name);
+            if (!add)
+            {
+                if (it == dependencies.end())
+                    Canvas::PrintWarning("'" + proj.name + "' does not depend on '" + name + "'.");
+                else
+                    dependencies.erase(it);
+            }
+            else if (it == dependencies.end())
+            {
+                dependencies.push_back(name);
+            }
+        }
+
+        if (!DevCore::SetDependencies(proj, dependencies))
+        {
+            Canvas::PrintError("Nothing was changed.");
+            return false;
+        }
+        if (!DevCore::Save())
+            return false;
+        Canvas::PrintSuccess("Updated the dependencies of '" + proj.name + "'.");
+        return true;
+    }
+
+    inline void CreateProjectWizard()
+    {
+        // Clear the console and print a vibrant title.
+        Canvas::ClearConsole();
+        Canvas::PrintTitle(u8"DevCore | Project Creation Wizard 🚀", Canvas::Color::MAGENTA);
+
+        // 1. Ask for the project language.
+        ListLanguages();
+        std::string projectLang = Canvas::GetStringInput(u8"👉 Please enter the project language: ", "", Canvas::Color::CYAN);
+        // Verify if the language exists; if not, offer to create it.
+        if (!HasLanguage(projectLang))
+        {
+            bool createLang = Canvas::GetBoolInput(u8"⚠️ Language '" + projectLang + "' not found. Create it? ", "", Canvas::Color::YELLOW);
+            if (!createLang)
+            {
+                Canvas::PrintInfo(u8"❌ Project creation cancelled. Please choose an existing language next time.");
+                return;
+            }
+            if (!DevCore::CreateLanguage(projectLang))
+                return;
+            Canvas::PrintSuccess(u8"Language '" + projectLang + "' created successfully!");
+        }
+
+        // 2. Ask for the project name.
+        std::string projectName = Canvas::GetStringInput(u8"📝 Enter your project name (spaces allowed): ", "", Canvas::Color::CYAN);
+
+        // 3. Determine the project folder name.
+        bool useNamingConvention = Canvas::GetBoolInput(u8"🔠 Use GitHub naming conventions for folder name? ", "", Canvas::Color::CYAN);
+        std::string projectFolderName;
+        if (useNamingConvention)
+        {
+            // Lower case, spaces to hyphens, and nothing but alphanumerics and hyphens.
+            projectFolderName = Strings::Lower(projectName);
+            std::replace(projectFolderName.begin(), projectFolderName.end(), ' ', '-');
+            projectFolderName.erase(std::remove_if(projectFolderName.begin(), projectFolderName.end(),
+                [](char c) { return !(std::isalnum(static_cast<unsigned char>(c)) || c == '-'); }), projectFolderName.end());
+            Canvas::PrintInfo(u8"📁 Using folder name: " + projectFolderName);
+        }
+        else
+        {
+            projectFolderName = Canvas::GetStringInput(u8"📁 Enter a custom project folder name: ", "", Canvas::Color::CYAN);
+        }
+
+        // 4. Ask if the project should be initialized as a Git repository.
+        bool initGit = Canvas::GetBoolInput(u8"🐙 Initialize as a Git repository? ", "", Canvas::Color::CYAN);
+
+        // 5. Ask if the user wants to use a project template.
+        std::string selectedTemplate;
+        if (Canvas::GetBoolInput(u8"🎨 Would you like to apply a project template? ", "", Canvas::Color::CYAN))
+        {
+            std::vector<std::string> templates = DevCore::Templates(projectLang);
+            if (templates.empty())
+            {
+                Canvas::PrintInfo(u8"📂 No templates available for '" + projectLang + "'. Skipping template.");
+            }
+            else
+            {
+                Canvas::PrintInfo(u8"✨ Available templates:");
+                for (size_t i = 0; i < templates.size(); i++)
+                    Canvas::PrintInfo(u8"  " + std::to_string(i + 1) + u8". " + templates[i]);
+                std::string templateChoice = Canvas::GetStringInput(u8"🔢 Enter template number (or press Enter to skip): ", "", Canvas::Color::CYAN);
+                if (!templateChoice.empty())
+                {
+                    size_t choice = 0;
+                    if (templateChoice.find_first_not_of("0123456789") == std::string::npos && templateChoice.size() < 10)
+                        choice = std::stoul(templateChoice);
+                    if (choice > 0 && choice <= templates.size())
+                    {
+                        selectedTemplate = templates[choice - 1];
+                        Canvas::PrintInfo(u8"🎉 Template '" + selectedTemplate + "' selected.");
+                    }
+                    else
+                    {
+                        Canvas::PrintInfo(u8"❌ Invalid choice. Skipping template.");
+                    }
+                }
+            }
+        }
+
+        // 6. Create the project: its folder, the template, the git
+        // repository and the DevMap entry.
+        if (!DevCore::CreateProject(projectName, projectLang, projectFolderName, selectedTemplate, initGit))
+        {
+            Canvas::PrintError(u8"❌ Project creation failed.");
+            return;
+        }
+        Canvas::PrintSuccess(u8"✅ Project '" + projectName + "' created successfully!");
+
+        // 7. Offer to open it right away.
+        if (Canvas::GetBoolInput(u8"🎨 Would you like to open this project in your editor? ", "", Canvas::Color::CYAN))
+        {
+            Editor::Open(fs::path(DevCore::ProjectsPath()) / projectLang / projectFolderName);
+        }
+    }
+
+    inline void DeleteProjectWizard()
+    {
+        // Clear the console and print a vibrant title.
+        Canvas::ClearConsole();
+        Canvas::PrintColoredLine(u8"*========== DevCore | Danger Zone | Project Deletion Wizard ❌ ==========*", Canvas::Color::RED);
+
+        // 1. List projects and ask for the project name to delete.
+        ListProjects(true);
+        std::string projectName = Canvas::GetStringInput(u8"👉 Please enter the project name you want to delete: ", "", Canvas::Color::CYAN);
+
+        DevCore::Project project;
+        if (!DevCore::FindProject(projectName, project) || !fs::exists(project.path))
+        {
+            Canvas::PrintError("You tried to delete '" + projectName + "'. No such project exists");
+            return;
+        }
+
+        // 2. Confirm deletion with the user.
+        Canvas::ClearConsole();
+        bool confirmation1 = Canvas::GetBoolInput(u8"🔥 Are you absolutely sure you want to delete '" + projectName + "' located at '" + Canvas::LinkText(project.path, Canvas::Color::RED) + "'?", "Delete Project Confirmation 1", Canvas::Color::RED);
+        Canvas::ClearConsole();
+        bool confirmation2 = Canvas::GetBoolInput(u8"🔥 Please confirm again: Delete '" + projectName + "' from '" + Canvas::LinkText(project.path, Canvas::Color::RED) + "'?", "Delete Project Confirmation 2", Canvas::Color::RED);
+        if (!confirmation1 || !confirmation2)
+        {
+            Canvas::PrintInfo(u8"Project deletion aborted.");
+            return;
+        }
+
+        // 3. Delete the folder and the DevMap entry.
+        if (DevCore::DeleteProject(project))
+            Canvas::PrintSuccess(u8"✅ Project '" + project.name + "' deleted successfully!");
+    }
+
+    inline void RemoveTemplate()
+    {
+        Canvas::ClearConsole();
+        ListTemplates();
+
+        std::string templateDir = Canvas::GetStringInput(u8"👉 Please enter a template listed above that you want to delete: ", "", Canvas::Color::CYAN);
+        size_t slash = templateDir.find('/');
+        if (slash == std::string::npos)
+        {
+            Canvas::PrintError("Templates are named '<language>/<template>', as listed above.");
+            return;
+        }
+        std::string delDir = Main::HOME_PATH + Main::TEMPLATE_PATH + "/" + templateDir;
+        Canvas::ClearConsole();
+        bool confirmation1 = Canvas::GetBoolInput(u8"🔥 Are you absolutely sure you want to delete '" + templateDir + "' located at '" + Canvas::LinkText(delDir, Canvas::Color::RED) + "'?", "Delete Template Confirmation 1", Canvas::Color::RED);
+        Canvas::ClearConsole();
+        bool confirmation2 = Canvas::GetBoolInput(u8"🔥 Please confirm again: Delete '" + templateDir + "' from '" + Canvas::LinkText(delDir, Canvas::Color::RED) + "'?", "Delete Template Confirmation 2", Canvas::Color::RED);
+        if (!confirmation1 || !confirmation2)
+        {
+            Canvas::PrintInfo(u8"Template deletion aborted.");
+            return;
+        }
+
+        if (DevCore::RemoveTemplate(templateDir.substr(0, slash), templateDir.substr(slash + 1)))
+            Canvas::PrintSuccess(u8"✅ Template '" + templateDir + "' deleted successfully!");
+    }
+
+    inline void AddTemplate()
+    {
+        Canvas::ClearConsole();
+        std::string name = Canvas::GetStringInput(u8"👉 Please enter a template name: ", "", Canvas::Color::CYAN);
+        std::string lang = Canvas::GetStringInput(u8"👉 Please enter the template language: ", "", Canvas::Color::CYAN);
+        std::string source = Canvas::GetStringInput(u8"👉 Please enter the template source folder path: ", "", Canvas::Color::CYAN);
+
+        if (!HasLanguage(lang))
+        {
+            Canvas::PrintWarning("The language does not exist yet, would you like to create it?");
+            if (!Canvas::GetBoolInput("   "))
+            {
+                Canvas::PrintInfo("Aborting template addition.");
+                return;
+            }
+            if (!DevCore::CreateLanguage(lang))
+                return;
+        }
+
+        if (DevCore::AddTemplate(lang, name, source))
+            Canvas::PrintSuccess("Succesfully added your template to the " + Canvas::LinkText(".config/devcore/templates", Canvas::Color::GREEN) + " directory.");
+    }
+
+    // Offer to create an empty DevMap when there is none yet.
+    inline bool Setup(const std::string &filename)
+    {
+        Canvas::ClearConsole();
+        Canvas::PrintTitle("DevCore | Setup Zone");
+        Canvas::PrintWarning("It seems like you do not yet have a DevMap file. You require the correct structure and we recommend you install the default one. Would you like to install the default (empty) DevMap? \n    If not, check out '" + Canvas::LinkText(filename, Canvas::Color::YELLOW) +
+                             "' to configure one manually, although this is not recommended!");
+        if (!Canvas::GetBoolInput("    ") || !DevCore::CreateDevMap(filename))
+            return false;
+        Canvas::PrintSuccess(Canvas::BoldText("Done installing the default DevMap.") +
+                             Canvas::ColorToAnsi(Canvas::Color::GREEN) +
+                             "\n    You can list and manage projects in your devmap by running several commands (see `devcore --help` for more info). \n    You can edit the devmap manually at '" +
+                             Canvas::LinkText(filename, Canvas::Color::GREEN) + "', however, this is not recommended!");
+        return true;
+    }
+} // namespace Projects
+
+#endif // PROJECTS_HPP
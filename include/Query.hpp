@@ -0,0 +1,803 @@
+#ifndef QUERY_HPP
+#define QUERY_HPP
+
+#include "../dependencies/Canvas.hpp"
+#include "DevCore.hpp"
+#include "Projects.hpp"
+#include "Strings.hpp"
+#include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <numeric>
+#include <sstream>
+#include <iomanip>
+#include <limits>
+#include <ctime>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+
+// `devcore list projects --where <query> --sort <keys> --limit <n>`: select a
+// slice of the DevMap without printing every project.
+//
+//   --where 'lang=C++ and size>100M and git'
+//   --where '(user=alice or user=bob) and not dirty and idle>30d'
+//   --sort -size,name --limit 20
+//
+// The query is compiled into a small plan over a columnar copy of the
+// DevMap: only the fields the query and the sort keys mention are copied,
+// each into one contiguous column, and every comparison runs as one pass
+// over its column into a row mask that `and`/`or`/`not` combine. With a
+// limit the selected rows are ordered with a partial sort, so only the top
+// n are ever fully sorted.
+namespace Query
+{
+    enum class Kind
+    {
+        Text,  // Compared as strings; ~ is a case-insensitive substring match.
+        Bytes, // Sizes with K, M, G, T suffixes (powers of 1024).
+        Count, // Counts with k, m suffixes (powers of 1000).
+        Time,  // Points in time, compared with dates (YYYY-MM-DD).
+        Age,   // Durations in seconds with s, m, h, d, w suffixes.
+        Flag   // Booleans: `git` alone means git=yes.
+    };
+
+    using Project = DevCore::Project;
+
+    struct Field
+    {
+        const char *name;
+        const char *title; // Column title, the same as in `devcore list-all projects`.
+        Kind kind;
+        std::string (*text)(const Project &);        // For Kind::Text.
+        int64_t (*number)(const Project &, time_t now); // For the other kinds.
+    };
+
+    const Field FIELDS[] = {
+        {"name", "Name", Kind::Text, [](const Project &p) { return p.name; }, nullptr},
+        {"folder", "Folder", Kind::Text, [](const Project &p) { return p.folderName; }, nullptr},
+        {"lang", "Language", Kind::Text, [](const Project &p) { return p.lang; }, nullptr},
+        {"user", "Created By", Kind::Text, [](const Project &p) { return p.createdBy; }, nullptr},
+        {"branch", "Branch", Kind::Text, [](const Project &p) { return p.gitBranch; }, nullptr},
+        {"size", "Size", Kind::Bytes, nullptr, [](const Project &p, time_t) { return int64_t(p.size); }},
+        {"allocated", "Allocated", Kind::Bytes, nullptr, [](const Project &p, time_t) { return int64_t(p.allocatedSize); }},
+        {"files", "Files", Kind::Count, nullptr, [](const Project &p, time_t) { return int64_t(p.fileCount); }},
+        {"dirs", "Dirs", Kind::Count, nullptr, [](const Project &p, time_t) { return int64_t(p.dirCount); }},
+        {"lines", "Lines", Kind::Count, nullptr, [](const Project &p, time_t) { return int64_t(p.lines); }},
+        {"deps", "Dependencies", Kind::Count, nullptr, [](const Project &p, time_t) { return int64_t(p.dependencies.size()); }},
+        {"created", "Created At", Kind::Time, nullptr, [](const Project &p, time_t) { return int64_t(p.createdAt); }},
+        {"activity", "Last Activity", Kind::Time, nullptr, [](const Project &p, time_t) { return int64_t(p.lastActivity); }},
+        {"commit", "Last Commit", Kind::Time, nullptr, [](const Project &p, time_t) { return int64_t(p.lastCommit); }},
+        {"build", "Last Build", Kind::Time, nullptr, [](const Project &p, time_t) { return int64_t(p.lastBuild); }},
+        // Time since the last activity (0 when unknown).
+        {"idle", "Idle", Kind::Age, nullptr, [](const Project &p, time_t now) { return int64_t(p.lastActivity ? now - p.lastActivity : 0); }},
+        {"git", "Git", Kind::Flag, nullptr, [](const Project &p, time_t) { return int64_t(p.usesGit); }},
+        {"dirty", "Dirty", Kind::Flag, nullptr, [](const Project &p, time_t) { return int64_t(p.usesGit && p.gitDirty); }},
+    };
+    const size_t FIELD_COUNT = sizeof(FIELDS) / sizeof(FIELDS[0]);
+
+    inline int FindField(const std::string &name)
+    {
+        for (size_t i = 0; i < FIELD_COUNT; i++)
+        {
+            if (name == FIELDS[i].name)
+                return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    inline std::string FieldNames()
+    {
+        std::string names;
+        for (size_t i = 0; i < FIELD_COUNT; i++)
+            names += (i ? ", " : "") + std::string(FIELDS[i].name);
+        return names;
+    }
+
+    // The fields of all projects, one column per field, copied on first use.
+    class Columns
+    {
+    public:
+        explicit Columns(const std::vector<Project> &projects)
+            : projects(projects), now(std::time(nullptr)), text(FIELD_COUNT), numbers(FIELD_COUNT), loaded(FIELD_COUNT, false) {}
+
+        size_t Rows() const { return projects.size(); }
+
+        const std::vector<std::string> &Text(int field)
+        {
+            Load(field);
+            return text[field];
+        }
+
+        const std::vector<int64_t> &Numbers(int field)
+        {
+            Load(field);
+            return numbers[field];
+        }
+
+    private:
+        const std::vector<Project> &projects;
+        time_t now;
+        std::vector<std::vector<std::string>> text;
+        std::vector<std::vector<int64_t>> numbers;
+        std::vector<bool> loaded;
+
+        void Load(int field)
+        {
+            if (loaded[field])
+                return;
+            loaded[field] = true;
+            const Field &info = FIELDS[field];
+            if (info.kind == Kind::Text)
+            {
+                text[field].reserve(projects.size());
+                for (const auto &proj : projects)
+                    text[field].push_back(info.text(proj));
+            }
+            else
+            {
+                numbers[field].reserve(projects.size());
+                for (const auto &proj : projects)
+                    numbers[field].push_back(info.number(proj, now));
+            }
+        }
+    };
+
+    using Mask = std::vector<uint8_t>;
+
+    enum class Op
+    {
+        Equal,
+        NotEqual,
+        Less,
+        LessEqual,
+        Greater,
+        GreaterEqual,
+        Contains
+    };
+
+    // A node of the compiled plan.
+    struct Node
+    {
+        enum Type
+        {
+            Compare,
+            And,
+            Or,
+            Not
+        } type = Compare;
+        int field = -1;
+        Op op = Op::Equal;
+        int64_t number = 0;
+        std::string text;
+        std::unique_ptr<Node> left, right;
+    };
+
+    // A slice of the projects: what --where, --sort and --limit asked for.
+    struct Plan
+    {
+        std::unique_ptr<Node> where;                // Null selects every project.
+        std::vector<std::pair<int, bool>> sortKeys; // Field and descending.
+        size_t limit = 0;                           // 0 for no limit.
+        std::vector<int> fields;                    // Fields mentioned, in order of appearance.
+    };
+
+    // Parses a --where expression:
+    //   expr    := term ("or" term)*
+    //   term    := factor ("and" factor)*
+    //   factor  := "not" factor | "(" expr ")" | field op value | field
+    //   op      := = != < <= > >= ~
+    class Parser
+    {
+    public:
+        Parser(const std::string &source, Plan &plan) : source(source), plan(plan) {}
+
+        std::unique_ptr<Node> Parse(std::string &error)
+        {
+            Next();
+            auto node = Expression();
+            if (node && token.type != Token::End)
+                Fail("Unexpected '" + token.text + "'");
+            error = this->error;
+            return this->error.empty() ? std::move(node) : nullptr;
+        }
+
+    private:
+        struct Token
+        {
+            enum Type
+            {
+                Word,
+                String,
+                Operator,
+                Open,
+                Close,
+                End
+            } type = End;
+            std::string text;
+            size_t column = 0;
+        };
+
+        const std::string &source;
+        Plan &plan;
+        size_t pos = 0;
+        Token token;
+        std::string error;
+
+        void Fail(const std::string &message)
+        {
+            if (error.empty())
+                error = message + " at column " + std::to_string(token.column + 1) + " of the query.";
+        }
+
+        static bool IsOperatorChar(char c)
+        {
+            return c == '=' || c == '!' || c == '<' || c == '>' || c == '~';
+        }
+
+        void Next()
+        {
+            while (pos < source.size() && std::isspace(static_cast<unsigned char>(source[pos])))
+                pos++;
+            token = Token();
+            token.column = pos;
+            if (pos >= source.size())
+                return;
+            char c = source[pos];
+            if (c == '(' || c == ')')
+            {
+                token.type = c == '(' ? Token::Open : Token::Close;
+                token.text = std::string(1, c);
+                pos++;
+            }
+            else if (c == '\'' || c == '"')
+            {
+                size_t end = source.find(c, pos + 1);
+                if (end == std::string::npos)
+                {
+                    token.type = Token::Word;
+                    token.text = source.substr(pos);
+                    pos = source.size();
+                    Fail("Unterminated string");
+                    return;
+                }
+                token.type = Token::String;
+                token.text = source.substr(pos + 1, end - pos - 1);
+                pos = end + 1;
+            }
+            else if (IsOperatorChar(c))
+            {
+                token.type = Token::Operator;
+                size_t start = pos++;
+                if (pos < source.size() && source[pos] == '=' && c != '=' && c != '~')
+                    pos++;
+                token.text = source.substr(start, pos - start);
+            }
+            else
+            {
+                token.type = Token::Word;
+                size_t start = pos;
+                while (pos < source.size() && !std::isspace(static_cast<unsigned char>(source[pos])) &&
+                       source[pos] != '(' && source[pos] != ')' && !IsOperatorChar(source[pos]))
+                    pos++;
+                token.text = source.substr(start, pos - start);
+            }
+        }
+
+        bool IsKeyword(const std::string &keyword) const
+        {
+            if (token.type != Token::Word || token.text.size() != keyword.size())
+                return false;
+            for (size_t i = 0; i < keyword.size(); i++)
+            {
+                if (std::tolower(static_cast<unsigned char>(token.text[i])) != keyword[i])
+                    return false;
+            }
+            return true;
+        }
+
+        std::unique_ptr<Node> Combine(Node::Type type, std::unique_ptr<Node> left, std::unique_ptr<Node> right)
+        {
+            auto node = std::make_unique<Node>();
+            node->type = type;
+            node->left = std::move(left);
+            node->right = std::move(right);
+            return node;
+        }
+
+        std::unique_ptr<Node> Expression()
+        {
+            auto node = Term();
+            while (node && IsKeyword("or"))
+            {
+                Next();
+                auto right = Term();
+                if (!right)
+                    return nullptr;
+                node = Combine(Node::Or, std::move(node), std::move(right));
+            }
+            return node;
+        }
+
+        std::unique_ptr<Node> Term()
+        {
+            auto node = Factor();
+            while (node && IsKeyword("and"))
+            {
+                Next();
+                auto right = Factor();
+                if (!right)
+                    return nullptr;
+                node = Combine(Node::And, std::move(node), std::move(right));
+            }
+            return node;
+        }
+
+        std::unique_ptr<Node> Factor()
+        {
+            if (IsKeyword("not"))
+            {
+                Next();
+                auto operand = Factor();
+                if (!operand)
+                    return nullptr;
+                return Combine(Node::Not, std::move(operand), nullptr);
+            }
+            if (token.type == Token::Open)
+            {
+                Next();
+                auto node = Expression();
+                if (!node)
+                    return nullptr;
+                if (token.type != Token::Close)
+                {
+                    Fail("Expected ')'");
+                    return nullptr;
+                }
+                Next();
+                return node;
+            }
+            if (token.type != Token::Word)
+            {
+                Fail(token.type == Token::End ? "Expected a field" : "Unexpected '" + token.text + "'");
+                return nullptr;
+            }
+            return Comparison();
+        }
+
+        std::unique_ptr<Node> Comparison()
+        {
+            int field = FindField(token.text);
+            if (field < 0)
+            {
+                Fail("Unknown field '" + token.text + "' (fields: " + FieldNames() + ")");
+                return nullptr;
+            }
+            if (std::find(plan.fields.begin(), plan.fields.end(), field) == plan.fields.end())
+                plan.fields.push_back(field);
+            auto node = std::make_unique<Node>();
+            node->field = field;
+            Next();
+
+            // A flag on its own: `git` is git=yes.
+            if (token.type != Token::Operator)
+            {
+                if (FIELDS[field].kind != Kind::Flag)
+                {
+                    Fail("Expected an operator after '" + std::string(FIELDS[field].name) + "'");
+                    return nullptr;
+                }
+                node->number = 1;
+                return node;
+            }
+
+            const std::string op = token.text;
+            if (op == "=")
+                node->op = Op::Equal;
+            else if (op == "!=")
+                node->op = Op::NotEqual;
+            else if (op == "<")
+                node->op = Op::Less;
+            else if (op == "<=")
+                node->op = Op::LessEqual;
+            else if (op == ">")
+                node->op = Op::Greater;
+            else if (op == ">=")
+                node->op = Op::GreaterEqual;
+            else if (op == "~")
+                node->op = Op::Contains;
+            else
+            {
+                Fail("Unknown operator '" + op + "'");
+                return nullptr;
+            }
+            Next();
+            if (token.type != Token::Word && token.type != Token::String)
+            {
+                Fail("Expected a value after '" + op + "'");
+                return nullptr;
+            }
+            if (!Value(*node))
+                return nullptr;
+            Next();
+            return node;
+        }
+
+        bool Value(Node &node)
+        {
+            const Field &field = FIELDS[node.field];
+            node.text = token.text;
+            if (field.kind == Kind::Text)
+                return true;
+            if (node.op == Op::Contains)
+            {
+                Fail("'~' only applies to text fields");
+                return false;
+            }
+            bool parsed = false;
+            switch (field.kind)
+            {
+            case Kind::Bytes:
+                parsed = ParseScaled(token.text, 1024, node.number);
+                break;
+            case Kind::Count:
+                parsed = ParseScaled(token.text, 1000, node.number);
+                break;
+            case Kind::Time:
+                parsed = ParseDate(token.text, node.number);
+                break;
+            case Kind::Age:
+                parsed = ParseAge(token.text, node.number);
+                break;
+            default:
+                parsed = ParseFlag(token.text, node.number);
+                break;
+            }
+            if (!parsed)
+            {
+                const char *expected[] = {"", "a size like 100M", "a number like 10k", "a date like 2024-01-31",
+                                          "a duration like 30d", "yes or no"};
+                Fail("'" + token.text + "' is not " + expected[static_cast<int>(field.kind)] + " for '" + field.name + "'");
+            }
+            return parsed;
+        }
+
+        // A number with an optional K, M, G or T suffix ("1.5G", "100MiB", "10k").
+        static bool ParseScaled(const std::string &text, double base, int64_t &value)
+        {
+            size_t used = 0;
+            double number;
+            try
+            {
+                number = std::stod(text, &used);
+            }
+            catch (...)
+            {
+                return false;
+            }
+            std::string suffix = text.substr(used);
+            for (auto &c : suffix)
+                c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            if (suffix == "b" || suffix == "ib")
+                suffix.clear();
+            else if (suffix.size() > 1 && (suffix.substr(1) == "b" || suffix.substr(1) == "ib"))
+                suffix = suffix.substr(0, 1);
+            const std::string units = "kmgt";
+            if (suffix.size() > 1 || (suffix.size() == 1 && units.find(suffix[0]) == std::string::npos))
+                return false;
+            if (!suffix.empty())
+                number *= std::pow(base, static_cast<double>(units.find(suffix[0]) + 1));
+            return ToInt64(number, value);
+        }
+
+        // Store a parsed amount, refusing what is negative, not finite ("nan",
+        // "inf") or too big for an int64_t, where the cast would be undefined.
+        static bool ToInt64(double number, int64_t &value)
+        {
+            // 2^63 is exact as a double; INT64_MAX itself is not.
+            const double limit = static_cast<double>(std::numeric_limits<int64_t>::max());
+            if (!std::isfinite(number) || number < 0 || number >= limit)
+                return false;
+            value = static_cast<int64_t>(number);
+            return true;
+        }
+
+        // A local date, optionally with a time: "2024-01-31" or "2024-01-31T14:30".
+        static bool ParseDate(const std::string &text, int64_t &value)
+        {
+            std::tm tm = {};
+            std::istringstream in(text);
+            in >> std::get_time(&tm, "%Y-%m-%d");
+            if (in.fail())
+                return false;
+            if (in.peek() == 'T')
+            {
+                in.get();
+                in >> std::get_time(&tm, "%H:%M");
+                if (in.fail())
+                    return false;
+            }
+            if (in.peek() != std::char_traits<char>::eof())
+                return false;
+            tm.tm_isdst = -1;
+            value = std::mktime(&tm);
+            return value != -1;
+        }
+
+        static bool ParseAge(const std::string &text, int64_t &value)
+        {
+            size_t used = 0;
+            double number;
+            try
+            {
+                number = std::stod(text, &used);
+            }
+            catch (...)
+            {
+                return false;
+            }
+            std::string suffix = text.substr(used);
+            double unit = 1;
+            if (suffix == "m")
+                unit = 60;
+            else if (suffix == "h")
+                unit = 3600;
+            else if (suffix == "d")
+                unit = 86400;
+            else if (suffix == "w")
+                unit = 7 * 86400;
+            else if (!suffix.empty() && suffix != "s")
+                return false;
+            return ToInt64(number * unit, value);
+        }
+
+        static bool ParseFlag(const std::string &text, int64_t &value)
+        {
+            if (text == "yes" || text == "true" || text == "1")
+                value = 1;
+            else if (text == "no" || text == "false" || text == "0")
+                value = 0;
+            else
+                return false;
+            return true;
+        }
+    };
+
+    // One pass over a column, the test chosen once outside the loop.
+    template <typename T, typename Test>
+    void Scan(const std::vector<T> &column, Mask &mask, Test test)
+    {
+        for (size_t i = 0; i < column.size(); i++)
+            mask[i] = test(column[i]);
+    }
+
+    template <typename T>
+    void CompareColumn(const std::vector<T> &column, Op op, const T &value, Mask &mask)
+    {
+        switch (op)
+        {
+        case Op::Equal:
+            Scan(column, mask, [&](const T &x) { return x == value; });
+            break;
+        case Op::NotEqual:
+            Scan(column, mask, [&](const T &x) { return x != value; });
+            break;
+        case Op::Less:
+            Scan(column, mask, [&](const T &x) { return x < value; });
+            break;
+        case Op::LessEqual:
+            Scan(column, mask, [&](const T &x) { return x <= value; });
+            break;
+        case Op::Greater:
+            Scan(column, mask, [&](const T &x) { return x > value; });
+            break;
+        case Op::GreaterEqual:
+            Scan(column, mask, [&](const T &x) { return x >= value; });
+            break;
+        default:
+            break;
+        }
+    }
+
+    inline Mask Evaluate(const Node &node, Columns &columns)
+    {
+        Mask mask(columns.Rows(), 0);
+        switch (node.type)
+        {
+        case Node::And:
+        case Node::Or:
+        {
+            Mask left = Evaluate(*node.left, columns);
+            Mask right = Evaluate(*node.right, columns);
+            for (size_t i = 0; i < mask.size(); i++)
+                mask[i] = node.type == Node::And ? (left[i] & right[i]) : (left[i] | right[i]);
+            break;
+        }
+        case Node::Not:
+        {
+            Mask operand = Evaluate(*node.left, columns);
+            for (size_t i = 0; i < mask.size(); i++)
+                mask[i] = !operand[i];
+            break;
+        }
+        case Node::Compare:
+            if (FIELDS[node.field].kind != Kind::Text)
+                CompareColumn(columns.Numbers(node.field), node.op, node.number, mask);
+            else if (node.op == Op::Contains)
+            {
+                std::string needle = Strings::Lower(node.text);
+                Scan(columns.Text(node.field), mask, [&](const std::string &x) { return Strings::Lower(x).find(needle) != std::string::npos; });
+            }
+            else
+                CompareColumn(columns.Text(node.field), node.op, node.text, mask);
+            break;
+        }
+        return mask;
+    }
+
+    // Parses the --sort keys: comma separated fields, '-' in front for
+    // descending order.
+    inline bool ParseSort(const std::string &keys, Plan &plan, std::string &error)
+    {
+        std::istringstream in(keys);
+        std::string key;
+        while (std::getline(in, key, ','))
+        {
+            bool descending = !key.empty() && key[0] == '-';
+            if (!key.empty() && (key[0] == '-' || key[0] == '+'))
+                key = key.substr(1);
+            int field = FindField(key);
+            if (field < 0)
+            {
+                error = "Unknown sort field '" + key + "' (fields: " + FieldNames() + ").";
+                return false;
+            }
+            plan.sortKeys.push_back({field, descending});
+            if (std::find(plan.fields.begin(), plan.fields.end(), field) == plan.fields.end())
+                plan.fields.push_back(field);
+        }
+        if (plan.sortKeys.empty())
+        {
+            error = "Expected sort fields after --sort.";
+            return false;
+        }
+        return true;
+    }
+
+    inline bool Compile(const std::string &where, const std::string &sort, size_t limit, Plan &plan, std::string &error)
+    {
+        plan.limit = limit;
+        if (!where.empty())
+        {
+            plan.where = Parser(where, plan).Parse(error);
+            if (!plan.where)
+                return false;
+        }
+        return sort.empty() || ParseSort(sort, plan, error);
+    }
+
+    // The indices of the selected projects, in order, at most plan.limit.
+    inline std::vector<size_t> Select(const Plan &plan, Columns &columns)
+    {
+        std::vector<size_t> rows;
+        if (plan.where)
+        {
+            Mask mask = Evaluate(*plan.where, columns);
+            for (size_t i = 0; i < mask.size(); i++)
+            {
+                if (mask[i])
+                    rows.push_back(i);
+            }
+        }
+        else
+        {
+            rows.resize(columns.Rows());
+            std::iota(rows.begin(), rows.end(), size_t(0));
+        }
+
+        size_t keep = plan.limit ? std::min(plan.limit, rows.size()) : rows.size();
+        if (!plan.sortKeys.empty())
+        {
+            // Load the sort columns before comparing, and keep ties in DevMap order.
+            for (const auto &key : plan.sortKeys)
+                FIELDS[key.first].kind == Kind::Text ? (void)columns.Text(key.first) : (void)columns.Numbers(key.first);
+            auto before = [&](size_t a, size_t b) {
+                for (const auto &key : plan.sortKeys)
+                {
+                    int order = 0;
+                    if (FIELDS[key.first].kind == Kind::Text)
+                    {
+                        const auto &column = columns.Text(key.first);
+                        order = column[a].compare(column[b]);
+                    }
+                    else
+                    {
+                        const auto &column = columns.Numbers(key.first);
+                        order = column[a] < column[b] ? -1 : column[a] > column[b];
+                    }
+                    if (order != 0)
+                        return key.second ? order > 0 : order < 0;
+                }
+                return a < b;
+            };
+            if (keep < rows.size())
+                std::partial_sort(rows.begin(), rows.begin() + keep, rows.end(), before);
+            else
+                std::sort(rows.begin(), rows.end(), before);
+        }
+        rows.resize(keep);
+        return rows;
+    }
+
+    inline std::string FormatAge(int64_t seconds)
+    {
+        if (seconds >= 86400)
+            return std::to_string(seconds / 86400) + "d";
+        if (seconds >= 3600)
+            return std::to_string(seconds / 3600) + "h";
+        return std::to_string(seconds / 60) + "m";
+    }
+
+    inline std::string Format(int field, size_t row, Columns &columns, const Project &proj)
+    {
+        const Field &info = FIELDS[field];
+        switch (info.kind)
+        {
+        case Kind::Text:
+            return columns.Text(field)[row];
+        case Kind::Bytes:
+            return Strings::FormatSize(static_cast<uint64_t>(columns.Numbers(field)[row]));
+        case Kind::Count:
+            return std::to_string(columns.Numbers(field)[row]);
+        case Kind::Time:
+        {
+            int64_t value = columns.Numbers(field)[row];
+            return value ? Strings::FormatTime(static_cast<time_t>(value)) : "-";
+        }
+        case Kind::Age:
+            return proj.lastActivity ? FormatAge(columns.Numbers(field)[row]) : "-";
+        default:
+            return columns.Numbers(field)[row] ? "Yes" : "No";
+        }
+    }
+
+    // Print the projects the options select: the usual columns and the
+    // fields the query and sort keys mention.
+    inline void ListProjects(const std::string &where, const std::string &sort, size_t limit, bool extra)
+    {
+        Plan plan;
+        std::string error;
+        if (!Compile(where, sort, limit, plan, error))
+        {
+            Canvas::PrintError(error);
+            return;
+        }
+        std::vector<Project> projects = DevCore::Projects();
+        Columns columns(projects);
+        std::vector<size_t> rows = Select(plan, columns);
+
+        std::vector<std::string> header = Projects::Header(extra);
+        std::vector<int> added;
+        for (int field : plan.fields)
+        {
+            if (std::find(header.begin(), header.end(), FIELDS[field].title) == header.end())
+            {
+                header.push_back(FIELDS[field].title);
+                added.push_back(field);
+            }
+        }
+        std::vector<std::vector<std::string>> table;
+        for (size_t row : rows)
+        {
+            std::vector<std::string> cells = Projects::Row(projects[row], extra);
+            for (int field : added)
+                cells.push_back(Format(field, row, columns, projects[row]));
+            table.push_back(cells);
+        }
+        Canvas::PrintTable(" Projects ", header, table, Canvas::Color::CYAN);
+        Canvas::PrintInfo(std::to_string(rows.size()) + " of " + std::to_string(projects.size()) + " projects.");
+    }
+} // namespace Query
+
+#endif // QUERY_HPP
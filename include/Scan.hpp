@@ -0,0 +1,307 @@
+#ifndef SCAN_HPP
+#define SCAN_HPP
+
+#include "Ignore.hpp"
+#include <string>
+#include <vector>
+#include <queue>
+#include <algorithm>
+#include <cstdint>
+#include <ctime>
+#include <fcntl.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+// Single pass project scan. Walk() visits every entry of a project once, with
+// one lstat per entry, and hands it to a list of visitors; every per-project
+// statistic is a visitor, so adding one never adds another filesystem pass.
+namespace Scan
+{
+    const size_t LARGEST_FILES = 10; // Number of largest (not ignored) files kept per project.
+    const size_t LARGEST_DIRS = 10;  // Number of largest directories kept per project.
+
+    // Build output directories. A directory with one of these names only
+    // counts as build output when one of its markers (the file of the build
+    // system that produces it) sits next to it; no markers means the name is
+    // enough on its own.
+    struct BuildOutput
+    {
+        std::string name;
+        std::vector<std::string> markers;
+    };
+    const std::vector<BuildOutput> BUILD_OUTPUTS{
+        {"build", {"Makefile", "CMakeLists.txt", "meson.build", "build.gradle", "build.gradle.kts", "setup.py", "pyproject.toml"}},
+        {"target", {"Cargo.toml", "pom.xml", "build.sbt"}},
+        {"node_modules", {"package.json"}},
+        {"__pycache__", {}},
+        {".gradle", {}},
+    };
+
+    // One directory entry. Entries inside ignored directories (.git, build
+    // outputs, .gitignore patterns) are still visited, with ignored set.
+    struct Entry
+    {
+        std::string path;     // Absolute path.
+        std::string relative; // Path inside the project ("src/main.cpp").
+        struct stat st;
+        int depth;            // 0 for entries directly in the project root.
+        bool ignored;
+        size_t parent;        // Id of the containing directory (0 is the project root).
+        size_t id;            // Id of a directory, in discovery order (parents before children).
+    };
+
+    struct Visitor
+    {
+        virtual ~Visitor() = default;
+        virtual void OnFile(const Entry &entry) = 0;
+        virtual void OnDirectory(const Entry &) {}
+    };
+
+    // Walk the project at root depth first and call every visitor for every
+    // regular file and directory. Symbolic links are not followed or counted.
+    inline void Walk(const std::string &root, const Ignore::Rules &rules, const std::vector<Visitor *> &visitors)
+    {
+        struct Pending
+        {
+            std::string path;
+            std::string relative;
+            int depth;
+            bool ignored;
+            size_t id;
+        };
+        std::vector<Pending> stack{{root, "", -1, false, 0}};
+        size_t nextId = 1;
+        Entry entry;
+        while (!stack.empty())
+        {
+            Pending dir = std::move(stack.back());
+            stack.pop_back();
+            DIR *handle = opendir(dir.path.c_str());
+            if (!handle)
+                continue;
+            int fd = dirfd(handle);
+            while (dirent *item = readdir(handle))
+            {
+                const char *name = item->d_name;
+                if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0')))
+                    continue;
+                if (fstatat(fd, name, &entry.st, AT_SYMLINK_NOFOLLOW) != 0)
+                    continue;
+                bool isDir = S_ISDIR(entry.st.st_mode);
+                if (!isDir && !S_ISREG(entry.st.st_mode))
+                    continue;
+
+                entry.path = dir.path + "/" + name;
+                entry.relative = dir.relative.empty() ? std::string(name) : dir.relative + "/" + name;
+                entry.depth = dir.depth + 1;
+                entry.ignored = dir.ignored || rules.Matches(entry.relative, isDir);
+                entry.parent = dir.id;
+                entry.id = isDir ? nextId++ : 0;
+                if (isDir)
+                {
+                    for (auto *visitor : visitors)
+                        visitor->OnDirectory(entry);
+                    stack.push_back({entry.path, entry.relative, entry.depth, entry.ignored, entry.id});
+                }
+                else
+                {
+                    for (auto *visitor : visitors)
+                        visitor->OnFile(entry);
+                }
+            }
+            closedir(handle);
+        }
+    }
+
+    // The statistics stored in the DevMap for every project.
+    struct Summary
+    {
+        uint64_t size = 0;      // Bytes in regular files.
+        uint64_t allocated = 0; // Bytes allocated on disk (sparse files, block rounding).
+        size_t files = 0;
+        size_t directories = 0;
+        time_t lastActivity = 0; // Newest mtime of a file that is not ignored.
+        bool hasGit = false;     // A .git directory or file in the project root.
+        std::vector<std::pair<uint64_t, std::string>> largest; // Largest files that are not ignored, biggest first.
+    };
+
+    struct SummaryVisitor : Visitor
+    {
+        Summary summary;
+        // Min-heap holding the LARGEST_FILES biggest files seen so far.
+        std::priority_queue<std::pair<uint64_t, std::string>, std::vector<std::pair<uint64_t, std::string>>, std::greater<>> heap;
+
+        void OnFile(const Entry &entry) override
+        {
+            uint64_t size = static_cast<uint64_t>(entry.st.st_size);
+            summary.size += size;
+            summary.allocated += static_cast<uint64_t>(entry.st.st_blocks) * 512;
+            summary.files++;
+            if (!entry.ignored)
+                summary.lastActivity = std::max(summary.lastActivity, entry.st.st_mtime);
+            if (entry.depth == 0 && entry.relative == ".git")
+                summary.hasGit = true;
+            // .git internals and build outputs would crowd out the project's
+            // own files, so only files that are not ignored are ranked.
+            if (!entry.ignored && (heap.size() < LARGEST_FILES || size > heap.top().first))
+            {
+                heap.push({size, entry.relative});
+                if (heap.size() > LARGEST_FILES)
+                    heap.pop();
+            }
+        }
+
+        void OnDirectory(const Entry &entry) override
+        {
+            summary.allocated += static_cast<uint64_t>(entry.st.st_blocks) * 512;
+            summary.directories++;
+            if (entry.depth == 0 && entry.relative == ".git")
+                summary.hasGit = true;
+        }
+
+        // Move the heap into summary.largest and return the summary.
+        Summary &Finish()
+        {
+            summary.largest.clear();
+            while (!heap.empty())
+            {
+                summary.largest.push_back(heap.top());
+                heap.pop();
+            }
+            std::reverse(summary.largest.begin(), summary.largest.end());
+            return summary;
+        }
+    };
+
+    // Recursive size of every directory. Files add to their own directory
+    // during the walk; Finish() folds children into parents (ids grow from
+    // parent to child, so one backwards pass suffices) and keeps the largest
+    // directories with a bounded min-heap instead of sorting all of them.
+    // An ignored tree (.git, build outputs) is ranked as a whole at its top
+    // directory, so its insides do not crowd out the project's directories.
+    struct DirectorySizeVisitor : Visitor
+    {
+        std::vector<size_t> parents{0};
+        std::vector<std::string> paths{""};
+        std::vector<uint64_t> sizes{0};
+        std::vector<bool> ignored{false};
+
+        void OnFile(const Entry &entry) override
+        {
+            sizes[entry.parent] += static_cast<uint64_t>(entry.st.st_size);
+        }
+
+        void OnDirectory(const Entry &entry) override
+        {
+            if (entry.id >= parents.size())
+            {
+                parents.resize(entry.id + 1, 0);
+                paths.resize(entry.id + 1);
+                sizes.resize(entry.id + 1, 0);
+                ignored.resize(entry.id + 1, false);
+            }
+            parents[entry.id] = entry.parent;
+            paths[entry.id] = entry.relative;
+            ignored[entry.id] = entry.ignored;
+        }
+
+        std::vector<std::pair<uint64_t, std::string>> Finish(size_t count = LARGEST_DIRS)
+        {
+            for (size_t id = sizes.size() - 1; id > 0; id--)
+                sizes[parents[id]] += sizes[id];
+
+            std::priority_queue<std::pair<uint64_t, size_t>, std::vector<std::pair<uint64_t, size_t>>, std::greater<>> heap;
+            for (size_t id = 1; id < sizes.size(); id++)
+            {
+                if (ignored[parents[id]])
+                    continue;
+                if (heap.size() < count || sizes[id] > heap.top().first)
+                {
+                    heap.push({sizes[id], id});
+                    if (heap.size() > count)
+                        heap.pop();
+                }
+            }
+            std::vector<std::pair<uint64_t, std::string>> largest;
+            while (!heap.empty())
+            {
+                largest.push_back({heap.top().first, paths[heap.top().second]});
+                heap.pop();
+            }
+            std::reverse(largest.begin(), largest.end());
+            return largest;
+        }
+    };
+
+    // Build output directories of a project with the bytes they occupy on
+    // disk. Everything below a build output belongs to it, so nested outputs
+    // (node_modules inside node_modules) are counted once, at the top.
+    struct BuildDirVisitor : Visitor
+    {
+        static constexpr size_t NONE = SIZE_MAX;
+        std::vector<size_t> owner{NONE}; // Index into found for every directory id, or NONE.
+        std::vector<std::pair<uint64_t, std::string>> found;
+
+        static bool IsBuildOutput(const Entry &entry)
+        {
+            std::string name = entry.relative.substr(entry.relative.find_last_of('/') + 1);
+            std::string parent = entry.path.substr(0, entry.path.size() - name.size());
+            struct stat st;
+            for (const auto &output : BUILD_OUTPUTS)
+            {
+                if (output.name != name)
+                    continue;
+                if (output.markers.empty())
+                    return true;
+                for (const auto &marker : output.markers)
+                {
+                    if (stat((parent + marker).c_str(), &st) == 0)
+                        return true;
+                }
+            }
+            return false;
+        }
+
+        void OnFile(const Entry &entry) override
+        {
+            if (owner[entry.parent] != NONE)
+                found[owner[entry.parent]].first += static_cast<uint64_t>(entry.st.st_blocks) * 512;
+        }
+
+        void OnDirectory(const Entry &entry) override
+        {
+            if (entry.id >= owner.size())
+                owner.resize(entry.id + 1, NONE);
+            size_t index = owner[entry.parent];
+            if (index == NONE && IsBuildOutput(entry))
+            {
+                index = found.size();
+                found.push_back({0, entry.relative});
+            }
+            if (index != NONE)
+                found[index].first += static_cast<uint64_t>(entry.st.st_blocks) * 512;
+            owner[entry.id] = index;
+        }
+
+        // The build outputs found, biggest first.
+        std::vector<std::pair<uint64_t, std::string>> Finish()
+        {
+            std::sort(found.begin(), found.end(), std::greater<>());
+            return found;
+        }
+    };
+
+    // Collects the paths of all files that are not ignored (for the filename index).
+    struct FileListVisitor : Visitor
+    {
+        std::vector<std::string> paths;
+
+        void OnFile(const Entry &entry) override
+        {
+            if (!entry.ignored)
+                paths.push_back(entry.relative);
+        }
+    };
+} // namespace Scan
+
+#endif // SCAN_HPP
@@ -0,0 +1,737 @@
+#ifndef SEARCH_HPP
+#define SEARCH_HPP
+
+#include "../dependencies/Canvas.hpp"
+#include "DevCore.hpp"
+#include "Main.hpp"
+#include "Binary.hpp"
+#include "FileCache.hpp"
+#include "Parallel.hpp"
+#include "Simd.hpp"
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <algorithm>
+#include <regex>
+#include <chrono>
+#include <memory>
+#include <array>
+#include <cstring>
+#include <cctype>
+
+// `devcore search`: full-text search over all projects backed by an on-disk
+// trigram index. The index is refreshed incrementally before every query:
+// the file list comes from the filename index (FileIndex), and only files
+// whose mtime or size changed are read again.
+//
+// Index layout (little endian):
+//   header   "DCTI", u32 version, u32 fileCount, u32 trigramCount,
+//            u64 filesOffset, u64 fileTableOffset, u64 tableOffset, u64 postingsOffset
+//   files    per file: string path, i64 mtime, u64 size, u8 binary, string trigrams (delta varints)
+//   fileTable fileCount x u64 offset of each file record
+//   table    trigramCount x {u32 trigram, u32 count, u64 offset, u32 bytes}, sorted by trigram
+//   postings per trigram: delta varint encoded file ids
+namespace Search
+{
+    const uint32_t INDEX_VERSION = 2; // 2: nanosecond mtimes from stat.
+    const size_t HEADER_SIZE = 4 + 3 * 4 + 4 * 8;
+    const size_t TABLE_ENTRY_SIZE = 4 + 4 + 8 + 4;
+    const uint64_t MAX_FILE_SIZE = 8 << 20; // Larger files are not indexed.
+
+    // One indexed file. Paths are relative to the projects folder ("C++/app/src/main.cpp").
+    struct FileEntry
+    {
+        std::string path;
+        int64_t mtime = 0;
+        uint64_t size = 0;
+        bool binary = false;
+        std::string trigrams; // Sorted trigrams, delta varint encoded.
+    };
+
+    // A matching line.
+    struct Match
+    {
+        size_t line;
+        std::string text;
+    };
+
+    inline std::string IndexPath()
+    {
+        return Main::HOME_PATH + Main::CACHE_PATH + "/search/trigrams.idx";
+    }
+
+    // Trigrams are case folded so the same index serves case-insensitive queries.
+    inline uint32_t MakeTrigram(unsigned char a, unsigned char b, unsigned char c)
+    {
+        return (uint32_t(std::tolower(a)) << 16) | (uint32_t(std::tolower(b)) << 8) | uint32_t(std::tolower(c));
+    }
+
+    // Distinct trigrams of a buffer, sorted. A per-thread bitmap over the 2^24
+    // possible trigrams removes duplicates, so only distinct values are sorted.
+    inline std::vector<uint32_t> ExtractTrigrams(const char *data, size_t size)
+    {
+        static thread_local std::vector<uint64_t> seen(size_t(1) << 18);
+        std::vector<uint32_t> trigrams;
+        if (size < 3)
+            return trigrams;
+        static const auto fold = []() {
+            std::array<uint8_t, 256> table;
+            for (int c = 0; c < 256; c++)
+                table[c] = static_cast<uint8_t>(std::tolower(c));
+            return table;
+        }();
+
+        const unsigned char *bytes = reinterpret_cast<const unsigned char *>(data);
+        uint32_t trigram = (uint32_t(fold[bytes[0]]) << 8) | fold[bytes[1]];
+        for (size_t i = 2; i < size; i++)
+        {
+            // Rolling window: shift in the next folded byte, same value as MakeTrigram.
+            trigram = ((trigram << 8) | fold[bytes[i]]) & 0xffffff;
+            uint64_t bit = uint64_t(1) << (trigram & 63);
+            if (!(seen[trigram >> 6] & bit))
+            {
+                seen[trigram >> 6] |= bit;
+                trigrams.push_back(trigram);
+            }
+        }
+        for (uint32_t trigram : trigrams)
+            seen[trigram >> 6] = 0;
+        std::sort(trigrams.begin(), trigrams.end());
+        return trigrams;
+    }
+
+    inline std::string EncodeSorted(const std::vector<uint32_t> &values)
+    {
+        std::string out;
+        uint32_t previous = 0;
+        for (uint32_t value : values)
+        {
+            Binary::PutVarint(out, value - previous);
+            previous = value;
+        }
+        return out;
+    }
+
+    inline std::vector<uint32_t> DecodeSorted(const char *data, size_t size)
+    {
+        std::vector<uint32_t> values;
+        size_t pos = 0;
+        uint64_t delta;
+        uint32_t value = 0;
+        while (pos < size && Binary::GetVarint(data, size, pos, delta))
+        {
+            value += static_cast<uint32_t>(delta);
+            values.push_back(value);
+        }
+        return values;
+    }
+
+    // Text files only: a NUL byte in the first block marks the file as binary.
+    inline bool LooksBinary(const char *data, size_t size)
+    {
+        return std::memchr(data, '\0', std::min<size_t>(size, 8192)) != nullptr;
+    }
+
+    struct Header
+    {
+        uint32_t fileCount = 0;
+        uint32_t trigramCount = 0;
+        uint64_t filesOffset = 0;
+        uint64_t fileTableOffset = 0;
+        uint64_t tableOffset = 0;
+        uint64_t postingsOffset = 0;
+    };
+
+    // Read the header of an index and check that its sections are in order
+    // and inside the file, so the file table and trigram table can be read
+    // without further bounds checks. The index lives in the user's cache and
+    // may be truncated or damaged.
+    inline bool ReadHeader(const char *data, size_t size, Header &header)
+    {
+        size_t pos = 4;
+        uint32_t version;
+        if (size < HEADER_SIZE || std::memcmp(data, "DCTI", 4) != 0 ||
+            !Binary::Get(data, size, pos, version) || version != INDEX_VERSION ||
+            !Binary::Get(data, size, pos, header.fileCount) ||
+            !Binary::Get(data, size, pos, header.trigramCount) ||
+            !Binary::Get(data, size, pos, header.filesOffset) ||
+            !Binary::Get(data, size, pos, header.fileTableOffset) ||
+            !Binary::Get(data, size, pos, header.tableOffset) ||
+            !Binary::Get(data, size, pos, header.postingsOffset))
+            return false;
+        return header.filesOffset >= HEADER_SIZE && header.filesOffset <= header.fileTableOffset &&
+               header.fileTableOffset <= header.tableOffset && header.tableOffset <= header.postingsOffset &&
+               header.postingsOffset <= size &&
+               (header.tableOffset - header.fileTableOffset) / 8 >= header.fileCount &&
+               (header.postingsOffset - header.tableOffset) / TABLE_ENTRY_SIZE >= header.trigramCount;
+    }
+
+    // Load the file records of an existing index.
+    inline std::vector<FileEntry> LoadIndex()
+    {
+        std::vector<FileEntry> files;
+        Binary::MappedFile index(IndexPath());
+        const char *data = index.data();
+        size_t size = index.size();
+        Header header;
+        if (!index.isOpen() || !ReadHeader(data, size, header))
+            return files;
+
+        size_t pos = header.filesOffset;
+        files.resize(header.fileCount);
+        for (auto &file : files)
+        {
+            uint8_t binary;
+            if (!Binary::GetString(data, size, pos, file.path) ||
+                !Binary::Get(data, size, pos, file.mtime) ||
+                !Binary::Get(data, size, pos, file.size) ||
+                !Binary::Get(data, size, pos, binary) ||
+                !Binary::GetString(data, size, pos, file.trigrams))
+                return {};
+            file.binary = binary != 0;
+        }
+        return files;
+    }
+
+    // Write the index. Files must be sorted by path; their position is their id.
+    inline bool WriteIndex(const std::vector<FileEntry> &files)
+    {
+        struct Posting
+        {
+            uint32_t count = 0;
+            uint32_t last = 0;
+            std::string ids;
+        };
+        std::unordered_map<uint32_t, Posting> postings;
+
+        std::string filesSection;
+        std::vector<uint64_t> fileOffsets;
+        for (uint32_t id = 0; id < files.size(); id++)
+        {
+            const FileEntry &file = files[id];
+            fileOffsets.push_back(HEADER_SIZE + filesSection.size());
+            Binary::PutString(filesSection, file.path);
+            Binary::Put<int64_t>(filesSection, file.mtime);
+            Binary::Put<uint64_t>(filesSection, file.size);
+            Binary::Put<uint8_t>(filesSection, file.binary ? 1 : 0);
+            Binary::PutString(filesSection, file.trigrams);
+
+            for (uint32_t trigram : DecodeSorted(file.trigrams.data(), file.trigrams.size()))
+            {
+                Posting &posting = postings[trigram];
+                Binary::PutVarint(posting.ids, id - posting.last);
+                posting.last = id;
+                posting.count++;
+            }
+        }
+
+        std::vector<uint32_t> keys;
+        keys.reserve(postings.size());
+        for (const auto &entry : postings)
+            keys.push_back(entry.first);
+        std::sort(keys.begin(), keys.end());
+
+        uint64_t filesOffset = HEADER_SIZE;
+        uint64_t fileTableOffset = filesOffset + filesSection.size();
+        uint64_t tableOffset = fileTableOffset + fileOffsets.size() * 8;
+        uint64_t postingsOffset = tableOffset + keys.size() * TABLE_ENTRY_SIZE;
+
+        std::string out;
+        out.append("DCTI", 4);
+        Binary::Put<uint32_t>(out, INDEX_VERSION);
+        Binary::Put<uint32_t>(out, static_cast<uint32_t>(files.size()));
+        Binary::Put<uint32_t>(out, static_cast<uint32_t>(keys.size()));
+        Binary::Put<uint64_t>(out, filesOffset);
+        Binary::Put<uint64_t>(out, fileTableOffset);
+        Binary::Put<uint64_t>(out, tableOffset);
+        Binary::Put<uint64_t>(out, postingsOffset);
+        out += filesSection;
+        for (uint64_t offset : fileOffsets)
+            Binary::Put<uint64_t>(out, offset);
+
+        uint64_t postingOffset = 0;
+        for (uint32_t key : keys)
+        {
+            const Posting &posting = postings[key];
+            Binary::Put<uint32_t>(out, key);
+            Binary::Put<uint32_t>(out, posting.count);
+            Binary::Put<uint64_t>(out, postingOffset);
+            Binary::Put<uint32_t>(out, static_cast<uint32_t>(posting.ids.size()));
+            postingOffset += posting.ids.size();
+        }
+        for (uint32_t key : keys)
+            out += postings[key].ids;
+
+        std::error_code ec;
+        fs::create_directories(fs::path(IndexPath()).parent_path(), ec);
+        return Binary::WriteAtomic(IndexPath(), out);
+    }
+
+    // Bring the index up to date with the projects on disk. Unchanged files
+    // (same mtime and size) keep their trigrams; only changed files are read.
+    inline size_t UpdateIndex()
+    {
+        std::vector<FileEntry> previous = LoadIndex();
+        std::unordered_map<std::string, size_t> previousByPath;
+        for (size_t i = 0; i < previous.size(); i++)
+            previousByPath[previous[i].path] = i;
+
+        // 1. Take the files of every project from the filename index the
+        // load-time scan keeps current, and stat them in parallel.
+        fs::path projectsPath = DevCore::ProjectsPath();
+        std::vector<FileEntry> files;
+        for (const auto &proj : DevCore::Projects())
+        {
+            std::string prefix = proj.lang + "/" + proj.folderName + "/";
+            for (const auto &relative : DevCore::Files(proj))
+            {
+                FileEntry file;
+                file.path = prefix + relative;
+                files.push_back(std::move(file));
+            }
+        }
+        std::vector<char> present(files.size(), 0);
+        Parallel::ForEach(files.size(), [&](size_t i) {
+            struct stat st;
+            if (stat((projectsPath / files[i].path).c_str(), &st) != 0 || !S_ISREG(st.st_mode) ||
+                static_cast<uint64_t>(st.st_size) > MAX_FILE_SIZE)
+                return;
+            files[i].mtime = FileCache::MTime(st);
+            files[i].size = static_cast<uint64_t>(st.st_size);
+            present[i] = 1;
+        });
+        std::vector<FileEntry> found;
+        for (size_t i = 0; i < files.size(); i++)
+        {
+            if (present[i])
+                found.push_back(std::move(files[i]));
+        }
+        files = std::move(found);
+        std::sort(files.begin(), files.end(), [](const FileEntry &a, const FileEntry &b) { return a.path < b.path; });
+
+        // 2. Reuse unchanged entries, collect the ones that must be read.
+        std::vector<size_t> changed;
+        for (size_t i = 0; i < files.size(); i++)
+        {
+            auto it = previousByPath.find(files[i].path);
+            if (it != previousByPath.end() && previous[it->second].mtime == files[i].mtime && previous[it->second].size == files[i].size)
+            {
+                files[i].binary = previous[it->second].binary;
+                files[i].trigrams = std::move(previous[it->second].trigrams);
+            }
+            else
+            {
+                changed.push_back(i);
+            }
+        }
+
+        std::error_code ec;
+        if (changed.empty() && files.size() == previous.size() && fs::exists(IndexPath(), ec))
+            return 0;
+
+        // 3. Extract trigrams of changed files in parallel.
+        Parallel::ForEach(changed.size(), [&](size_t i) {
+            FileEntry &file = files[changed[i]];
+            Binary::MappedFile content((projectsPath / file.path).string());
+            if (!content.isOpen() || LooksBinary(content.data(), content.size()))
+            {
+                file.binary = true;
+                return;
+            }
+            file.trigrams = EncodeSorted(ExtractTrigrams(content.data(), content.size()));
+        });
+
+        if (!WriteIndex(files))
+            Canvas::PrintError("Unable to write the search index: " + IndexPath());
+        return changed.size();
+    }
+
+    // Literal runs a match must contain. For regular expressions only runs that
+    // are required (outside groups, alternations and optional quantifiers) are
+    // returned; an empty result means every file is a candidate. The result
+    // is used to skip files, so anything not understood here ends the current
+    // run (or gives up) rather than being taken as literal text.
+    inline std::vector<std::string> RequiredLiterals(const std::string &pattern, bool regex)
+    {
+        if (!regex)
+            return {pattern};
+
+        std::vector<std::string> literals;
+
+        std::string run;
+        auto flush = [&]() {
+            if (run.size() >= 3)
+                literals.push_back(run);
+            run.clear();
+        };
+
+        // Index of the ']' closing the bracket expression opened at open, or npos.
+        auto classEnd = [&](size_t open) {
+            size_t j = open + 1;
+            if (j < pattern.size() && pattern[j] == '^')
+                j++;
+            if (j < pattern.size() && pattern[j] == ']')
+                j++;
+            for (; j < pattern.size(); j++)
+            {
+                if (pattern[j] == '\\')
+                    j++;
+                else if (pattern[j] == ']')
+                    return j;
+            }
+            return std::string::npos;
+        };
+
+        int depth = 0;
+        for (size_t i = 0; i < pattern.size(); i++)
+        {
+            char c = pattern[i];
+            if (c == '[')
+            {
+                flush();
+                size_t close = classEnd(i);
+                if (close == std::string::npos)
+                    return {};
+                i = close;
+                continue;
+            }
+            if (c == '\\' && depth > 0)
+            {
+                i++; // Escaped characters inside a group are skipped with the group.
+                continue;
+            }
+            if (c == '(')
+            {
+                depth++;
+                flush();
+                continue;
+            }
+            if (c == ')')
+            {
+                depth--;
+                continue;
+            }
+            if (depth > 0)
+                continue;
+            if (c == '|')
+                return {}; // Top level alternation: nothing is required.
+
+            char literal = '\0';
+            if (c == '\\')
+            {
+                if (i + 1 >= pattern.size())
+                    return {};
+                unsigned char escaped = static_cast<unsigned char>(pattern[i + 1]);
+                i++;
+                if (!std::isalnum(escaped))
+                    literal = static_cast<char>(escaped);
+                else
+                {
+                    // \b, \d, \w, \s and the like, backreferences and character
+                    // escapes: not literal text. Skip the operands of \x, \u and \c.
+                    flush();
+                    if (escaped == 'x')
+                        i += 2;
+                    else if (escaped == 'u')
+                        i += 4;
+                    else if (escaped == 'c')
+                        i += 1;
+                    else if (std::isdigit(escaped))
+                    {
+                        while (i + 1 < pattern.size() && std::isdigit(static_cast<unsigned char>(pattern[i + 1])))
+                            i++;
+                    }
+                    continue;
+                }
+            }
+            else if (c == '{')
+            {
+                // A {m}, {m,} or {m,n} quantifier; the character before it was
+                // already dropped from the run.
+                flush();
+                size_t close = pattern.find('}', i);
+                if (close == std::string::npos)
+                    return {};
+                i = close;
+                continue;
+            }
+            else if (std::strchr("\\.^$*+?}]", c) == nullptr)
+            {
+                literal = c;
+            }
+
+            if (literal == '\0')
+            {
+                flush();
+                continue;
+            }
+
+            char next = i + 1 < pattern.size() ? pattern[i + 1] : '\0';
+            if (next == '?' || next == '*' || next == '{')
+            {
+                flush(); // The character is optional or repeated a variable number of times.
+                continue;
+            }
+            run.push_back(literal);
+            if (next == '+')
+                flush();
+        }
+        flush();
+        return literals;
+    }
+
+    // Intersect the posting lists of all trigrams of the literals.
+    // Returns false when the index cannot narrow the search, also when a
+    // posting list points outside the index.
+    inline bool Candidates(const Binary::MappedFile &index, const Header &header, const std::vector<std::string> &literals, std::vector<uint32_t> &result)
+    {
+        const char *data = index.data();
+        const uint64_t postingsSize = index.size() - header.postingsOffset;
+
+        std::vector<uint32_t> queryTrigrams;
+        for (const auto &literal : literals)
+        {
+            if (literal.size() < 3)
+                continue;
+            std::vector<uint32_t> trigrams = ExtractTrigrams(literal.data(), literal.size());
+            queryTrigrams.insert(queryTrigrams.end(), trigrams.begin(), trigrams.end());
+        }
+        if (queryTrigrams.empty())
+            return false;
+        std::sort(queryTrigrams.begin(), queryTrigrams.end());
+        queryTrigrams.erase(std::unique(queryTrigrams.begin(), queryTrigrams.end()), queryTrigrams.end());
+
+        // Look up each trigram and start intersecting with the rarest one.
+        struct Lookup
+        {
+            uint32_t count;
+            uint64_t offset;
+            uint32_t bytes;
+        };
+        std::vector<Lookup> lookups;
+        for (uint32_t trigram : queryTrigrams)
+        {
+            uint32_t lo = 0, hi = header.trigramCount;
+            bool found = false;
+            while (lo < hi)
+            {
+                uint32_t mid = lo + (hi - lo) / 2;
+                size_t entry = header.tableOffset + size_t(mid) * TABLE_ENTRY_SIZE;
+                uint32_t key;
+                std::memcpy(&key, data + entry, 4);
+                if (key == trigram)
+                {
+                    Lookup lookup;
+                    std::memcpy(&lookup.count, data + entry + 4, 4);
+                    std::memcpy(&lookup.offset, data + entry + 8, 8);
+                    std::memcpy(&lookup.bytes, data + entry + 16, 4);
+                    if (lookup.offset > postingsSize || lookup.bytes > postingsSize - lookup.offset)
+                        return false;
+                    lookups.push_back(lookup);
+                    found = true;
+                    break;
+                }
+                if (key < trigram)
+                    lo = mid + 1;
+                else
+                    hi = mid;
+            }
+            if (!found)
+            {
+                result.clear(); // A required trigram occurs nowhere.
+                return true;
+            }
+        }
+        std::sort(lookups.begin(), lookups.end(), [](const Lookup &a, const Lookup &b) { return a.count < b.count; });
+
+        for (size_t i = 0; i < lookups.size(); i++)
+        {
+            std::vector<uint32_t> ids = DecodeSorted(data + header.postingsOffset + lookups[i].offset, lookups[i].bytes);
+            if (i == 0)
+            {
+                result = std::move(ids);
+            }
+            else
+            {
+                std::vector<uint32_t> both;
+                std::set_intersection(result.begin(), result.end(), ids.begin(), ids.end(), std::back_inserter(both));
+                result = std::move(both);
+            }
+            if (result.empty())
+                break;
+        }
+        return true;
+    }
+
+    // Call onLine(line, lineStart, lineEnd) for every matching line of a text
+    // buffer. Without a regex the pattern is a literal; with a regex only lines
+    // containing the prefilter literal (when there is one) are tried, so the
+    // slow regex engine only sees a handful of lines.
+    template <typename Fn>
+    inline size_t ScanLines(const char *data, size_t size, const std::string &pattern, const std::regex *regex,
+                            const std::string &prefilter, bool ignoreCase, Fn &&onLine)
+    {
+        const std::string &needle = regex ? prefilter : pattern;
+        const char *end = data + size;
+        const char *pos = data;
+        const char *counted = data;
+        size_t line = 1;
+        size_t matches = 0;
+        while (pos < end)
+        {
+            const char *lineStart = pos;
+            if (!needle.empty())
+            {
+                const char *hit = Simd::FindLiteral(pos, end - pos, needle.data(), needle.size(), ignoreCase);
+                if (!hit)
+                    break;
+                lineStart = hit;
+                while (lineStart > pos && lineStart[-1] != '\n')
+                    lineStart--;
+            }
+            const char *lineEnd = static_cast<const char *>(std::memchr(lineStart, '\n', end - lineStart));
+            if (!lineEnd)
+                lineEnd = end;
+            pos = lineEnd < end ? lineEnd + 1 : end;
+            if (regex && !std::regex_search(lineStart, lineEnd, *regex))
+                continue;
+
+            line += Simd::CountByte(counted, lineStart - counted, '\n');
+            counted = lineStart;
+            onLine(line, lineStart, lineEnd);
+            matches++;
+        }
+        return matches;
+    }
+
+    // Longest literal a regex match must contain (empty when there is none).
+    inline std::string Prefilter(const std::string &pattern)
+    {
+        std::string prefilter;
+        for (const auto &literal : RequiredLiterals(pattern, true))
+        {
+            if (literal.size() > prefilter.size())
+                prefilter = literal;
+        }
+        return prefilter;
+    }
+
+    // Verify a candidate file and collect its matching lines.
+    inline std::vector<Match> MatchFile(const std::string &path, const std::string &pattern, const std::regex *regex, const std::string &prefilter, bool ignoreCase)
+    {
+        std::vector<Match> matches;
+        Binary::MappedFile content(path);
+        if (!content.isOpen() || content.size() == 0)
+            return matches;
+
+        ScanLines(content.data(), content.size(), pattern, regex, prefilter, ignoreCase, [&](size_t line, const char *lineStart, const char *lineEnd) {
+            matches.push_back({line, std::string(lineStart, std::min<size_t>(lineEnd - lineStart, 200))});
+        });
+        return matches;
+    }
+
+    inline void Run(const std::string &pattern, bool useRegex, bool ignoreCase)
+    {
+        auto start = std::chrono::steady_clock::now();
+        size_t reindexed = UpdateIndex();
+
+        // UpdateIndex rebuilds an index whose header or file list is damaged,
+        // so this only fails when it could not write a new one.
+        Binary::MappedFile index(IndexPath());
+        Header header;
+        if (!index.isOpen() || !ReadHeader(index.data(), index.size(), header))
+        {
+            Canvas::PrintError("The search index could not be read: " + IndexPath());
+            return;
+        }
+
+        std::unique_ptr<std::regex> regex;
+        if (useRegex)
+        {
+            try
+            {
+                auto flags = std::regex::ECMAScript | std::regex::optimize;
+                if (ignoreCase)
+                    flags |= std::regex::icase;
+                regex = std::make_unique<std::regex>(pattern, flags);
+            }
+            catch (const std::regex_error &e)
+            {
+                Canvas::PrintError("Invalid regular expression: " + std::string(e.what()));
+                return;
+            }
+        }
+
+        std::string prefilter = useRegex ? Prefilter(pattern) : "";
+
+        // Resolve candidate file ids to paths.
+        const char *data = index.data();
+        std::vector<uint32_t> ids;
+        if (!Candidates(index, header, RequiredLiterals(pattern, useRegex), ids))
+        {
+            ids.resize(header.fileCount);
+            for (uint32_t i = 0; i < header.fileCount; i++)
+                ids[i] = i;
+        }
+
+        std::vector<std::string> paths;
+        for (uint32_t id : ids)
+        {
+            if (id >= header.fileCount)
+                continue;
+            uint64_t offset;
+            std::memcpy(&offset, data + header.fileTableOffset + size_t(id) * 8, 8);
+            size_t pos = offset;
+            std::string path;
+            if (offset >= index.size() || !Binary::GetString(data, index.size(), pos, path))
+                continue;
+            size_t flagPos = pos + 8 + 8;
+            if (flagPos < index.size() && data[flagPos] == 0)
+                paths.push_back(path);
+        }
+
+        // Verify candidates in parallel.
+        fs::path projectsPath = DevCore::ProjectsPath();
+        std::vector<std::vector<Match>> results(paths.size());
+        Parallel::ForEach(paths.size(), [&](size_t i) {
+            results[i] = MatchFile((projectsPath / paths[i]).string(), pattern, regex.get(), prefilter, ignoreCase);
+        });
+
+        // Print results grouped by project (paths are sorted, so groups are contiguous).
+        std::map<std::string, std::string> projectNames;
+        for (const auto &proj : DevCore::Projects())
+            projectNames[proj.lang + "/" + proj.folderName] = proj.name;
+
+        size_t matchCount = 0, fileMatches = 0;
+        std::string currentProject;
+        for (size_t i = 0; i < paths.size(); i++)
+        {
+            if (results[i].empty())
+                continue;
+            size_t split = paths[i].find('/', paths[i].find('/') + 1);
+            std::string projectKey = paths[i].substr(0, split);
+            if (projectKey != currentProject)
+            {
+                currentProject = projectKey;
+                std::string name = projectNames.count(projectKey) ? projectNames[projectKey] : projectKey;
+                Canvas::PrintColoredLine(Canvas::BoldText(name) + Canvas::ColorToAnsi(Canvas::Color::CYAN) + " (" + projectKey + ")", Canvas::Color::CYAN);
+            }
+            fileMatches++;
+            for (const auto &match : results[i])
+            {
+                matchCount++;
+                std::cout << "  " << Canvas::ColorToAnsi(Canvas::Color::MAGENTA) << paths[i].substr(split + 1)
+                          << Canvas::ColorToAnsi(Canvas::Color::YELLOW) << ":" << match.line << ":" << Canvas::ResetColor()
+                          << " " << match.text << "\n";
+            }
+        }
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        Canvas::PrintInfo(std::to_string(matchCount) + " matches in " + std::to_string(fileMatches) + " files (" +
+                          std::to_string(paths.size()) + " candidates of " + std::to_string(header.fileCount) + " indexed files, " +
+                          std::to_string(reindexed) + " reindexed) in " + std::to_string(elapsed) + " ms.");
+    }
+} // namespace Search
+
+#endif // SEARCH_HPP
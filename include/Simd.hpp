@@ -0,0 +1,109 @@
+#ifndef SIMD_HPP
+#define SIMD_HPP
+
+#include <cstddef>
+#include <algorithm>
+#include <cstring>
+#include <cctype>
+#include <strings.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Vectorized byte scanning helpers. SSE2 is part of x86-64, other targets fall
+// back to the (already vectorized) libc routines.
+namespace Simd
+{
+    // Find needle in haystack. Candidates are found 16 bytes at a time by
+    // comparing the first and the last byte of the needle, so most of the
+    // haystack is rejected without a full compare. Returns nullptr if absent.
+    inline const char *FindLiteral(const char *haystack, size_t size, const char *needle, size_t length, bool ignoreCase = false)
+    {
+        if (length == 0)
+            return haystack;
+        if (length > size)
+            return nullptr;
+
+        unsigned char first = static_cast<unsigned char>(needle[0]);
+        unsigned char last = static_cast<unsigned char>(needle[length - 1]);
+        size_t i = 0;
+
+    #ifdef __SSE2__
+        const __m128i firstLower = _mm_set1_epi8(static_cast<char>(std::tolower(first)));
+        const __m128i firstUpper = _mm_set1_epi8(static_cast<char>(std::toupper(first)));
+        const __m128i lastLower = _mm_set1_epi8(static_cast<char>(std::tolower(last)));
+        const __m128i lastUpper = _mm_set1_epi8(static_cast<char>(std::toupper(last)));
+        const __m128i firstExact = _mm_set1_epi8(static_cast<char>(first));
+        const __m128i lastExact = _mm_set1_epi8(static_cast<char>(last));
+
+        for (; i + length - 1 + 16 <= size; i += 16)
+        {
+            __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i *>(haystack + i));
+            __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i *>(haystack + i + length - 1));
+            __m128i eqFirst, eqLast;
+            if (ignoreCase)
+            {
+                eqFirst = _mm_or_si128(_mm_cmpeq_epi8(blockFirst, firstLower), _mm_cmpeq_epi8(blockFirst, firstUpper));
+                eqLast = _mm_or_si128(_mm_cmpeq_epi8(blockLast, lastLower), _mm_cmpeq_epi8(blockLast, lastUpper));
+            }
+            else
+            {
+                eqFirst = _mm_cmpeq_epi8(blockFirst, firstExact);
+                eqLast = _mm_cmpeq_epi8(blockLast, lastExact);
+            }
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(eqFirst, eqLast)));
+            while (mask)
+            {
+                unsigned bit = static_cast<unsigned>(__builtin_ctz(mask));
+                const char *candidate = haystack + i + bit;
+                if (ignoreCase ? strncasecmp(candidate, needle, length) == 0 : std::memcmp(candidate, needle, length) == 0)
+                    return candidate;
+                mask &= mask - 1;
+            }
+        }
+    #endif
+
+        if (!ignoreCase)
+        {
+            const void *hit = memmem(haystack + i, size - i, needle, length);
+            return static_cast<const char *>(hit);
+        }
+        for (; i + length <= size; i++)
+        {
+            if (strncasecmp(haystack + i, needle, length) == 0)
+                return haystack + i;
+        }
+        return nullptr;
+    }
+
+    // Count occurrences of byte (usually '\n') in data. Matches are summed in
+    // 8 bit lanes and folded into 64 bit totals with psadbw every 255 blocks.
+    inline size_t CountByte(const char *data, size_t size, char byte)
+    {
+        size_t count = 0;
+        size_t i = 0;
+
+    #ifdef __SSE2__
+        const __m128i target = _mm_set1_epi8(byte);
+        const __m128i zero = _mm_setzero_si128();
+        while (i + 16 <= size)
+        {
+            __m128i lanes = _mm_setzero_si128();
+            size_t blocks = std::min<size_t>((size - i) / 16, 255);
+            for (size_t b = 0; b < blocks; b++, i += 16)
+            {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+                lanes = _mm_sub_epi8(lanes, _mm_cmpeq_epi8(block, target));
+            }
+            __m128i sums = _mm_sad_epu8(lanes, zero);
+            count += static_cast<size_t>(_mm_cvtsi128_si32(sums)) + static_cast<size_t>(_mm_extract_epi16(sums, 4));
+        }
+    #endif
+
+        for (; i < size; i++)
+            count += data[i] == byte;
+        return count;
+    }
+} // namespace Simd
+
+#endif // SIMD_HPP
@@ -0,0 +1,420 @@
+#ifndef STATS_HPP
+#define STATS_HPP
+
+#include "Main.hpp"
+#include "Binary.hpp"
+#include "FileCache.hpp"
+#include "FileIndex.hpp"
+#include "Scan.hpp"
+#include "Simd.hpp"
+#include "Strings.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <algorithm>
+#include <filesystem>
+#include <cctype>
+namespace fs = std::filesystem;
+
+// Lines of code per project and language. The language of a file comes from
+// its extension, its name (Makefile, CMakeLists.txt) or a #! line, and every
+// line is classified as code, comment or blank.
+//
+// Results are cached per project in ~/.cache/devcore/stats/<lang>/<folder>.idx
+// (FileCache) and a file is counted again only when its mtime or size changed.
+// The load-time scan keeps the caches current (LineCountVisitor), so every
+// project's line count is as fresh as its size.
+namespace Stats
+{
+    const uint32_t INDEX_VERSION = 3; // 2: nanosecond mtimes. 3: comments anywhere on a line.
+    const uint8_t NO_LANGUAGE = 0xff;
+    const size_t MMAP_THRESHOLD = 1 << 20; // Files from this size on are mapped instead of read.
+
+    struct Language
+    {
+        const char *name;
+        std::vector<std::string> extensions;
+        std::string lineComment;
+        std::string blockStart;
+        std::string blockEnd;
+    };
+
+    // Known languages. The position in this table is stored in the cache, so
+    // only append (or bump INDEX_VERSION).
+    inline const std::vector<Language> &Languages()
+    {
+        static const std::vector<Language> languages{
+            {"C", {".c", ".h"}, "//", "/*", "*/"},
+            {"C++", {".cpp", ".cc", ".cxx", ".c++", ".hpp", ".hh", ".hxx", ".h++", ".inl", ".ipp", ".tpp"}, "//", "/*", "*/"},
+            {"C#", {".cs"}, "//", "/*", "*/"},
+            {"Java", {".java"}, "//", "/*", "*/"},
+            {"Kotlin", {".kt", ".kts"}, "//", "/*", "*/"},
+            {"Go", {".go"}, "//", "/*", "*/"},
+            {"Rust", {".rs"}, "//", "/*", "*/"},
+            {"JavaScript", {".js", ".mjs", ".cjs", ".jsx"}, "//", "/*", "*/"},
+            {"TypeScript", {".ts", ".tsx"}, "//", "/*", "*/"},
+            {"Swift", {".swift"}, "//", "/*", "*/"},
+            {"Scala", {".scala"}, "//", "/*", "*/"},
+            {"Dart", {".dart"}, "//", "/*", "*/"},
+            {"PHP", {".php"}, "//", "/*", "*/"},
+            {"CSS", {".css", ".scss", ".less"}, "//", "/*", "*/"},
+            {"Python", {".py", ".pyw"}, "#", "\"\"\"", "\"\"\""},
+            {"Shell", {".sh", ".bash", ".zsh"}, "#", "", ""},
+            {"Ruby", {".rb"}, "#", "=begin", "=end"},
+            {"Perl", {".pl", ".pm"}, "#", "", ""},
+            {"R", {".r"}, "#", "", ""},
+            {"Lua", {".lua"}, "--", "--[[", "]]"},
+            {"SQL", {".sql"}, "--", "/*", "*/"},
+            {"Haskell", {".hs"}, "--", "{-", "-}"},
+            {"CMake", {".cmake"}, "#", "#[[", "]]"},
+            {"Makefile", {".mk"}, "#", "", ""},
+            {"Dockerfile", {".dockerfile"}, "#", "", ""},
+            {"YAML", {".yml", ".yaml"}, "#", "", ""},
+            {"TOML", {".toml"}, "#", "", ""},
+            {"HTML", {".html", ".htm", ".xhtml"}, "", "<!--", "-->"},
+            {"XML", {".xml"}, "", "<!--", "-->"},
+            {"Markdown", {".md", ".markdown"}, "", "", ""},
+            {"JSON", {".json"}, "", "", ""},
+        };
+        return languages;
+    }
+
+    inline uint8_t FindLanguage(std::string_view name)
+    {
+        const auto &languages = Languages();
+        for (size_t i = 0; i < languages.size(); i++)
+        {
+            if (name == languages[i].name)
+                return static_cast<uint8_t>(i);
+        }
+        return NO_LANGUAGE;
+    }
+
+    // Language from the file name alone. Returns NO_LANGUAGE when unknown.
+    inline uint8_t LanguageFromPath(const std::string &path)
+    {
+        static const std::unordered_map<std::string, uint8_t> byExtension = [] {
+            std::unordered_map<std::string, uint8_t> map;
+            const auto &languages = Languages();
+            for (size_t i = 0; i < languages.size(); i++)
+                for (const auto &extension : languages[i].extensions)
+                    map[extension] = static_cast<uint8_t>(i);
+            return map;
+        }();
+
+        std::string name = path.substr(path.find_last_of('/') + 1);
+        if (name == "Makefile" || name == "makefile" || name == "GNUmakefile")
+            return FindLanguage("Makefile");
+        if (name == "CMakeLists.txt")
+            return FindLanguage("CMake");
+        if (name == "Dockerfile")
+            return FindLanguage("Dockerfile");
+
+        size_t dot = name.rfind('.');
+        if (dot == std::string::npos || dot == 0)
+            return NO_LANGUAGE;
+        std::string extension = Strings::Lower(name.substr(dot));
+        auto it = byExtension.find(extension);
+        return it == byExtension.end() ? NO_LANGUAGE : it->second;
+    }
+
+    // Language from a "#!" line ("#!/usr/bin/env python3" -> Python).
+    inline uint8_t LanguageFromShebang(const char *data, size_t size)
+    {
+        if (size < 3 || data[0] != '#' || data[1] != '!')
+            return NO_LANGUAGE;
+        const char *end = static_cast<const char *>(std::memchr(data, '\n', size));
+        std::string line(data + 2, end ? end : data + size);
+        std::vector<std::string> words;
+        size_t pos = 0;
+        while ((pos = line.find_first_not_of(" \t\r", pos)) != std::string::npos)
+        {
+            size_t stop = line.find_first_of(" \t\r", pos);
+            words.push_back(line.substr(pos, stop - pos));
+            pos = stop;
+        }
+        if (words.empty())
+            return NO_LANGUAGE;
+        std::string interpreter = words[0].substr(words[0].find_last_of('/') + 1);
+        if (interpreter == "env")
+        {
+            // "#!/usr/bin/env -S python3 -u": the first word that is not an option.
+            auto it = std::find_if(words.begin() + 1, words.end(), [](const std::string &word) { return word[0] != '-'; });
+            interpreter = it == words.end() ? "" : *it;
+        }
+        while (!interpreter.empty() && (std::isdigit(static_cast<unsigned char>(interpreter.back())) || interpreter.back() == '.'))
+            interpreter.pop_back();
+
+        if (interpreter == "python")
+            return FindLanguage("Python");
+        if (interpreter == "sh" || interpreter == "bash" || interpreter == "zsh" || interpreter == "dash" || interpreter == "ksh")
+            return FindLanguage("Shell");
+        if (interpreter == "ruby")
+            return FindLanguage("Ruby");
+        if (interpreter == "perl")
+            return FindLanguage("Perl");
+        if (interpreter == "node")
+            return FindLanguage("JavaScript");
+        if (interpreter == "lua")
+            return FindLanguage("Lua");
+        return NO_LANGUAGE;
+    }
+
+    struct Counts
+    {
+        size_t files = 0;
+        size_t code = 0;
+        size_t comment = 0;
+        size_t blank = 0;
+
+        size_t lines() const { return code + comment + blank; }
+
+        Counts &operator+=(const Counts &other)
+        {
+            files += other.files;
+            code += other.code;
+            comment += other.comment;
+            blank += other.blank;
+            return *this;
+        }
+    };
+
+    inline bool StartsWith(const char *pos, const char *end, const std::string &prefix)
+    {
+        return !prefix.empty() && static_cast<size_t>(end - pos) >= prefix.size() && std::memcmp(pos, prefix.data(), prefix.size()) == 0;
+    }
+
+    // Classify every line of a file: code when any byte outside comments is
+    // not white space, comment when it holds (part of) a comment and nothing
+    // else, blank otherwise. String literals are skipped so that "//" or "/*"
+    // inside them does not start a comment. The lines inside a block comment
+    // are skipped in one go: its end is found with the SIMD literal search
+    // and the lines it spans are counted with the SIMD byte counter.
+    inline Counts CountLines(const char *data, size_t size, const Language &language)
+    {
+        Counts counts;
+        counts.files = 1;
+        const char *end = data + size;
+        const char *pos = data;
+        bool inComment = false;
+        while (pos < end)
+        {
+            const char *lineEnd = static_cast<const char *>(std::memchr(pos, '\n', end - pos));
+            if (!lineEnd)
+                lineEnd = end;
+            bool code = false, comment = inComment;
+            const char *at = pos;
+            while (at < lineEnd)
+            {
+                if (inComment)
+                {
+                    const char *close = Simd::FindLiteral(at, end - at, language.blockEnd.data(), language.blockEnd.size());
+                    if (!close)
+                    {
+                        // Unterminated: the rest of the file is comment.
+                        (code ? counts.code : counts.comment)++;
+                        if (lineEnd < end)
+                            counts.comment += Simd::CountByte(lineEnd + 1, end - lineEnd - 1, '\n') + (end[-1] != '\n');
+                        return counts;
+                    }
+                    if (close >= lineEnd)
+                    {
+                        // The comment goes on past this line: count this line
+                        // and the ones in between, then resume on the line
+                        // the comment ends on.
+                        (code ? counts.code : counts.comment)++;
+                        const char *closeLine = close;
+                        while (closeLine > lineEnd + 1 && closeLine[-1] != '\n')
+                            closeLine--;
+                        counts.comment += Simd::CountByte(lineEnd + 1, closeLine - lineEnd - 1, '\n');
+                        pos = lineEnd = closeLine;
+                        code = false;
+                        lineEnd = static_cast<const char *>(std::memchr(pos, '\n', end - pos));
+                        if (!lineEnd)
+                            lineEnd = end;
+                    }
+                    at = close + language.blockEnd.size();
+                    inComment = false;
+                    continue;
+                }
+                char c = *at;
+                if (c == ' ' || c == '\t' || c == '\r' || c == '\f')
+                {
+                    at++;
+                }
+                else if (StartsWith(at, lineEnd, language.blockStart))
+                {
+                    comment = inComment = true;
+                    at += language.blockStart.size();
+                }
+                else if (StartsWith(at, lineEnd, language.lineComment))
+                {
+                    comment = true;
+                    break;
+                }
+                else if (c == '"' || c == '\'')
+                {
+                    // A string or character literal, when it closes on this line.
+                    code = true;
+                    const char *close = at + 1;
+                    while (close < lineEnd && *close != c)
+                        close += *close == '\\' ? 2 : 1;
+                    at = close < lineEnd ? close + 1 : at + 1;
+                }
+                else
+                {
+                    code = true;
+                    at++;
+                }
+            }
+            if (code)
+                counts.code++;
+            else if (comment)
+                counts.comment++;
+            else
+                counts.blank++;
+            pos = lineEnd + 1;
+        }
+        return counts;
+    }
+
+    // One counted file. The path is relative to the project.
+    struct FileEntry
+    {
+        std::string path;
+        int64_t mtime = 0;
+        uint64_t size = 0;
+        uint8_t language = NO_LANGUAGE;
+        Counts counts;
+    };
+
+    // The line counts cache (see FileCache.hpp); the payload is u8 language,
+    // varint code, comment, blank.
+    struct Format
+    {
+        using Entry = FileEntry;
+        static constexpr const char *MAGIC = "DCLC";
+        static constexpr const char *DIRECTORY = "stats";
+        static const uint32_t VERSION = INDEX_VERSION;
+
+        static void Put(std::string &out, const FileEntry &file)
+        {
+            Binary::Put<uint8_t>(out, file.language);
+            Binary::PutVarint(out, file.counts.code);
+            Binary::PutVarint(out, file.counts.comment);
+            Binary::PutVarint(out, file.counts.blank);
+        }
+
+        static bool Get(const char *data, size_t size, size_t &pos, FileEntry &file)
+        {
+            uint64_t code, comment, blank;
+            if (!Binary::Get(data, size, pos, file.language) || !Binary::GetVarint(data, size, pos, code) ||
+                !Binary::GetVarint(data, size, pos, comment) || !Binary::GetVarint(data, size, pos, blank))
+                return false;
+            // A damaged cache must not index past the language table.
+            if (file.language != NO_LANGUAGE && file.language >= Languages().size())
+                return false;
+            file.counts = {file.language == NO_LANGUAGE ? 0u : 1u, code, comment, blank};
+            return true;
+        }
+
+        static void Read(const std::string &path, FileEntry &entry)
+        {
+            thread_local std::string buffer;
+            Binary::MappedFile mapped;
+            const char *data = nullptr;
+            size_t size = 0;
+            if (entry.size >= MMAP_THRESHOLD && mapped.open(path))
+            {
+                data = mapped.data();
+                size = mapped.size();
+            }
+            else if (entry.size < MMAP_THRESHOLD && Binary::ReadInto(path, buffer))
+            {
+                data = buffer.data();
+                size = buffer.size();
+            }
+            if (!data || std::memchr(data, '\0', std::min<size_t>(size, 8192)))
+                return;
+
+            entry.language = LanguageFromPath(entry.path);
+            if (entry.language == NO_LANGUAGE)
+                entry.language = LanguageFromShebang(data, size);
+            if (entry.language != NO_LANGUAGE)
+                entry.counts = CountLines(data, size, Languages()[entry.language]);
+        }
+    };
+
+    // Files with an unknown extension are never read; files without one may
+    // still have a #! line.
+    inline bool MayCount(const std::string &path)
+    {
+        std::string name = path.substr(path.find_last_of('/') + 1);
+        return LanguageFromPath(path) != NO_LANGUAGE || name.find('.') == std::string::npos;
+    }
+
+    // Count the files of the given projects ("lang/folder" keys below
+    // projectsPath), taking the file lists from the filename index. Returns
+    // the entries per project and sets recounted to the number of files that
+    // were read.
+    inline std::vector<std::vector<FileEntry>> Update(const std::vector<std::string> &keys, const fs::path &projectsPath, size_t &recounted)
+    {
+        std::vector<FileCache::Project> projects;
+        for (const auto &key : keys)
+        {
+            FileCache::Project project{key, projectsPath / key, {}};
+            for (auto &path : FileIndex::Paths(key))
+            {
+                if (MayCount(path))
+                    project.paths.push_back(std::move(path));
+            }
+            projects.push_back(std::move(project));
+        }
+        return FileCache::Update<Format>(projects, recounted);
+    }
+
+    // Counts the files of a project during the load-time scan (Scan::Walk),
+    // using the mtime and size the walk already has. Only changed files are
+    // read, so a scan of an unchanged project reads nothing but the cache.
+    struct LineCountVisitor : Scan::Visitor
+    {
+        std::vector<FileEntry> files;
+
+        void OnFile(const Scan::Entry &entry) override
+        {
+            if (entry.ignored || !MayCount(entry.relative))
+                return;
+            FileEntry file;
+            file.path = entry.relative;
+            file.mtime = FileCache::MTime(entry.st);
+            file.size = static_cast<uint64_t>(entry.st.st_size);
+            files.push_back(std::move(file));
+        }
+
+        // Lines of code of the project, after bringing its cache up to date.
+        uint64_t Finish(const std::string &key, const fs::path &root)
+        {
+            size_t recounted;
+            uint64_t lines = 0;
+            for (const auto &file : FileCache::UpdateProject<Format>({key, root, {}}, std::move(files), recounted))
+                lines += file.counts.code;
+            return lines;
+        }
+    };
+
+    // Totals per language name.
+    inline std::map<std::string, Counts> ByLanguage(const std::vector<FileEntry> &files)
+    {
+        std::map<std::string, Counts> totals;
+        for (const auto &file : files)
+        {
+            if (file.language != NO_LANGUAGE)
+                totals[Languages()[file.language].name] += file.counts;
+        }
+        return totals;
+    }
+} // namespace Stats
+
+#endif // STATS_HPP
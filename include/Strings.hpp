@@ -0,0 +1,77 @@
+#ifndef STRINGS_HPP
+#define STRINGS_HPP
+
+#include <string>
+#include <sstream>
+#include <iomanip>
+#include <cctype>
+#include <cstdint>
+#include <ctime>
+#include <stdexcept>
+
+// Small string helpers shared by the commands and libdevcore.
+namespace Strings
+{
+    // ASCII lower case copy, for case-insensitive matching.
+    inline std::string Lower(std::string text)
+    {
+        for (char &c : text)
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        return text;
+    }
+
+    // Parse a non-negative decimal count no larger than max. Empty,
+    // non-numeric and out of range values are rejected instead of letting
+    // std::stoull throw.
+    inline bool ParseCount(const std::string &digits, uint64_t &value, uint64_t max = UINT64_MAX)
+    {
+        if (digits.empty() || digits.find_first_not_of("0123456789") != std::string::npos)
+            return false;
+        try
+        {
+            unsigned long long parsed = std::stoull(digits);
+            if (parsed > max)
+                return false;
+            value = parsed;
+            return true;
+        }
+        catch (const std::invalid_argument &)
+        {
+            return false;
+        }
+        catch (const std::out_of_range &)
+        {
+            return false;
+        }
+    }
+
+    // A point in time as the DevMap stores and shows it ("HH:MM DD-MM-YYYY"),
+    // or "" when it cannot be converted.
+    inline std::string FormatTime(time_t t)
+    {
+        std::tm parts;
+        if (!localtime_r(&t, &parts))
+            return "";
+        char buffer[32];
+        std::strftime(buffer, sizeof(buffer), "%H:%M %d-%m-%Y", &parts);
+        return buffer;
+    }
+
+    // A byte count for humans ("1.5 MiB").
+    inline std::string FormatSize(uint64_t bytes)
+    {
+        const char *units[] = {"B", "KiB", "MiB", "GiB", "TiB"};
+        double value = static_cast<double>(bytes);
+        int unit = 0;
+        while (value >= 1024.0 && unit < 4)
+        {
+            value /= 1024.0;
+            unit++;
+        }
+        std::ostringstream ss;
+        ss << std::fixed << std::setprecision(unit == 0 ? 0 : 1) << value << " " << units[unit];
+        return ss.str();
+    }
+} // namespace Strings
+
+#endif // STRINGS_HPP
@@ -0,0 +1,678 @@
+#ifndef SYMBOLS_HPP
+#define SYMBOLS_HPP
+
+#include "../dependencies/Canvas.hpp"
+#include "DevCore.hpp"
+#include "Main.hpp"
+#include "Binary.hpp"
+#include "FileCache.hpp"
+#include "Strings.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+#include <algorithm>
+#include <cctype>
+#include <fnmatch.h>
+
+// `devcore symbol`: definitions of C/C++ namespaces, classes, functions and
+// macros across all projects. Sources are read by a small tokenizer that
+// understands comments, literals and preprocessor lines, and a brace tracking
+// parser that only looks at namespace and class scope; no compiler is needed.
+//
+// Every project has its own index in ~/.cache/devcore/symbols/<lang>/<folder>.idx
+// (FileCache). The file list comes from the filename index, and a file is
+// parsed again only when its mtime or size changed.
+namespace Symbols
+{
+    const uint32_t INDEX_VERSION = 2; // 2: nanosecond mtimes.
+    const uint64_t MAX_FILE_SIZE = 8 << 20; // Larger files are not parsed.
+
+    enum class Kind : uint8_t
+    {
+        Namespace,
+        Class,
+        Struct,
+        Union,
+        Enum,
+        Function,
+        Macro
+    };
+
+    struct Symbol
+    {
+        std::string name; // Qualified name ("DevMap::syncDevMap").
+        Kind kind;
+        uint32_t line;
+    };
+
+    // One indexed file. The path is relative to the project.
+    struct FileEntry
+    {
+        std::string path;
+        int64_t mtime = 0;
+        uint64_t size = 0;
+        std::vector<Symbol> symbols;
+    };
+
+    inline const char *KindName(Kind kind)
+    {
+        switch (kind)
+        {
+        case Kind::Namespace: return "namespace";
+        case Kind::Class: return "class";
+        case Kind::Struct: return "struct";
+        case Kind::Union: return "union";
+        case Kind::Enum: return "enum";
+        case Kind::Function: return "function";
+        case Kind::Macro: return "macro";
+        }
+        return "?";
+    }
+
+    inline bool IsSourceFile(const std::string &path)
+    {
+        static const std::vector<std::string> extensions{".h", ".hh", ".hpp", ".hxx", ".h++", ".inl", ".ipp", ".tpp",
+                                                         ".c", ".cc", ".cpp", ".cxx", ".c++"};
+        size_t dot = path.find_last_of("./");
+        if (dot == std::string::npos || path[dot] != '.')
+            return false;
+        std::string extension = Strings::Lower(path.substr(dot));
+        return std::find(extensions.begin(), extensions.end(), extension) != extensions.end();
+    }
+
+    // ---- Tokenizer ----
+
+    struct Token
+    {
+        std::string_view text;
+        uint32_t line;
+        bool ident;
+    };
+
+    inline bool IsIdentStart(char c)
+    {
+        return std::isalpha(static_cast<unsigned char>(c)) || c == '_';
+    }
+
+    inline bool IsIdent(char c)
+    {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+    }
+
+    // Split a source file into identifier and punctuation tokens. Comments,
+    // whitespace and preprocessor lines are dropped and every string or
+    // character literal becomes a single '"' token. Names from #define are
+    // added to macros directly.
+    inline void Tokenize(const char *data, size_t size, std::vector<Token> &tokens, std::vector<Symbol> &macros)
+    {
+        uint32_t line = 1;
+        bool lineStart = true;
+        size_t i = 0;
+        auto skipSpaces = [&]() {
+            while (i < size && (data[i] == ' ' || data[i] == '\t'))
+                i++;
+        };
+
+        while (i < size)
+        {
+            char c = data[i];
+            char next = i + 1 < size ? data[i + 1] : '\0';
+            if (c == '\n')
+            {
+                line++;
+                lineStart = true;
+                i++;
+                continue;
+            }
+            if (c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v')
+            {
+                i++;
+                continue;
+            }
+            if (c == '/' && next == '/')
+            {
+                while (i < size && data[i] != '\n')
+                    i++;
+                continue;
+            }
+            if (c == '/' && next == '*')
+            {
+                i += 2;
+                while (i < size && !(data[i] == '*' && i + 1 < size && data[i + 1] == '/'))
+                {
+                    if (data[i] == '\n')
+                        line++;
+                    i++;
+                }
+                i += 2;
+                continue;
+            }
+            if (c == '#' && lineStart)
+            {
+                // Preprocessor directive: record #define names, skip the rest
+                // of the logical line.
+                i++;
+                skipSpaces();
+                size_t start = i;
+                while (i < size && IsIdent(data[i]))
+                    i++;
+                if (std::string_view(data + start, i - start) == "define")
+                {
+                    skipSpaces();
+                    start = i;
+                    while (i < size && IsIdent(data[i]))
+                        i++;
+                    if (i > start)
+                        macros.push_back({std::string(data + start, i - start), Kind::Macro, line});
+                }
+                while (i < size && data[i] != '\n')
+                {
+                    if (data[i] == '\\' && i + 1 < size && (data[i + 1] == '\n' || data[i + 1] == '\r'))
+                    {
+                        i += data[i + 1] == '\r' && i + 2 < size && data[i + 2] == '\n' ? 3 : 2;
+                        line++;
+                        continue;
+                    }
+                    i++;
+                }
+                continue;
+            }
+            lineStart = false;
+
+            if (IsIdentStart(c))
+            {
+                size_t start = i;
+                while (i < size && IsIdent(data[i]))
+                    i++;
+                std::string_view word(data + start, i - start);
+                if (i < size && data[i] == '"' && (word == "R" || word == "u8R" || word == "uR" || word == "UR" || word == "LR"))
+                {
+                    // Raw string literal: R"delim( ... )delim".
+                    size_t open = i + 1;
+                    size_t paren = open;
+                    while (paren < size && data[paren] != '(' && paren - open < 16)
+                        paren++;
+                    std::string close = ")" + std::string(data + open, paren - open) + "\"";
+                    const char *end = static_cast<const char *>(memmem(data + paren, size - paren, close.data(), close.size()));
+                    size_t stop = end ? static_cast<size_t>(end - data) + close.size() : size;
+                    for (size_t k = i; k < stop; k++)
+                        line += data[k] == '\n';
+                    tokens.push_back({std::string_view(data + i, 1), line, false});
+                    i = stop;
+                    continue;
+                }
+                if (i < size && (data[i] == '"' || data[i] == '\'') && (word == "u8" || word == "u" || word == "U" || word == "L"))
+                    continue; // Literal prefix, the literal itself follows.
+                tokens.push_back({word, line, true});
+                continue;
+            }
+            if (std::isdigit(static_cast<unsigned char>(c)) || (c == '.' && std::isdigit(static_cast<unsigned char>(next))))
+            {
+                // Numbers, including digit separators (1'000) and suffixes.
+                size_t start = i;
+                while (i < size && (IsIdent(data[i]) || data[i] == '.' || data[i] == '\''))
+                    i++;
+                tokens.push_back({std::string_view(data + start, i - start), line, false});
+                continue;
+            }
+            if (c == '"' || c == '\'')
+            {
+                tokens.push_back({std::string_view(data + i, 1), line, false});
+                i++;
+                while (i < size && data[i] != c && data[i] != '\n')
+                    i += data[i] == '\\' ? 2 : 1;
+                i++;
+                continue;
+            }
+            if ((c == ':' && next == ':') || (c == '-' && next == '>'))
+            {
+                tokens.push_back({std::string_view(data + i, 2), line, false});
+                i += 2;
+                continue;
+            }
+            tokens.push_back({std::string_view(data + i, 1), line, false});
+            i++;
+        }
+    }
+
+    // ---- Parser ----
+
+    enum class ScopeKind
+    {
+        Namespace,   // Named namespace or class: definitions inside are indexed.
+        Transparent, // Anonymous namespace, extern "C": indexed with the outer prefix.
+        Block,       // Function body, initializer, enum: skipped.
+        InitBrace    // Brace initializer in a constructor init list (not a scope).
+    };
+
+    struct Scope
+    {
+        ScopeKind kind;
+        std::string prefix; // Qualification of names defined in this scope ("DevMap::").
+    };
+
+    inline bool IsAllCaps(std::string_view name)
+    {
+        bool upper = false;
+        for (char c : name)
+        {
+            if (std::islower(static_cast<unsigned char>(c)))
+                return false;
+            upper |= std::isupper(static_cast<unsigned char>(c)) != 0;
+        }
+        return upper && name.size() > 1;
+    }
+
+    // Index of the token closing the bracket at open, or end.
+    inline size_t MatchingClose(const std::vector<Token> &tokens, size_t open, size_t end, char openChar, char closeChar)
+    {
+        int depth = 0;
+        for (size_t i = open; i < end; i++)
+        {
+            if (tokens[i].text.size() == 1 && tokens[i].text[0] == openChar)
+                depth++;
+            else if (tokens[i].text.size() == 1 && tokens[i].text[0] == closeChar && --depth == 0)
+                return i;
+        }
+        return end;
+    }
+
+    // Decide what the '{' at tokens[end] opens, given the statement that
+    // started at tokens[begin], and record the definition it introduces.
+    inline Scope Classify(const std::vector<Token> &tokens, size_t begin, size_t end, const std::string &prefix, std::vector<Symbol> &symbols)
+    {
+        // Drop template parameter lists and [[attributes]].
+        std::vector<size_t> idx;
+        for (size_t i = begin; i < end; i++)
+        {
+            if (tokens[i].text == "template" && i + 1 < end && tokens[i + 1].text == "<")
+            {
+                i = MatchingClose(tokens, i + 1, end, '<', '>');
+                continue;
+            }
+            if (tokens[i].text == "[" && i + 1 < end && tokens[i + 1].text == "[")
+            {
+                i = MatchingClose(tokens, i, end, '[', ']');
+                continue;
+            }
+            idx.push_back(i);
+        }
+        auto text = [&](size_t k) { return tokens[idx[k]].text; };
+        size_t n = idx.size();
+        if (n == 0)
+            return {ScopeKind::Block, prefix};
+
+        size_t first = 0;
+        while (first < n && (text(first) == "inline" || text(first) == "export"))
+            first++;
+
+        // namespace a::b {
+        if (first < n && text(first) == "namespace")
+        {
+            std::string name;
+            for (size_t k = first + 1; k < n; k++)
+            {
+                if (tokens[idx[k]].ident)
+                    name += std::string(text(k));
+                else if (text(k) == "::")
+                    name += "::";
+            }
+            if (name.empty())
+                return {ScopeKind::Transparent, prefix};
+            symbols.push_back({prefix + name, Kind::Namespace, tokens[idx[first]].line});
+            return {ScopeKind::Namespace, prefix + name + "::"};
+        }
+        // extern "C" {
+        if (n == 2 && text(0) == "extern" && text(1) == "\"")
+            return {ScopeKind::Transparent, prefix};
+
+        // Locate the first top level '(' and '=' and a class key before them.
+        size_t paren = n, assign = n, key = n, op = n;
+        for (size_t k = 0; k < n; k++)
+        {
+            std::string_view t = text(k);
+            if (t == "operator" && op == n)
+            {
+                op = k;
+                // operator() keeps its own parentheses in the name.
+                if (k + 2 < n && text(k + 1) == "(" && text(k + 2) == ")")
+                    k += 2;
+                else
+                    while (k + 1 < n && text(k + 1) != "(")
+                        k++;
+                continue;
+            }
+            if ((t == "__attribute__" || t == "alignas" || t == "__declspec" || t == "decltype") && k + 1 < n && text(k + 1) == "(")
+            {
+                int depth = 0;
+                for (k++; k < n; k++)
+                {
+                    if (text(k) == "(")
+                        depth++;
+                    else if (text(k) == ")" && --depth == 0)
+                        break;
+                }
+                continue;
+            }
+            if (t == "(" && paren == n)
+                paren = k;
+            else if (t == "=" && assign == n && paren == n)
+                assign = k;
+            else if ((t == "class" || t == "struct" || t == "union" || t == "enum") && key == n && paren == n && assign == n)
+                key = k;
+        }
+
+        if (key < n && assign == n)
+        {
+            Kind kind = text(key) == "class" ? Kind::Class : text(key) == "struct" ? Kind::Struct
+                                                           : text(key) == "union"  ? Kind::Union
+                                                                                   : Kind::Enum;
+            size_t k = key + 1;
+            if (kind == Kind::Enum && k < n && (text(k) == "class" || text(k) == "struct"))
+                k++;
+            std::string name;
+            uint32_t line = tokens[idx[key]].line;
+            for (; k < n; k++)
+            {
+                std::string_view t = text(k);
+                if (t == ":")
+                    break;
+                if (t == "(")
+                {
+                    while (k < n && text(k) != ")")
+                        k++;
+                }
+                else if (t == "<")
+                {
+                    int depth = 0;
+                    for (; k < n; k++)
+                    {
+                        if (text(k) == "<")
+                            depth++;
+                        else if (text(k) == ">" && --depth == 0)
+                            break;
+                    }
+                }
+                else if (tokens[idx[k]].ident && t != "final")
+                {
+                    if (k > 0 && text(k - 1) == "::" && !name.empty())
+                        name += "::" + std::string(t);
+                    else
+                        name = std::string(t);
+                    line = tokens[idx[k]].line;
+                }
+            }
+            if (name.empty())
+                return {kind == Kind::Enum ? ScopeKind::Block : ScopeKind::Transparent, prefix};
+            symbols.push_back({prefix + name, kind, line});
+            if (kind == Kind::Enum)
+                return {ScopeKind::Block, prefix};
+            return {ScopeKind::Namespace, prefix + name + "::"};
+        }
+
+        if (paren == n || (assign < paren && op == n))
+            return {ScopeKind::Block, prefix};
+
+        // Function definition: the (qualified) name right before the parameter list.
+        std::string name;
+        size_t nameStart;
+        if (op < paren)
+        {
+            // operator==, operator(), operator bool ...
+            nameStart = op;
+            for (size_t k = op; k < paren; k++)
+            {
+                if (k > op && tokens[idx[k]].ident && tokens[idx[k - 1]].ident)
+                    name += " ";
+                name += std::string(text(k));
+            }
+        }
+        else
+        {
+            size_t k = paren - 1;
+            if (paren == 0)
+                return {ScopeKind::Block, prefix};
+            if (text(k) == ">")
+            {
+                // Explicit specialization: f<int>(...).
+                int depth = 0;
+                for (; k > 0; k--)
+                {
+                    if (text(k) == ">")
+                        depth++;
+                    else if (text(k) == "<" && --depth == 0)
+                        break;
+                }
+                if (k == 0)
+                    return {ScopeKind::Block, prefix};
+                k--;
+            }
+            if (!tokens[idx[k]].ident)
+                return {ScopeKind::Block, prefix};
+            static const std::vector<std::string_view> keywords{
+                "if", "for", "while", "switch", "catch", "return", "sizeof", "alignof", "static_assert",
+                "noexcept", "throw", "requires", "co_return", "co_await", "new", "delete"};
+            if (std::find(keywords.begin(), keywords.end(), text(k)) != keywords.end())
+                return {ScopeKind::Block, prefix};
+            name = std::string(text(k));
+            nameStart = k;
+            if (k > 0 && text(k - 1) == "~")
+            {
+                name = "~" + name;
+                nameStart = --k;
+            }
+            // Macro invocations such as TEST_CASE("...") { are not functions.
+            else if (IsAllCaps(name) && (k == 0 || text(k - 1) != "::"))
+                return {ScopeKind::Block, prefix};
+        }
+        while (nameStart >= 2 && text(nameStart - 1) == "::" && tokens[idx[nameStart - 2]].ident)
+        {
+            name = std::string(text(nameStart - 2)) + "::" + name;
+            nameStart -= 2;
+        }
+
+        // A ':' after the parameter list starts a constructor init list; a '{'
+        // directly after a member name there is a brace initializer.
+        size_t close = paren;
+        for (int depth = 0; close < n; close++)
+        {
+            if (text(close) == "(")
+                depth++;
+            else if (text(close) == ")" && --depth == 0)
+                break;
+        }
+        bool initList = false;
+        for (size_t k = close + 1; k < n; k++)
+            initList |= text(k) == ":";
+        std::string_view before = tokens[end - 1].text;
+        if (initList && (tokens[end - 1].ident || before == ">"))
+            return {ScopeKind::InitBrace, prefix};
+
+        symbols.push_back({prefix + name, Kind::Function, tokens[idx[nameStart]].line});
+        return {ScopeKind::Block, prefix};
+    }
+
+    // Extract all definitions from a C/C++ source.
+    inline std::vector<Symbol> Parse(const char *data, size_t size)
+    {
+        std::vector<Symbol> symbols;
+        std::vector<Token> tokens;
+        tokens.reserve(size / 4);
+        Tokenize(data, size, tokens, symbols);
+
+        std::vector<Scope> scopes{{ScopeKind::Transparent, ""}};
+        size_t statement = 0;
+        for (size_t i = 0; i < tokens.size(); i++)
+        {
+            std::string_view t = tokens[i].text;
+            if (scopes.back().kind == ScopeKind::Block)
+            {
+                if (t == "{")
+                {
+                    scopes.push_back({ScopeKind::Block, ""});
+                }
+                else if (t == "}")
+                {
+                    scopes.pop_back();
+                    if (scopes.back().kind != ScopeKind::Block)
+                        statement = i + 1;
+                }
+                continue;
+            }
+
+            if (t == ";")
+            {
+                statement = i + 1;
+            }
+            else if (t == "}")
+            {
+                if (scopes.size() > 1)
+                    scopes.pop_back();
+                statement = i + 1;
+            }
+            else if (t == ":" && i > statement && (tokens[i - 1].text == "public" || tokens[i - 1].text == "private" || tokens[i - 1].text == "protected"))
+            {
+                statement = i + 1;
+            }
+            else if (t == "{")
+            {
+                Scope scope = Classify(tokens, statement, i, scopes.back().prefix, symbols);
+                if (scope.kind == ScopeKind::InitBrace)
+                {
+                    for (int depth = 0; i < tokens.size(); i++)
+                    {
+                        if (tokens[i].text == "{")
+                            depth++;
+                        else if (tokens[i].text == "}" && --depth == 0)
+                            break;
+                    }
+                    continue;
+                }
+                scopes.push_back(std::move(scope));
+                statement = i + 1;
+            }
+        }
+        return symbols;
+    }
+
+    // ---- Index ----
+
+    // The symbol cache (see FileCache.hpp); the payload is varint
+    // symbolCount and per symbol u8 kind, varint line, string qualified name.
+    struct Format
+    {
+        using Entry = FileEntry;
+        static constexpr const char *MAGIC = "DCSY";
+        static constexpr const char *DIRECTORY = "symbols";
+        static const uint32_t VERSION = INDEX_VERSION;
+
+        static void Put(std::string &out, const FileEntry &file)
+        {
+            Binary::PutVarint(out, file.symbols.size());
+            for (const auto &symbol : file.symbols)
+            {
+                Binary::Put<uint8_t>(out, static_cast<uint8_t>(symbol.kind));
+                Binary::PutVarint(out, symbol.line);
+                Binary::PutString(out, symbol.name);
+            }
+        }
+
+        static bool Get(const char *data, size_t size, size_t &pos, FileEntry &file)
+        {
+            uint64_t count;
+            if (!Binary::GetVarint(data, size, pos, count) || count > size - pos)
+                return false;
+            file.symbols.resize(count);
+            for (auto &symbol : file.symbols)
+            {
+                uint8_t kind;
+                uint64_t line;
+                if (!Binary::Get(data, size, pos, kind) || kind > static_cast<uint8_t>(Kind::Macro) ||
+                    !Binary::GetVarint(data, size, pos, line) || !Binary::GetString(data, size, pos, symbol.name))
+                    return false;
+                symbol.kind = static_cast<Kind>(kind);
+                symbol.line = static_cast<uint32_t>(line);
+            }
+            return true;
+        }
+
+        static void Read(const std::string &path, FileEntry &entry)
+        {
+            if (entry.size == 0 || entry.size > MAX_FILE_SIZE)
+                return;
+            Binary::MappedFile mapped(path);
+            if (mapped.isOpen())
+                entry.symbols = Parse(mapped.data(), mapped.size());
+        }
+    };
+
+    // Bring the index of every project up to date. Returns the indexed files
+    // per project (in the order of projects) and counts reparsed files.
+    inline std::vector<std::vector<FileEntry>> UpdateIndex(const std::vector<DevCore::Project> &projects, size_t &reparsed)
+    {
+        std::vector<FileCache::Project> sources;
+        for (const auto &proj : projects)
+        {
+            FileCache::Project project{proj.lang + "/" + proj.folderName, proj.path, {}};
+            for (auto &path : DevCore::Files(proj))
+            {
+                if (IsSourceFile(path))
+                    project.paths.push_back(std::move(path));
+            }
+            sources.push_back(std::move(project));
+        }
+        return FileCache::Update<Format>(sources, reparsed);
+    }
+
+    inline bool Matches(const std::string &qualified, const std::string &query, bool glob)
+    {
+        if (glob)
+        {
+            size_t split = qualified.rfind("::");
+            const char *name = split == std::string::npos ? qualified.c_str() : qualified.c_str() + split + 2;
+            return fnmatch(query.c_str(), qualified.c_str(), 0) == 0 || fnmatch(query.c_str(), name, 0) == 0;
+        }
+        return qualified.size() >= query.size() &&
+               qualified.compare(qualified.size() - query.size(), query.size(), query) == 0 &&
+               (qualified.size() == query.size() ||
+                (qualified.size() >= query.size() + 2 && qualified.compare(qualified.size() - query.size() - 2, 2, "::") == 0));
+    }
+
+    // Print all definitions of name. name may be qualified ("DevMap::load")
+    // or a glob ("*Project*").
+    inline void Run(const std::string &name)
+    {
+        auto start = std::chrono::steady_clock::now();
+        size_t reparsed = 0;
+        std::vector<DevCore::Project> projects = DevCore::Projects();
+        auto files = UpdateIndex(projects, reparsed);
+
+        bool glob = name.find_first_of("*?[") != std::string::npos;
+        std::vector<std::vector<std::string>> rows;
+        size_t indexedFiles = 0;
+        for (size_t p = 0; p < files.size(); p++)
+        {
+            indexedFiles += files[p].size();
+            for (const auto &file : files[p])
+            {
+                for (const auto &symbol : file.symbols)
+                {
+                    if (Matches(symbol.name, name, glob))
+                        rows.push_back({KindName(symbol.kind), symbol.name, projects[p].name, file.path + ":" + std::to_string(symbol.line)});
+                }
+            }
+        }
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        if (rows.empty())
+            Canvas::PrintInfo("No definition of '" + name + "' found.");
+        else
+            Canvas::PrintTable(" Symbols ", {"Kind", "Symbol", "Project", "Location"}, rows, Canvas::Color::CYAN);
+        Canvas::PrintInfo(std::to_string(rows.size()) + " definitions in " + std::to_string(indexedFiles) + " source files (" +
+                          std::to_string(reparsed) + " parsed) in " + std::to_string(elapsed) + " ms.");
+    }
+} // namespace Symbols
+
+#endif // SYMBOLS_HPP
@@ -0,0 +1,306 @@
+#ifndef UPDATE_HPP
+#define UPDATE_HPP
+
+#include "../dependencies/Canvas.hpp"
+#include "../dependencies/Config.hpp"
+#include "Binary.hpp"
+#include "Build.hpp"
+#include "Main.hpp"
+#include "Process.hpp"
+#include <string>
+#include <vector>
+#include <set>
+#include <sstream>
+#include <iterator>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+
+// `devcore update`: rebuild devcore from a local source checkout without
+// any network access. Every translation unit is compiled into an object in
+// ~/.cache/devcore/update, together with the headers it includes (-MMD), so
+// only the units whose source or headers changed since the last update are
+// recompiled, in parallel. The new binary has to pass a smoke test before
+// it replaces the running one with a rename, which is atomic: a devcore
+// started meanwhile runs either the old or the new binary, never half of one.
+//
+// Without a checkout (`--source <dir>` or the source_path config key) the
+// old route is taken: clone from GitHub and run install.sh.
+namespace Update
+{
+    const std::string REPOSITORY = "https://github.com/mathlon26/DevCore-project-manager.git";
+
+    inline fs::path CachePath()
+    {
+        return fs::path(Main::HOME_PATH + Main::CACHE_PATH) / "update";
+    }
+
+    // The checkout to build from: the argument, or the source_path config
+    // key. Relative paths are taken from the home directory.
+    inline fs::path SourcePath(const std::string &argument)
+    {
+        std::string path = argument.empty() ? Config::getOr("source_path", "") : argument;
+        if (path.empty())
+            return {};
+        fs::path source(path);
+        if (source.is_relative() && argument.empty())
+            source = fs::path(Main::HOME_PATH) / source;
+        return fs::absolute(source).lexically_normal();
+    }
+
+    inline std::vector<std::string> SplitWords(const char *text)
+    {
+        std::istringstream words(text ? text : "");
+        return {std::istream_iterator<std::string>(words), std::istream_iterator<std::string>()};
+    }
+
+    // The files a dependency file (as written by -MMD) lists for its object.
+    inline std::vector<std::string> Prerequisites(const fs::path &depFile)
+    {
+        std::string text;
+        Binary::ReadInto(depFile.string(), text);
+        size_t colon = text.find(": ");
+        std::vector<std::string> files;
+        if (colon == std::string::npos)
+            return files;
+        std::istringstream words(text.substr(colon + 2));
+        std::string word;
+        while (words >> word)
+        {
+            if (word != "\\")
+                files.push_back(word);
+        }
+        return files;
+    }
+
+    // An object is current when it exists and is newer than its source and
+    // every header it included last time.
+    inline bool IsCurrent(const fs::path &object, const fs::path &depFile)
+    {
+        std::error_code ec;
+        auto built = fs::last_write_time(object, ec);
+        if (ec)
+            return false;
+        std::vector<std::string> files = Prerequisites(depFile);
+        if (files.empty())
+            return false;
+        for (const auto &file : files)
+        {
+            auto modified = fs::last_write_time(file, ec);
+            if (ec || modified > built)
+                return false;
+        }
+        return true;
+    }
+
+    // Compile what changed, link, smoke test and swap the binary in.
+    inline int FromSource(const fs::path &source)
+    {
+        auto start = std::chrono::steady_clock::now();
+        if (!fs::exists(source / "source" / "main.cpp"))
+        {
+            Canvas::PrintError("'" + source.string() + "' is not a DevCore checkout (source/main.cpp is missing).");
+            return 1;
+        }
+        std::error_code ec;
+        fs::path self = fs::read_symlink("/proc/self/exe", ec);
+        if (ec)
+        {
+            Canvas::PrintError("Unable to locate the running devcore binary: " + ec.message() + ".");
+            return 1;
+        }
+        fs::path cache = CachePath();
+        fs::create_directories(cache, ec);
+
+        // CXX, CXXFLAGS and LDFLAGS from the environment are honoured; when
+        // the compiler or flags change every object is rebuilt.
+        const char *cxxEnv = std::getenv("CXX");
+        std::vector<std::string> compiler{cxxEnv && *cxxEnv ? cxxEnv : "g++"};
+        std::vector<std::string> flags{"-O2"};
+        for (const auto &flag : SplitWords(std::getenv("CXXFLAGS")))
+            flags.push_back(flag);
+        std::string stamp = compiler[0];
+        for (const auto &flag : flags)
+            stamp += " " + flag;
+        stamp += "\n" + source.string() + "\n";
+        std::string previousStamp;
+        bool sameFlags = Binary::ReadInto((cache / "flags").string(), previousStamp) && previousStamp == stamp;
+
+        std::vector<fs::path> objects;
+        std::vector<std::vector<std::string>> commands;
+        for (const auto &entry : fs::directory_iterator(source / "source"))
+        {
+            if (entry.path().extension() != ".cpp")
+                continue;
+            fs::path object = cache / (entry.path().stem().string() + ".o");
+            fs::path depFile = cache / (entry.path().stem().string() + ".d");
+            objects.push_back(object);
+            if (sameFlags && IsCurrent(object, depFile))
+                continue;
+            std::vector<std::string> command = compiler;
+            command.insert(command.end(), flags.begin(), flags.end());
+            command.insert(command.end(), {"-MMD", "-MF", depFile.string(), "-c", entry.path().string(), "-o", object.string()});
+            commands.push_back(command);
+        }
+
+        if (!commands.empty())
+        {
+            Canvas::PrintInfo("Compiling " + std::to_string(commands.size()) + " of " + std::to_string(objects.size()) + " translation units from " + source.string());
+            Process::Options options;
+            options.captureErr = true;
+            options.closeInput = true;
+            options.directory = source.string();
+            bool failed = false;
+            for (const auto &result : Process::ExecuteAll(commands, options, Build::JobSlots()))
+            {
+                if (!result.err.empty())
+                    std::cerr << result.err;
+                failed = failed || result.exitCode != 0;
+            }
+            if (failed)
+            {
+                Canvas::PrintError("Compilation failed, devcore was not updated.");
+                return 1;
+            }
+            Binary::WriteAtomic((cache / "flags").string(), stamp);
+        }
+
+        fs::path binary = cache / "devcore";
+        bool relink = !commands.empty() || !fs::exists(binary);
+        if (relink)
+        {
+            std::vector<std::string> link = compiler;
+            link.insert(link.end(), flags.begin(), flags.end());
+            for (const auto &object : objects)
+                link.push_back(object.string());
+            link.insert(link.end(), {"-o", binary.string()});
+            for (const auto &flag : SplitWords(std::getenv("LDFLAGS")))
+                link.push_back(flag);
+            link.insert(link.end(), {"-lz", "-pthread"});
+            if (Process::Run(link) != 0)
+            {
+                fs::remove(binary, ec);
+                Canvas::PrintError("Linking failed, devcore was not updated.");
+                return 1;
+            }
+        }
+
+        if (Binary::SameContent(self.string(), binary.string()))
+        {
+            Canvas::PrintSuccess("DevCore is already up to date.");
+            return 0;
+        }
+
+        // The smoke test: the new binary has to start and report its version.
+        // It does not open the DevMap, which a broken build could rewrite.
+        Process::Options smoke;
+        smoke.captureOut = true;
+        smoke.captureErr = true;
+        smoke.closeInput = true;
+        smoke.timeout = 10;
+        Process::Result result = Process::Execute({binary.string(), "version"}, smoke);
+        if (result.exitCode != 0 || result.out.find("DevCore") == std::string::npos)
+        {
+            std::cerr << result.out << result.err;
+            Canvas::PrintError(std::string("The new binary failed its smoke test") + (result.timedOut ? " (timed out)" : "") + ", devcore was not updated.");
+            return 1;
+        }
+
+        // Copy next to the installed binary first: rename only replaces
+        // atomically within one filesystem.
+        fs::path staged = self.parent_path() / ("." + self.filename().string() + ".new." + std::to_string(getpid()));
+        fs::copy_file(binary, staged, fs::copy_options::overwrite_existing, ec);
+        if (!ec)
+            fs::permissions(staged, fs::perms::owner_all | fs::perms::group_read | fs::perms::group_exec | fs::perms::others_read | fs::perms::others_exec, ec);
+        if (!ec && std::rename(staged.c_str(), self.c_str()) != 0)
+            ec = std::error_code(errno, std::generic_category());
+        if (ec)
+        {
+            std::string reason = ec.message();
+            fs::remove(staged, ec);
+            Canvas::PrintError("Unable to replace " + self.string() + ": " + reason +
+                               ". Run the update with permission to write to " + self.parent_path().string() + ".");
+            return 1;
+        }
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::string version = result.out.substr(0, result.out.find('\n'));
+        Canvas::PrintSuccess("Updated " + self.string() + " to " + version + " in " + Build::formatSeconds(seconds) + ".");
+        return 0;
+    }
+
+    // The original update: clone the repository and run its install.sh.
+    inline int FromGitHub()
+    {
+        // Define paths for convenience.
+        std::string homeDir           = Main::HOME_PATH;
+        std::string tempRepoDir       = homeDir + "/DevCore-project-manager-temp";
+        std::string installScriptPath = homeDir + "/install.sh";
+        std::string installedRepoDir  = homeDir + "/DevCore-project-manager";
+
+        // Clone the repository to a temporary directory.
+        std::error_code ec;
+        fs::remove_all(tempRepoDir, ec);
+        if (Process::Run({"git", "clone", REPOSITORY, tempRepoDir}) != 0)
+        {
+            Canvas::PrintError("Failed to clone the repository.");
+            fs::remove_all(tempRepoDir, ec);
+            return 1;
+        }
+
+        // Move install.sh from the temporary repository to the home directory.
+        fs::rename(tempRepoDir + "/install.sh", installScriptPath, ec);
+        if (ec)
+        {
+            Canvas::PrintError("Failed to move install.sh to the home directory.");
+            fs::remove_all(tempRepoDir, ec);
+            fs::remove(installScriptPath, ec);
+            return 1;
+        }
+
+        // Clean up the temporary repository directory.
+        fs::remove_all(tempRepoDir, ec);
+
+        // Remove any existing installed repository to avoid conflicts.
+        fs::remove_all(installedRepoDir, ec);
+
+        // Set executable permissions on install.sh.
+        fs::permissions(installScriptPath, fs::perms::owner_exec | fs::perms::group_exec | fs::perms::others_exec, fs::perm_options::add, ec);
+        if (ec)
+        {
+            Canvas::PrintError("Failed to update permissions of install.sh.");
+            fs::remove(installScriptPath, ec);
+            return 1;
+        }
+
+        setenv("HOME_TEMP", getenv("HOME"), 0);
+        setenv("HOME_TEMP", getenv("HOME"), 1);
+
+        // Run install.sh using sudo.
+        if (Process::Run({installScriptPath}) != 0)
+        {
+            Canvas::PrintError("Failed to run install.sh.");
+            // Cleanup in case of failure: remove install.sh and any installed repository.
+            fs::remove(installScriptPath, ec);
+            fs::remove_all(installedRepoDir, ec);
+            return 1;
+        }
+
+        // Remove install.sh after it has been executed.
+        fs::remove(installScriptPath, ec);
+
+        Canvas::PrintInfo("Update complete.");
+        return 0;
+    }
+
+    inline int Run(const std::string &sourceArgument)
+    {
+        fs::path source = SourcePath(sourceArgument);
+        if (source.empty())
+            return FromGitHub();
+        return FromSource(source);
+    }
+} // namespace Update
+
+#endif // UPDATE_HPP
@@ -0,0 +1,159 @@
+#ifndef WALKER_HPP
+#define WALKER_HPP
+
+#include "Ignore.hpp"
+#include "Parallel.hpp"
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <limits>
+#include <dirent.h>
+#include <sys/stat.h>
+
+// Parallel directory walker over many project roots.
+//
+// Every worker owns a deque of directories. It pushes the subdirectories it
+// finds onto the back of its own deque and pops from there (depth first, warm
+// caches); an idle worker steals from the front of another worker's deque,
+// taking the oldest and usually largest subtrees. One big project therefore
+// spreads over all threads instead of pinning a single one.
+namespace Walker
+{
+    struct Root
+    {
+        std::string path;
+        Ignore::Rules rules;
+    };
+
+    // Walk all roots. onFile(root, worker, path, relative) is called for every
+    // regular file that is not ignored, onRootDone(root) once all files of a
+    // root have been visited. Both may be called from any worker thread;
+    // worker is in [0, WorkerCount(limit)) and can index per-thread buffers.
+    template <typename FileFn, typename DoneFn>
+    inline void Walk(const std::vector<Root> &roots, FileFn &&onFile, DoneFn &&onRootDone, unsigned limit = 0)
+    {
+        if (roots.empty())
+            return;
+
+        struct Task
+        {
+            size_t root;
+            std::string path;
+            std::string relative;
+        };
+        struct Queue
+        {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        unsigned threads = Parallel::ThreadCount(std::numeric_limits<size_t>::max(), limit);
+        std::vector<Queue> queues(threads);
+        std::unique_ptr<std::atomic<size_t>[]> rootPending(new std::atomic<size_t>[roots.size()]);
+        std::atomic<size_t> pending{roots.size()};
+        for (size_t i = 0; i < roots.size(); i++)
+        {
+            rootPending[i] = 1;
+            queues[i % threads].tasks.push_back({i, roots[i].path, ""});
+        }
+
+        auto processDirectory = [&](const Task &task, unsigned worker) {
+            const Ignore::Rules &rules = roots[task.root].rules;
+            DIR *dir = opendir(task.path.c_str());
+            if (!dir)
+                return;
+            while (dirent *entry = readdir(dir))
+            {
+                const char *name = entry->d_name;
+                if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0')))
+                    continue;
+
+                std::string path = task.path + "/" + name;
+                std::string relative = task.relative.empty() ? std::string(name) : task.relative + "/" + name;
+                unsigned char type = entry->d_type;
+                if (type == DT_UNKNOWN)
+                {
+                    struct stat st;
+                    if (lstat(path.c_str(), &st) != 0)
+                        continue;
+                    type = S_ISDIR(st.st_mode) ? DT_DIR : S_ISREG(st.st_mode) ? DT_REG : DT_LNK;
+                }
+
+                if (type == DT_DIR)
+                {
+                    if (rules.Matches(relative, true))
+                        continue;
+                    pending++;
+                    rootPending[task.root]++;
+                    std::lock_guard<std::mutex> lock(queues[worker].mutex);
+                    queues[worker].tasks.push_back({task.root, std::move(path), std::move(relative)});
+                }
+                else if (type == DT_REG && !rules.Matches(relative, false))
+                {
+                    onFile(task.root, worker, path, relative);
+                }
+            }
+            closedir(dir);
+        };
+
+        auto work = [&](unsigned worker) {
+            while (true)
+            {
+                Task task;
+                bool found = false;
+                {
+                    std::lock_guard<std::mutex> lock(queues[worker].mutex);
+                    if (!queues[worker].tasks.empty())
+                    {
+                        task = std::move(queues[worker].tasks.back());
+                        queues[worker].tasks.pop_back();
+                        found = true;
+                    }
+                }
+                for (unsigned k = 1; !found && k < threads; k++)
+                {
+                    Queue &victim = queues[(worker + k) % threads];
+                    std::lock_guard<std::mutex> lock(victim.mutex);
+                    if (!victim.tasks.empty())
+                    {
+                        task = std::move(victim.tasks.front());
+                        victim.tasks.pop_front();
+                        found = true;
+                    }
+                }
+
+                if (!found)
+                {
+                    if (pending.load() == 0)
+                        return;
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                processDirectory(task, worker);
+                if (--rootPending[task.root] == 0)
+                    onRootDone(task.root);
+                pending--;
+            }
+        };
+
+        std::vector<std::thread> pool;
+        for (unsigned t = 1; t < threads; t++)
+            pool.emplace_back(work, t);
+        work(0);
+        for (auto &thread : pool)
+            thread.join();
+    }
+
+    // Number of workers Walk will use for a given limit.
+    inline unsigned WorkerCount(unsigned limit = 0)
+    {
+        return Parallel::ThreadCount(std::numeric_limits<size_t>::max(), limit);
+    }
+} // namespace Walker
+
+#endif // WALKER_HPP
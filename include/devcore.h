@@ -0,0 +1,86 @@
+#ifndef DEVCORE_H
+#define DEVCORE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* The C ABI of libdevcore (build/libdevcore.so), for callers that are not
+ * C++: the Python bindings in python/devcore.py load it with ctypes. It is
+ * a thin layer over DevCore.hpp with the same rules: one store per process,
+ * calls are not thread-safe among themselves, and failures return 0 (or
+ * NULL) with the message in devcore_last_error().
+ *
+ * Strings are UTF-8 and owned by the library. A project record stays valid
+ * until the list it came from is freed. The fields mean what they mean in
+ * DevCore::Project (include/DevCore.hpp), including which of them count
+ * ignored files. */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct devcore_project
+{
+    const char *name;        /* Name in the DevMap. */
+    const char *folder_name; /* Folder inside the language directory. */
+    const char *lang;        /* Language (the directory the folder is in). */
+    const char *path;        /* Absolute path of the project folder. */
+    const char *created_by;
+    const char *git_branch; /* Empty without git. */
+    int64_t created_at;     /* Times are seconds since the epoch, 0 when unknown. */
+    int64_t last_activity;  /* Newest modification of a file that is not ignored. */
+    int64_t last_commit;
+    int64_t last_build;     /* End of the last successful `devcore build`. */
+    uint64_t size;          /* Bytes in all files. */
+    uint64_t allocated_size; /* Bytes allocated on disk. */
+    uint64_t file_count;    /* Regular files. */
+    uint64_t dir_count;     /* Directories. */
+    uint64_t lines;         /* Lines of code, counted by the last scan. */
+    int32_t uses_git;
+    int32_t git_dirty;
+    size_t dependency_count;
+    const char *const *dependencies; /* Names of the projects this one depends on. */
+} devcore_project;
+
+typedef void (*devcore_message_fn)(const char *message, void *user);
+typedef void (*devcore_progress_fn)(size_t done, size_t total, void *user);
+
+/* Any member may be NULL. user is passed back to every callback. */
+typedef struct devcore_callbacks
+{
+    devcore_message_fn info;
+    devcore_message_fn error;
+    devcore_progress_fn progress;
+    void *user;
+} devcore_callbacks;
+
+/* A snapshot of projects; the store may change after it was taken. */
+typedef struct devcore_list devcore_list;
+
+/* Load the config and the DevMap and synchronize it with the projects
+ * folder. NULL or empty paths mean the files of the current user. */
+int devcore_open(const char *config_file, const char *devmap_file, const devcore_callbacks *callbacks);
+int devcore_is_open(void);
+
+/* Rescan every project and write the DevMap. */
+int devcore_sync(const devcore_callbacks *callbacks);
+
+const char *devcore_last_error(void);
+const char *devcore_projects_path(void);
+
+devcore_list *devcore_projects(void);
+devcore_list *devcore_projects_by_language(const char *lang);
+devcore_list *devcore_projects_by_user(const char *user);
+devcore_list *devcore_find_project(const char *name); /* Zero or one project. */
+
+size_t devcore_list_size(const devcore_list *list);
+/* The records as one array of devcore_list_size() entries. */
+const devcore_project *devcore_list_data(const devcore_list *list);
+const devcore_project *devcore_list_get(const devcore_list *list, size_t index);
+void devcore_list_free(devcore_list *list);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DEVCORE_H */
@@ -0,0 +1,232 @@
+"""Python bindings for libdevcore (include/devcore.h), through ctypes.
+
+Reads the DevMap in-process: no devcore commands are spawned and no tables
+are parsed.
+
+    import devcore
+
+    devcore.open_devcore()
+    for project in devcore.projects_by_language("C++"):
+        print(project.name, project.size, project.last_activity)
+
+The library is looked up in $DEVCORE_LIB, then next to this checkout
+(build/libdevcore.so, built by run.sh), then on the loader path. Failures
+raise devcore.Error with the message of devcore_last_error().
+"""
+
+import ctypes
+import os
+
+__all__ = [
+    "Error", "Project", "open_devcore", "is_open", "sync", "projects_path",
+    "projects", "projects_by_language", "projects_by_user", "find_project",
+]
+
+
+class Error(Exception):
+    pass
+
+
+class _Project(ctypes.Structure):
+    _fields_ = [
+        ("name", ctypes.c_char_p),
+        ("folder_name", ctypes.c_char_p),
+        ("lang", ctypes.c_char_p),
+        ("path", ctypes.c_char_p),
+        ("created_by", ctypes.c_char_p),
+        ("git_branch", ctypes.c_char_p),
+        ("created_at", ctypes.c_int64),
+        ("last_activity", ctypes.c_int64),
+        ("last_commit", ctypes.c_int64),
+        ("last_build", ctypes.c_int64),
+        ("size", ctypes.c_uint64),
+        ("allocated_size", ctypes.c_uint64),
+        ("file_count", ctypes.c_uint64),
+        ("dir_count", ctypes.c_uint64),
+        ("lines", ctypes.c_uint64),
+        ("uses_git", ctypes.c_int32),
+        ("git_dirty", ctypes.c_int32),
+        ("dependency_count", ctypes.c_size_t),
+        ("dependencies", ctypes.POINTER(ctypes.c_char_p)),
+    ]
+
+
+_MessageFn = ctypes.CFUNCTYPE(None, ctypes.c_char_p, ctypes.c_void_p)
+_ProgressFn = ctypes.CFUNCTYPE(None, ctypes.c_size_t, ctypes.c_size_t, ctypes.c_void_p)
+
+
+class _Callbacks(ctypes.Structure):
+    _fields_ = [
+        ("info", _MessageFn),
+        ("error", _MessageFn),
+        ("progress", _ProgressFn),
+        ("user", ctypes.c_void_p),
+    ]
+
+
+class Project:
+    """One project record. Times are seconds since the epoch (0 when unknown).
+
+    The fields are those of DevCore::Project in include/DevCore.hpp, which
+    documents which of them count ignored files.
+    """
+
+    __slots__ = ("name", "folder_name", "lang", "path", "created_by", "git_branch",
+                 "created_at", "last_activity", "last_commit", "last_build",
+                 "size", "allocated_size", "file_count", "dir_count", "lines",
+                 "uses_git", "git_dirty", "dependencies")
+
+    def __repr__(self):
+        return "Project(%r, lang=%r, size=%d)" % (self.name, self.lang, self.size)
+
+
+def _find_library():
+    candidates = []
+    if os.environ.get("DEVCORE_LIB"):
+        candidates.append(os.environ["DEVCORE_LIB"])
+    here = os.path.dirname(os.path.abspath(__file__))
+    candidates.append(os.path.join(here, "..", "build", "libdevcore.so"))
+    candidates.append("libdevcore.so")
+    for candidate in candidates:
+        try:
+            return ctypes.CDLL(candidate)
+        except OSError:
+            continue
+    raise Error("libdevcore.so not found (build it with run.sh or set DEVCORE_LIB)")
+
+
+_lib = _find_library()
+_List = ctypes.c_void_p
+_lib.devcore_open.argtypes = [ctypes.c_char_p, ctypes.c_char_p, ctypes.POINTER(_Callbacks)]
+_lib.devcore_open.restype = ctypes.c_int
+_lib.devcore_is_open.argtypes = []
+_lib.devcore_is_open.restype = ctypes.c_int
+_lib.devcore_sync.argtypes = [ctypes.POINTER(_Callbacks)]
+_lib.devcore_sync.restype = ctypes.c_int
+_lib.devcore_last_error.argtypes = []
+_lib.devcore_last_error.restype = ctypes.c_char_p
+_lib.devcore_projects_path.argtypes = []
+_lib.devcore_projects_path.restype = ctypes.c_char_p
+_lib.devcore_projects.argtypes = []
+_lib.devcore_projects.restype = _List
+for _query in (_lib.devcore_projects_by_language, _lib.devcore_projects_by_user, _lib.devcore_find_project):
+    _query.argtypes = [ctypes.c_char_p]
+    _query.restype = _List
+_lib.devcore_list_size.argtypes = [_List]
+_lib.devcore_list_size.restype = ctypes.c_size_t
+_lib.devcore_list_data.argtypes = [_List]
+_lib.devcore_list_data.restype = ctypes.POINTER(_Project)
+_lib.devcore_list_free.argtypes = [_List]
+_lib.devcore_list_free.restype = None
+
+
+def _decode(text):
+    return text.decode("utf-8", "replace") if text else ""
+
+
+def _fail():
+    raise Error(_decode(_lib.devcore_last_error()))
+
+
+_active = None  # The library keeps the last callbacks installed.
+
+
+def _callbacks(on_info, on_error, on_progress):
+    # The C function objects must outlive the call, so they are kept on
+    # the structure, which stays referenced until it is replaced.
+    global _active
+    callbacks = _Callbacks()
+    callbacks._keep = []
+    if on_info:
+        callbacks.info = _MessageFn(lambda message, user: on_info(_decode(message)))
+        callbacks._keep.append(callbacks.info)
+    if on_error:
+        callbacks.error = _MessageFn(lambda message, user: on_error(_decode(message)))
+        callbacks._keep.append(callbacks.error)
+    if on_progress:
+        callbacks.progress = _ProgressFn(lambda done, total, user: on_progress(done, total))
+        callbacks._keep.append(callbacks.progress)
+    _active = callbacks
+    return callbacks
+
+
+def _records(handle):
+    if not handle:
+        _fail()
+    try:
+        count = _lib.devcore_list_size(handle)
+        data = _lib.devcore_list_data(handle)
+        result = []
+        for i in range(count):
+            record = data[i]
+            project = Project()
+            project.name = _decode(record.name)
+            project.folder_name = _decode(record.folder_name)
+            project.lang = _decode(record.lang)
+            project.path = _decode(record.path)
+            project.created_by = _decode(record.created_by)
+            project.git_branch = _decode(record.git_branch)
+            project.created_at = record.created_at
+            project.last_activity = record.last_activity
+            project.last_commit = record.last_commit
+            project.last_build = record.last_build
+            project.size = record.size
+            project.allocated_size = record.allocated_size
+            project.file_count = record.file_count
+            project.dir_count = record.dir_count
+            project.lines = record.lines
+            project.uses_git = bool(record.uses_git)
+            project.git_dirty = bool(record.git_dirty)
+            project.dependencies = [_decode(record.dependencies[j]) for j in range(record.dependency_count)]
+            result.append(project)
+        return result
+    finally:
+        _lib.devcore_list_free(handle)
+
+
+def _encode(text):
+    return text.encode("utf-8") if text else None
+
+
+def open_devcore(config_file=None, devmap_file=None, on_info=None, on_error=None, on_progress=None):
+    """Load the config and the DevMap and synchronize it with the projects folder.
+
+    Without paths the files of the current user are used. on_progress(done, total)
+    may be called from scanning threads.
+    """
+    callbacks = _callbacks(on_info, on_error, on_progress)
+    if not _lib.devcore_open(_encode(config_file), _encode(devmap_file), ctypes.byref(callbacks)):
+        _fail()
+
+
+def is_open():
+    return bool(_lib.devcore_is_open())
+
+
+def sync(on_info=None, on_error=None, on_progress=None):
+    """Rescan every project and write the DevMap."""
+    callbacks = _callbacks(on_info, on_error, on_progress)
+    if not _lib.devcore_sync(ctypes.byref(callbacks)):
+        _fail()
+
+
+def projects_path():
+    return _decode(_lib.devcore_projects_path())
+
+
+def projects():
+    return _records(_lib.devcore_projects())
+
+
+def projects_by_language(lang):
+    return _records(_lib.devcore_projects_by_language(_encode(lang) or b""))
+
+
+def projects_by_user(user):
+    return _records(_lib.devcore_projects_by_user(_encode(user) or b""))
+
+
+def find_project(name):
+    """The project with this name, or None."""
+    found = _records(_lib.devcore_find_project(_encode(name) or b""))
+    return found[0] if found else None
@@ -1 +1,16 @@
-g++ source/*.cpp -o devcore
+set -e
+CXX=${CXX:-g++}
+mkdir -p build
+
+# libdevcore: the project store, scanning and persistence. build/libdevcore.a
+# for C++ (include/DevCore.hpp), build/libdevcore.so for the C ABI
+# (include/devcore.h) and the Python bindings (python/devcore.py). Only
+# source/DevMap.cpp needs nlohmann/json.
+$CXX -O2 -fPIC $CXXFLAGS -c source/DevMap.cpp -o build/DevMap.o
+$CXX -O2 -fPIC $CXXFLAGS -c source/DevCore.cpp -o build/DevCore.o
+$CXX -O2 -fPIC $CXXFLAGS -c source/DevCoreC.cpp -o build/DevCoreC.o
+ar rcs build/libdevcore.a build/DevMap.o build/DevCore.o build/DevCoreC.o
+$CXX -shared build/DevMap.o build/DevCore.o build/DevCoreC.o -o build/libdevcore.so $LDFLAGS -lz -pthread
+
+# The command line client, which only talks to the store through DevCore.hpp
+$CXX -O2 $CXXFLAGS source/main.cpp build/libdevcore.a -o devcore $LDFLAGS -lz -pthread
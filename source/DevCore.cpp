@@ -0,0 +1,362 @@
+#include "../include/DevCore.hpp"
+#include "../dependencies/Config.hpp"
+#include "../include/DevMap.hpp"
+#include "../include/FileIndex.hpp"
+#include "../include/Graph.hpp"
+#include "../include/Main.hpp"
+#include "../include/Parallel.hpp"
+#include "../include/Stats.hpp"
+
+namespace DevCore
+{
+    namespace
+    {
+        std::string lastError;
+        bool opened = false;
+
+        // Route the core's reports to the callbacks instead of the terminal.
+        void Install(const Callbacks &callbacks)
+        {
+            DevMap::events.info = [info = callbacks.info](const std::string &message) {
+                if (info)
+                    info(message);
+            };
+            DevMap::events.error = [error = callbacks.error](const std::string &message) {
+                lastError = message;
+                if (error)
+                    error(message);
+            };
+            DevMap::events.progress = callbacks.progress;
+        }
+
+        bool Fail(const std::string &message)
+        {
+            DevMap::events.error(message);
+            return false;
+        }
+
+        Project ToProject(const DevMap::Project &proj)
+        {
+            Project project;
+            project.name = proj.name;
+            project.folderName = proj.folderName;
+            project.lang = proj.lang;
+            project.path = (DevMap::projectsPath / proj.lang / proj.folderName).string();
+            project.createdBy = proj.createdBy;
+            project.createdAt = proj.createdAt;
+            project.size = proj.size;
+            project.allocatedSize = proj.allocatedSize;
+            project.fileCount = proj.fileCount;
+            project.dirCount = proj.dirCount;
+            project.lines = proj.lines;
+            project.lastActivity = proj.lastActivity;
+            project.usesGit = proj.usesGit;
+            project.gitBranch = proj.gitBranch;
+            project.lastCommit = proj.lastCommit;
+            project.gitDirty = proj.gitDirty;
+            project.lastBuild = proj.lastBuild;
+            project.dependencies = proj.dependencies;
+            project.gitReclaimed = proj.gitReclaimed;
+            project.gitMaintainedAt = proj.gitMaintainedAt;
+            project.largestFiles = proj.largestFiles;
+            project.largestDirs = proj.largestDirs;
+            project.buildDirs = proj.buildDirs;
+            return project;
+        }
+
+        // The stored project in the folder of project, or nullptr after
+        // reporting the failure.
+        DevMap::Project *Stored(const Project &project)
+        {
+            if (!opened)
+            {
+                Fail("No DevMap is open");
+                return nullptr;
+            }
+            DevMap::Project key;
+            key.lang = project.lang;
+            key.folderName = project.folderName;
+            DevMap::Project *stored = DevMap::findProject(key);
+            if (!stored)
+                Fail("Project '" + project.name + "' is not in the DevMap");
+            return stored;
+        }
+
+        template <typename Predicate>
+        std::vector<Project> Select(Predicate &&keep)
+        {
+            std::vector<Project> selected;
+            for (const auto &proj : DevMap::projects)
+            {
+                if (keep(proj))
+                    selected.push_back(ToProject(proj));
+            }
+            return selected;
+        }
+    } // namespace
+
+    bool Open(const std::string &configFile, const std::string &devmapFile, const Callbacks &callbacks)
+    {
+        Install(callbacks);
+        lastError.clear();
+        opened = false;
+
+        Config::configMap.clear();
+        std::string config = configFile.empty() ? Main::HOME_PATH + Main::CONFIG_PATH : configFile;
+        if (!Config::load(config))
+            return Fail("Unable to read the config file " + config);
+        // Config::get would exit the process over a missing key.
+        std::string projectsPath = Config::getOr("projects_path", "");
+        if (projectsPath.empty())
+            return Fail("Required key 'projects_path' is not found in " + config +
+                        ". Add 'projects_path = <projects_path>' to it, relative to your home folder.");
+
+        std::string devmap = devmapFile.empty() ? Main::HOME_PATH + Main::DEVMAP_PATH : devmapFile;
+        if (!DevMap::load(devmap, Main::HOME_PATH + projectsPath))
+            return false;
+        opened = true;
+        return true;
+    }
+
+    bool Save()
+    {
+        if (!opened)
+            return Fail("No DevMap is open");
+        return DevMap::save();
+    }
+
+    bool CreateDevMap(const std::string &devmapFile)
+    {
+        return DevMap::create(devmapFile.empty() ? Main::HOME_PATH + Main::DEVMAP_PATH : devmapFile);
+    }
+
+    std::string DevMapText()
+    {
+        return opened ? DevMap::text() : "";
+    }
+
+    bool IsOpen()
+    {
+        return opened;
+    }
+
+    bool Sync(const Callbacks &callbacks)
+    {
+        Install(callbacks);
+        if (!opened)
+            return Fail("No DevMap is open");
+        lastError.clear();
+        DevMap::syncDevMap();
+        return lastError.empty();
+    }
+
+    const std::string &LastError()
+    {
+        return lastError;
+    }
+
+    std::string ProjectsPath()
+    {
+        return DevMap::projectsPath.string();
+    }
+
+    std::vector<Project> Projects()
+    {
+        return Select([](const DevMap::Project &) { return true; });
+    }
+
+    std::vector<Project> ProjectsByLanguage(const std::string &lang)
+    {
+        return Select([&](const DevMap::Project &proj) { return proj.lang == lang; });
+    }
+
+    std::vector<Project> ProjectsByUser(const std::string &user)
+    {
+        return Select([&](const DevMap::Project &proj) { return proj.createdBy == user; });
+    }
+
+    bool FindProject(const std::string &name, Project &project)
+    {
+        const DevMap::Project *found = DevMap::findProjectByName(DevMap::projects, name);
+        if (found)
+            project = ToProject(*found);
+        return found != nullptr;
+    }
+
+    std::vector<std::string> Languages()
+    {
+        return DevMap::languages;
+    }
+
+    std::vector<std::string> Users()
+    {
+        return std::vector<std::string>(DevMap::users.begin(), DevMap::users.end());
+    }
+
+    std::vector<std::string> Templates(const std::string &lang)
+    {
+        return DevMap::templateNames(lang);
+    }
+
+    std::vector<std::string> Templates()
+    {
+        return DevMap::templateNames();
+    }
+
+    bool CreateProject(const std::string &name, const std::string &lang, const std::string &folderName,
+                       const std::string &templateName, bool initGit)
+    {
+        if (!opened)
+            return Fail("No DevMap is open");
+        DevMap::Project proj;
+        proj.name = name;
+        proj.folderName = folderName.empty() ? name : folderName;
+        proj.lang = lang;
+        return DevMap::addProject(proj, templateName, initGit);
+    }
+
+    bool DeleteProject(const Project &project)
+    {
+        DevMap::Project *stored = Stored(project);
+        return stored && DevMap::deleteProject(*stored);
+    }
+
+    bool CreateLanguage(const std::string &lang)
+    {
+        if (!opened)
+            return Fail("No DevMap is open");
+        return DevMap::createLanguage(lang);
+    }
+
+    bool DeleteLanguage(const std::string &lang)
+    {
+        if (!opened)
+            return Fail("No DevMap is open");
+        return DevMap::deleteLanguage(lang);
+    }
+
+    bool AddTemplate(const std::string &lang, const std::string &name, const std::string &source)
+    {
+        if (!opened)
+            return Fail("No DevMap is open");
+        return DevMap::addTemplate(lang, name, source);
+    }
+
+    bool RemoveTemplate(const std::string &lang, const std::string &name)
+    {
+        if (!opened)
+            return Fail("No DevMap is open");
+        return DevMap::removeTemplate(lang, name);
+    }
+
+    bool SetDependencies(const Project &project, const std::vector<std::string> &dependencies)
+    {
+        DevMap::Project *stored = Stored(project);
+        if (!stored)
+            return false;
+        for (const auto &name : dependencies)
+        {
+            if (!DevMap::findProjectByName(DevMap::projects, name))
+                return Fail("Project '" + name + "' does not exist.");
+        }
+
+        std::vector<std::string> previous = stored->dependencies;
+        stored->dependencies = dependencies;
+        std::vector<std::string> missing;
+        std::vector<size_t> cycle = Graph::FindCycle(Graph::FromProjects(DevMap::projects, missing));
+        if (!cycle.empty())
+        {
+            stored->dependencies = previous;
+            return Fail("Dependency cycle: " + Graph::CycleToString(DevMap::projects, cycle) + ".");
+        }
+        DevMap::store(*stored);
+        return true;
+    }
+
+    bool RecordBuild(const Project &project, time_t finished)
+    {
+        DevMap::Project *stored = Stored(project);
+        if (!stored)
+            return false;
+        stored->lastBuild = finished;
+        DevMap::store(*stored);
+        return true;
+    }
+
+    bool RecordMaintenance(const Project &project, uint64_t reclaimed, time_t when)
+    {
+        DevMap::Project *stored = Stored(project);
+        if (!stored)
+            return false;
+        stored->gitReclaimed = reclaimed;
+        stored->gitMaintainedAt = when;
+        DevMap::store(*stored);
+        return true;
+    }
+
+    bool Rescan(std::vector<Project> &projects)
+    {
+        std::vector<DevMap::Project *> stored;
+        for (const auto &project : projects)
+        {
+            stored.push_back(Stored(project));
+            if (!stored.back())
+                return false;
+        }
+        Parallel::ForEach(stored.size(), [&](size_t i) { DevMap::scanProject(*stored[i]); });
+        for (size_t i = 0; i < stored.size(); i++)
+        {
+            DevMap::store(*stored[i]);
+            projects[i] = ToProject(*stored[i]);
+        }
+        if (!FileIndex::Save())
+            return Fail("Unable to write the filename index");
+        return true;
+    }
+
+    bool CountLines(std::vector<std::map<std::string, LineCounts>> *byLanguage)
+    {
+        if (!opened)
+            return Fail("No DevMap is open");
+        auto files = DevMap::refreshLineCounts();
+        if (!byLanguage)
+            return true;
+        byLanguage->assign(files.size(), {});
+        for (size_t i = 0; i < files.size(); i++)
+        {
+            for (const auto &entry : Stats::ByLanguage(files[i]))
+            {
+                LineCounts &counts = (*byLanguage)[i][entry.first];
+                counts.files = entry.second.files;
+                counts.code = entry.second.code;
+                counts.comment = entry.second.comment;
+                counts.blank = entry.second.blank;
+            }
+        }
+        return true;
+    }
+
+    std::vector<std::string> Files(const Project &project)
+    {
+        return FileIndex::Paths(project.lang + "/" + project.folderName);
+    }
+
+    std::vector<FileMatch> FindFiles(const std::string &glob)
+    {
+        std::map<std::string, std::string> names;
+        for (const auto &proj : DevMap::projects)
+            names[proj.lang + "/" + proj.folderName] = proj.name;
+        std::vector<FileMatch> matches;
+        for (auto &match : FileIndex::Find(glob))
+        {
+            auto name = names.find(match.first);
+            matches.push_back({name != names.end() ? name->second : match.first, match.first, std::move(match.second)});
+        }
+        return matches;
+    }
+
+    size_t IndexedFileCount()
+    {
+        return FileIndex::FileCount();
+    }
+} // namespace DevCore
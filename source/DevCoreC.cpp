@@ -0,0 +1,169 @@
+#include "../include/devcore.h"
+#include "../include/DevCore.hpp"
+#include <exception>
+#include <new>
+
+// The list owns the C++ records; the C view points into them.
+struct devcore_list
+{
+    std::vector<DevCore::Project> projects;
+    std::vector<devcore_project> view;
+    std::vector<std::vector<const char *>> dependencies;
+};
+
+namespace
+{
+    std::string projectsPath;
+    std::string exceptionError; // What the last call threw, if anything.
+
+    // Exceptions must not unwind into C callers: report them as failures.
+    template <typename Result, typename Call>
+    Result Guard(Result failed, Call &&call)
+    {
+        exceptionError.clear();
+        try
+        {
+            return call();
+        }
+        catch (const std::exception &e)
+        {
+            exceptionError = e.what();
+        }
+        catch (...)
+        {
+            exceptionError = "Unknown error";
+        }
+        return failed;
+    }
+
+    DevCore::Callbacks ToCallbacks(const devcore_callbacks *callbacks)
+    {
+        DevCore::Callbacks converted;
+        if (!callbacks)
+            return converted;
+        void *user = callbacks->user;
+        if (devcore_message_fn info = callbacks->info)
+            converted.info = [info, user](const std::string &message) { info(message.c_str(), user); };
+        if (devcore_message_fn error = callbacks->error)
+            converted.error = [error, user](const std::string &message) { error(message.c_str(), user); };
+        if (devcore_progress_fn progress = callbacks->progress)
+            converted.progress = [progress, user](size_t done, size_t total) { progress(done, total, user); };
+        return converted;
+    }
+
+    devcore_list *ToList(std::vector<DevCore::Project> &&projects)
+    {
+        devcore_list *list = new (std::nothrow) devcore_list;
+        if (!list)
+            return nullptr;
+        list->projects = std::move(projects);
+        list->view.resize(list->projects.size());
+        list->dependencies.resize(list->projects.size());
+        for (size_t i = 0; i < list->projects.size(); i++)
+        {
+            const DevCore::Project &project = list->projects[i];
+            for (const auto &dependency : project.dependencies)
+                list->dependencies[i].push_back(dependency.c_str());
+
+            devcore_project &record = list->view[i];
+            record.name = project.name.c_str();
+            record.folder_name = project.folderName.c_str();
+            record.lang = project.lang.c_str();
+            record.path = project.path.c_str();
+            record.created_by = project.createdBy.c_str();
+            record.git_branch = project.gitBranch.c_str();
+            record.created_at = project.createdAt;
+            record.last_activity = project.lastActivity;
+            record.last_commit = project.lastCommit;
+            record.last_build = project.lastBuild;
+            record.size = project.size;
+            record.allocated_size = project.allocatedSize;
+            record.file_count = project.fileCount;
+            record.dir_count = project.dirCount;
+            record.lines = project.lines;
+            record.uses_git = project.usesGit;
+            record.git_dirty = project.gitDirty;
+            record.dependency_count = list->dependencies[i].size();
+            record.dependencies = list->dependencies[i].data();
+        }
+        return list;
+    }
+} // namespace
+
+extern "C"
+{
+    int devcore_open(const char *config_file, const char *devmap_file, const devcore_callbacks *callbacks)
+    {
+        return Guard(0, [&] {
+            return int(DevCore::Open(config_file ? config_file : "", devmap_file ? devmap_file : "", ToCallbacks(callbacks)));
+        });
+    }
+
+    int devcore_is_open(void)
+    {
+        return DevCore::IsOpen();
+    }
+
+    int devcore_sync(const devcore_callbacks *callbacks)
+    {
+        return Guard(0, [&] { return int(DevCore::Sync(ToCallbacks(callbacks))); });
+    }
+
+    const char *devcore_last_error(void)
+    {
+        return exceptionError.empty() ? DevCore::LastError().c_str() : exceptionError.c_str();
+    }
+
+    const char *devcore_projects_path(void)
+    {
+        projectsPath = DevCore::ProjectsPath();
+        return projectsPath.c_str();
+    }
+
+    devcore_list *devcore_projects(void)
+    {
+        return Guard<devcore_list *>(nullptr, [] { return ToList(DevCore::Projects()); });
+    }
+
+    devcore_list *devcore_projects_by_language(const char *lang)
+    {
+        return Guard<devcore_list *>(nullptr, [&] { return ToList(DevCore::ProjectsByLanguage(lang ? lang : "")); });
+    }
+
+    devcore_list *devcore_projects_by_user(const char *user)
+    {
+        return Guard<devcore_list *>(nullptr, [&] { return ToList(DevCore::ProjectsByUser(user ? user : "")); });
+    }
+
+    devcore_list *devcore_find_project(const char *name)
+    {
+        return Guard<devcore_list *>(nullptr, [&] {
+            std::vector<DevCore::Project> found(1);
+            if (!name || !DevCore::FindProject(name, found[0]))
+                found.clear();
+            return ToList(std::move(found));
+        });
+    }
+
+    size_t devcore_list_size(const devcore_list *list)
+    {
+        return list ? list->view.size() : 0;
+    }
+
+    const devcore_project *devcore_list_data(const devcore_list *list)
+    {
+        return list ? list->view.data() : nullptr;
+    }
+
+    const devcore_project *devcore_list_get(const devcore_list *list, size_t index)
+    {
+        if (!list || index >= list->view.size())
+            return nullptr;
+        return &list->view[index];
+    }
+
+    void devcore_list_free(devcore_list *list)
+    {
+        delete list;
+    }
+}
@@ -0,0 +1,790 @@
+#include "../include/DevMap.hpp"
+#include "../dependencies/Config.hpp"
+#include "../include/Main.hpp"
+#include "../include/FileIndex.hpp"
+#include "../include/Git.hpp"
+#include "../include/Ignore.hpp"
+#include "../include/Parallel.hpp"
+#include "../include/Scan.hpp"
+#include "../include/Strings.hpp"
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <map>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#include <pwd.h>
+#endif
+
+namespace DevMap
+{
+    Events events;
+
+    fs::path projectsPath;
+    fs::path devmapFileName;
+    std::vector<std::string> languages;
+    std::set<std::string> users;
+    std::vector<Project> projects;
+
+    namespace
+    {
+        nlohmann::json devmapData;
+
+        // Helper: Convert a time string ("HH:MM DD-MM-YYYY") to a time_t value.
+        time_t parseTime(const std::string &timeStr)
+        {
+            std::tm tm = {};
+            std::istringstream ss(timeStr);
+            ss >> std::get_time(&tm, "%H:%M %d-%m-%Y");
+            if (ss.fail())
+            {
+                return std::time(nullptr); // Fallback to current time.
+            }
+            return std::mktime(&tm);
+        }
+
+        // Apply a freshly read git status to a project.
+        void applyGitStatus(Project &proj, const Git::Status &status)
+        {
+            proj.usesGit = status.present;
+            proj.gitBranch = status.branch;
+            proj.lastCommit = status.lastCommit;
+            proj.gitDirty = status.dirty;
+        }
+
+        // Serialize a project to its DevMap JSON entry.
+        nlohmann::json projectToJson(const Project &proj)
+        {
+            nlohmann::json largestFiles = nlohmann::json::array();
+            for (const auto &file : proj.largestFiles)
+                largestFiles.push_back({{"path", file.second}, {"size", file.first}});
+            nlohmann::json largestDirs = nlohmann::json::array();
+            for (const auto &dir : proj.largestDirs)
+                largestDirs.push_back({{"path", dir.second}, {"size", dir.first}});
+            nlohmann::json buildDirs = nlohmann::json::array();
+            for (const auto &dir : proj.buildDirs)
+                buildDirs.push_back({{"path", dir.second}, {"size", dir.first}});
+            return {
+                {"name", proj.name},
+                {"folderName", proj.folderName},
+                {"lang", proj.lang},
+                {"created_by", proj.createdBy},
+                {"created_at", Strings::FormatTime(proj.createdAt)},
+                {"size", proj.size},
+                {"git", proj.usesGit},
+                {"git_branch", proj.gitBranch},
+                {"last_commit", proj.lastCommit ? Strings::FormatTime(proj.lastCommit) : ""},
+                {"git_dirty", proj.gitDirty},
+                {"git_reclaimed", proj.gitReclaimed},
+                {"git_maintained_at", proj.gitMaintainedAt ? Strings::FormatTime(proj.gitMaintainedAt) : ""},
+                {"lines", proj.lines},
+                {"allocated", proj.allocatedSize},
+                {"files", proj.fileCount},
+                {"directories", proj.dirCount},
+                {"last_activity", proj.lastActivity ? Strings::FormatTime(proj.lastActivity) : ""},
+                {"largest_files", largestFiles},
+                {"largest_dirs", largestDirs},
+                {"build_dirs", buildDirs},
+                {"depends", proj.dependencies},
+                {"last_build", proj.lastBuild} // Seconds since the epoch: compared with file times.
+            };
+        }
+
+        // Read a project back from its DevMap JSON entry.
+        Project projectFromJson(const nlohmann::json &projData)
+        {
+            Project proj;
+            proj.name = projData.value("name", "");
+            proj.folderName = projData.value("folderName", "");
+            proj.lang = projData.value("lang", "");
+            proj.createdBy = projData.value("created_by", "");
+            proj.createdAt = parseTime(projData.value("created_at", ""));
+            proj.size = projData.value("size", size_t(0));
+            proj.usesGit = projData.value("git", false);
+            proj.gitBranch = projData.value("git_branch", "");
+            std::string lastCommitStr = projData.value("last_commit", "");
+            proj.lastCommit = lastCommitStr.empty() ? 0 : parseTime(lastCommitStr);
+            proj.gitDirty = projData.value("git_dirty", false);
+            proj.gitReclaimed = projData.value("git_reclaimed", size_t(0));
+            proj.lines = projData.value("lines", size_t(0));
+            proj.allocatedSize = projData.value("allocated", uint64_t(0));
+            proj.fileCount = projData.value("files", size_t(0));
+            proj.dirCount = projData.value("directories", size_t(0));
+            std::string activityStr = projData.value("last_activity", "");
+            proj.lastActivity = activityStr.empty() ? 0 : parseTime(activityStr);
+            if (projData.contains("largest_files") && projData["largest_files"].is_array())
+            {
+                for (const auto &file : projData["largest_files"])
+                    proj.largestFiles.push_back({file.value("size", uint64_t(0)), file.value("path", "")});
+            }
+            if (projData.contains("largest_dirs") && projData["largest_dirs"].is_array())
+            {
+                for (const auto &dir : projData["largest_dirs"])
+                    proj.largestDirs.push_back({dir.value("size", uint64_t(0)), dir.value("path", "")});
+            }
+            if (projData.contains("build_dirs") && projData["build_dirs"].is_array())
+            {
+                for (const auto &dir : projData["build_dirs"])
+                    proj.buildDirs.push_back({dir.value("size", uint64_t(0)), dir.value("path", "")});
+            }
+            if (projData.contains("depends") && projData["depends"].is_array())
+            {
+                for (const auto &dep : projData["depends"])
+                {
+                    if (dep.is_string())
+                        proj.dependencies.push_back(dep.get<std::string>());
+                }
+            }
+            proj.lastBuild = projData.value("last_build", time_t(0));
+            std::string maintainedStr = projData.value("git_maintained_at", "");
+            proj.gitMaintainedAt = maintainedStr.empty() ? 0 : parseTime(maintainedStr);
+            return proj;
+        }
+
+        bool sameFolder(const Project &a, const Project &b)
+        {
+            return a.lang == b.lang && a.folderName == b.folderName;
+        }
+
+        // A name that is used as a single directory under the projects path.
+        bool validPathName(const std::string &name)
+        {
+            return !name.empty() && name.find('/') == std::string::npos && name != "." && name != "..";
+        }
+    } // namespace
+
+    const Project *findProjectByName(const std::vector<Project> &projects, const std::string &name)
+    {
+        auto it = std::find_if(projects.begin(), projects.end(), [&name](const Project &project) {
+            return project.name == name;
+        });
+        return it != projects.end() ? &(*it) : nullptr;
+    }
+
+    Project *findProject(const Project &proj)
+    {
+        for (auto &stored : projects)
+        {
+            if (sameFolder(stored, proj))
+                return &stored;
+        }
+        return nullptr;
+    }
+
+    std::string getCurrentUser()
+    {
+    #ifdef _WIN32
+        const char *user = std::getenv("USERNAME");
+    #else
+        const char *user = std::getenv("USER");
+        // Fallback in case getenv doesn't return the username.
+        if (!user)
+        {
+            struct passwd *pw = getpwuid(getuid());
+            if (pw)
+                user = pw->pw_name;
+        }
+    #endif
+        return user ? std::string(user) : "unknown";
+    }
+
+    fs::path templatesPath()
+    {
+        return Main::HOME_PATH + Main::TEMPLATE_PATH;
+    }
+
+    // A single pass over the folder: size, allocated size, file and
+    // directory counts, last activity, git presence, largest files, build
+    // outputs and lines of code are stored in proj, and the filename index
+    // and line counts cache are updated from the same walk. Git metadata is read natively, and only when there is a
+    // .git entry.
+    void scanProject(Project &proj)
+    {
+        fs::path projPath = projectsPath / proj.lang / proj.folderName;
+        Scan::SummaryVisitor summaryVisitor;
+        Scan::DirectorySizeVisitor directorySizeVisitor;
+        Scan::BuildDirVisitor buildDirVisitor;
+        Scan::FileListVisitor fileListVisitor;
+        Stats::LineCountVisitor lineCountVisitor;
+        Scan::Walk(projPath.string(), Ignore::Load(projPath),
+                   {&summaryVisitor, &directorySizeVisitor, &buildDirVisitor, &fileListVisitor, &lineCountVisitor});
+
+        const Scan::Summary &summary = summaryVisitor.Finish();
+        proj.size = summary.size;
+        proj.allocatedSize = summary.allocated;
+        proj.fileCount = summary.files;
+        proj.dirCount = summary.directories;
+        proj.lastActivity = summary.lastActivity;
+        proj.usesGit = summary.hasGit;
+        proj.largestFiles = summary.largest;
+        proj.largestDirs = directorySizeVisitor.Finish();
+        proj.buildDirs = buildDirVisitor.Finish();
+        proj.lines = lineCountVisitor.Finish(proj.lang + "/" + proj.folderName, projPath);
+        FileIndex::Update(proj.lang + "/" + proj.folderName, std::move(fileListVisitor.paths));
+        applyGitStatus(proj, proj.usesGit ? Git::ReadStatus(projPath) : Git::Status());
+    }
+
+    bool save()
+    {
+        std::ofstream outFile(devmapFileName);
+        if (!outFile.is_open())
+        {
+            events.error("Unable to write to DevMap file: " + devmapFileName.string());
+            return false;
+        }
+        outFile << devmapData.dump(4); // Pretty-print with indentations.
+        return true;
+    }
+
+    void store(const Project &proj)
+    {
+        for (auto &projData : devmapData["Projects"])
+        {
+            if (projData.value("folderName", "") == proj.folderName && projData.value("lang", "") == proj.lang)
+            {
+                projData = projectToJson(proj);
+                return;
+            }
+        }
+    }
+
+    std::string text()
+    {
+        return devmapData.dump(4);
+    }
+
+    void syncDevMap()
+    {
+        users.clear();
+        std::error_code ec;
+
+        // 1. Validate languages from JSON and remove those that no longer exist.
+        std::vector<std::string> validLanguages;
+        if (devmapData.contains("Languages") && devmapData["Languages"].is_array())
+        {
+            for (const auto &lang : devmapData["Languages"])
+            {
+                std::string language = lang.get<std::string>();
+                fs::path langPath = projectsPath / language;
+                if (fs::exists(langPath, ec))
+                    validLanguages.push_back(language);
+                else
+                    events.info("Language '" + language + "' has been moved or deleted: " + langPath.string());
+            }
+        }
+        languages = validLanguages;
+
+        // 2. Scan the filesystem for language directories not listed in JSON and add them.
+        for (const auto &entry : fs::directory_iterator(projectsPath, ec))
+        {
+            if (entry.is_directory(ec))
+            {
+                std::string langDir = entry.path().filename().string();
+                if (std::find(languages.begin(), languages.end(), langDir) == languages.end())
+                {
+                    languages.push_back(langDir);
+                    events.info("Added new language from filesystem to DevMap: " + langDir);
+                }
+            }
+        }
+        devmapData["Languages"] = languages;
+
+        // 3. Rebuild the projects vector from JSON, keeping only those projects that exist.
+        std::vector<Project> validProjects;
+        nlohmann::json validProjectsJson = nlohmann::json::array();
+        if (devmapData.contains("Projects") && devmapData["Projects"].is_array())
+        {
+            for (const auto &projData : devmapData["Projects"])
+            {
+                Project proj = projectFromJson(projData);
+                fs::path projPath = projectsPath / proj.lang / proj.folderName;
+                if (fs::exists(projPath, ec))
+                {
+                    validProjects.push_back(proj);
+                    validProjectsJson.push_back(projectToJson(proj));
+                    users.insert(proj.createdBy);
+                }
+                else
+                {
+                    events.info("Project '" + projPath.string() + "' has been moved or deleted.");
+                }
+            }
+        }
+        projects = validProjects;
+        devmapData["Projects"] = validProjectsJson;
+
+        // 4. Update existing project data from the filesystem. Every project
+        // is scanned in a single pass (see scanProject) and projects are
+        // independent, so they are scanned in parallel.
+        std::atomic<size_t> scanned{0};
+        std::mutex progressMutex;
+        Parallel::ForEach(projects.size(), [&](size_t i) {
+            Project &proj = projects[i];
+            std::error_code dirEc;
+            if (fs::is_directory(projectsPath / proj.lang / proj.folderName, dirEc))
+                scanProject(proj);
+            if (events.progress)
+            {
+                std::lock_guard<std::mutex> lock(progressMutex);
+                events.progress(++scanned, projects.size());
+            }
+        });
+        for (size_t i = 0; i < projects.size(); i++)
+        {
+            devmapData["Projects"][i] = projectToJson(projects[i]);
+        }
+
+        // 5. For every language directory, add any project directory not listed in the JSON.
+        for (const auto &language : languages)
+        {
+            for (const auto &entry : fs::directory_iterator(projectsPath / language, ec))
+            {
+                if (!entry.is_directory(ec))
+                    continue;
+                // New project detected on the filesystem; add it with default values.
+                Project newProj;
+                newProj.name = entry.path().filename().string(); // Default: use folder name as project name.
+                newProj.folderName = newProj.name;
+                newProj.lang = language;
+                if (findProject(newProj))
+                    continue;
+                newProj.createdBy = getCurrentUser();
+                newProj.createdAt = std::time(nullptr);
+                scanProject(newProj);
+                projects.push_back(newProj);
+                devmapData["Projects"].push_back(projectToJson(newProj));
+                events.info("Added new project from filesystem to DevMap: " + newProj.folderName + " in " + language);
+            }
+        }
+
+        // 6. Drop removed projects from the filename index and write it.
+        std::set<std::string> projectKeys;
+        for (const auto &proj : projects)
+            projectKeys.insert(proj.lang + "/" + proj.folderName);
+        FileIndex::Prune(projectKeys);
+        FileIndex::Save();
+
+        // 7. Optionally update the users vector from JSON.
+        if (devmapData.contains("Users") && devmapData["Users"].is_array())
+        {
+            for (const auto &user : devmapData["Users"])
+                users.insert(user.get<std::string>());
+        }
+        devmapData["Users"] = users;
+
+        // 8. Write the updated JSON back to the file.
+        save();
+    }
+
+    bool load(const std::string &filename, const fs::path &projects)
+    {
+        devmapFileName = filename;
+        projectsPath = projects;
+
+        std::error_code ec;
+        if (!fs::is_directory(projectsPath, ec))
+        {
+            events.error("The projects folder " + projectsPath.string() + " does not exist.");
+            return false;
+        }
+
+        std::ifstream file(filename);
+        if (!file.is_open())
+        {
+            events.error("Unable to read the DevMap file " + filename);
+            return false;
+        }
+
+        try
+        {
+            file >> devmapData;
+        }
+        catch (const std::exception &e)
+        {
+            devmapData = nlohmann::json();
+            events.error("Failed to parse the DevMap file: " + std::string(e.what()));
+            return false;
+        }
+        if (!devmapData.is_object())
+        {
+            devmapData = nlohmann::json();
+            events.error("The DevMap file " + filename + " does not hold a JSON object.");
+            return false;
+        }
+
+        // The expected JSON structure is:
+        // {
+        //     "Projects": [
+        //         {
+        //             "name": "DevCore Project Manager",
+        //             "folderName": "DevCore-project-manager",
+        //             "lang": "C++",
+        //             "created_by": "Huplo",
+        //             "created_at": "23:04 17-03-2025",
+        //             "size": 25042,
+        //             "git": true,
+        //         },
+        //         ...
+        //     ],
+        //     "Languages": ["Java", "C++"],
+        //     "Users": ["Huplo"]
+        // }
+
+        // Synchronize the JSON data with the filesystem.
+        syncDevMap();
+        return true;
+    }
+
+    bool create(const std::string &filename)
+    {
+        std::error_code ec;
+        fs::create_directories(fs::path(filename).parent_path(), ec);
+        nlohmann::json empty = {{"Projects", nlohmann::json::array()}, {"Languages", nlohmann::json::array()}, {"Users", nlohmann::json::array()}};
+        std::ofstream outFile(filename);
+        if (!outFile.is_open())
+        {
+            events.error("Unable to write to DevMap file: " + filename);
+            return false;
+        }
+        outFile << empty.dump(4);
+        return true;
+    }
+
+    std::vector<std::vector<Stats::FileEntry>> refreshLineCounts()
+    {
+        std::vector<std::string> keys;
+        for (const auto &proj : projects)
+            keys.push_back(proj.lang + "/" + proj.folderName);
+        size_t recounted = 0;
+        auto files = Stats::Update(keys, projectsPath, recounted);
+
+        bool changed = false;
+        for (size_t i = 0; i < projects.size(); i++)
+        {
+            size_t lines = 0;
+            for (const auto &file : files[i])
+                lines += file.counts.code;
+            if (lines == projects[i].lines)
+                continue;
+            projects[i].lines = lines;
+            store(projects[i]);
+            changed = true;
+        }
+        if (changed)
+            save();
+        return files;
+    }
+
+    bool createLanguage(const std::string &lang)
+    {
+        if (!validPathName(lang))
+        {
+            events.error("'" + lang + "' is not a valid language name.");
+            return false;
+        }
+        if (std::find(languages.begin(), languages.end(), lang) != languages.end())
+        {
+            events.info("Language already exists: " + lang);
+            return true;
+        }
+
+        std::error_code ec;
+        fs::path langPath = projectsPath / lang;
+        if (!fs::exists(langPath, ec))
+        {
+            if (!fs::create_directories(langPath, ec))
+            {
+                events.error("Failed to create language directory " + langPath.string() + ": " + ec.message());
+                return false;
+            }
+            events.info("Created language directory: " + langPath.string());
+        }
+        fs::path templatePath = templatesPath() / lang;
+        if (!fs::exists(templatePath, ec))
+        {
+            if (!fs::create_directories(templatePath, ec))
+            {
+                events.error("Failed to create template directory " + templatePath.string() + ": " + ec.message());
+                return false;
+            }
+            events.info("Created template directory: " + templatePath.string());
+        }
+
+        languages.push_back(lang);
+        devmapData["Languages"] = languages;
+        events.info("Added language to DevMap: " + lang);
+        return save();
+    }
+
+    bool deleteLanguage(const std::string &lang)
+    {
+        auto it = std::find(languages.begin(), languages.end(), lang);
+        if (it == languages.end())
+        {
+            events.error("Language '" + lang + "' does not exist.");
+            return false;
+        }
+
+        std::error_code ec;
+        fs::path langPath = projectsPath / lang;
+        fs::path templatePath = templatesPath() / lang;
+        bool empty = true;
+        if (fs::exists(langPath, ec) && !fs::is_empty(langPath, ec))
+        {
+            events.error("Cannot delete language directory '" + langPath.string() + "': Directory is not empty. You will have to empty this yourself or by deleting each project with DevCore commands.");
+            empty = false;
+        }
+        if (fs::exists(templatePath, ec) && !fs::is_empty(templatePath, ec))
+        {
+            events.error("Cannot delete template directory '" + templatePath.string() + "': Directory is not empty. You will have to empty this yourself or by deleting each template with DevCore commands");
+            empty = false;
+        }
+        if (!empty)
+            return false;
+
+        for (const fs::path &dir : {langPath, templatePath})
+        {
+            if (!fs::exists(dir, ec))
+                continue;
+            if (!fs::remove(dir, ec))
+            {
+                events.error("Failed to delete directory " + dir.string() + ": " + ec.message());
+                return false;
+            }
+            events.info("Deleted directory: " + dir.string());
+        }
+
+        languages.erase(it);
+        devmapData["Languages"] = languages;
+        return save();
+    }
+
+    std::vector<std::string> templateNames(const std::string &lang)
+    {
+        std::vector<std::string> names;
+        std::error_code ec;
+        for (const auto &entry : fs::directory_iterator(templatesPath() / lang, ec))
+        {
+            if (entry.is_directory(ec))
+                names.push_back(entry.path().filename().string());
+        }
+        std::sort(names.begin(), names.end());
+        return names;
+    }
+
+    std::vector<std::string> templateNames()
+    {
+        std::vector<std::string> names;
+        std::error_code ec;
+        for (const auto &entry : fs::directory_iterator(templatesPath(), ec))
+        {
+            if (!entry.is_directory(ec))
+                continue;
+            std::string lang = entry.path().filename().string();
+            for (const auto &name : templateNames(lang))
+                names.push_back(lang + "/" + name);
+        }
+        std::sort(names.begin(), names.end());
+        return names;
+    }
+
+    bool addTemplate(const std::string &lang, const std::string &name, const std::string &source)
+    {
+        if (std::find(languages.begin(), languages.end(), lang) == languages.end())
+        {
+            events.error("Language '" + lang + "' does not exist.");
+            return false;
+        }
+        if (name.empty() || name.find('/') != std::string::npos || name == "." || name == "..")
+        {
+            events.error("'" + name + "' is not a valid template name.");
+            return false;
+        }
+        std::error_code ec;
+        if (!fs::is_directory(source, ec))
+        {
+            events.error("'" + source + "' is not a folder.");
+            return false;
+        }
+
+        // Copy the contents of the source directory (hidden files included)
+        // into the target directory, creating it if it doesn't exist
+        fs::path targetDir = templatesPath() / lang / name;
+        fs::create_directories(targetDir, ec);
+        if (!ec)
+            fs::copy(source, targetDir, fs::copy_options::recursive | fs::copy_options::overwrite_existing, ec);
+        if (ec)
+        {
+            events.error("Failed to copy '" + source + "' to '" + targetDir.string() + "': " + ec.message());
+            return false;
+        }
+        return true;
+    }
+
+    bool removeTemplate(const std::string &lang, const std::string &name)
+    {
+        std::error_code ec;
+        fs::path templatePath = templatesPath() / lang / name;
+        if (lang.empty() || name.empty() || name == "." || name == ".." || !fs::is_directory(templatePath, ec))
+        {
+            events.error("Template '" + lang + "/" + name + "' does not exist.");
+            return false;
+        }
+        auto removedCount = fs::remove_all(templatePath, ec);
+        if (ec)
+        {
+            events.error("Failed to delete template directory '" + templatePath.string() + "'. Error: " + ec.message());
+            return false;
+        }
+        events.info("Deleted " + std::to_string(removedCount) + " items from " + templatePath.string());
+        return true;
+    }
+
+    bool applyTemplate(const std::string &lang, const std::string &name, const fs::path &projPath, int depth)
+    {
+        std::error_code ec;
+        fs::path templatePath = templatesPath() / lang / name;
+        if (name.empty() || name.find('/') != std::string::npos || !fs::is_directory(templatePath, ec))
+        {
+            events.error("Template '" + lang + "/" + name + "' does not exist.");
+            return false;
+        }
+
+        // The base template goes first, so this one's files replace its files.
+        std::ifstream baseFile(templatePath / TEMPLATE_BASE_FILE);
+        std::string base;
+        if (baseFile && std::getline(baseFile, base))
+        {
+            base.erase(base.find_last_not_of(" \t\r") + 1);
+            if (depth >= 8)
+            {
+                events.error("Template '" + lang + "/" + name + "' has too many base templates (is there a cycle?).");
+                return false;
+            }
+            if (!base.empty() && !applyTemplate(lang, base, projPath, depth + 1))
+                return false;
+        }
+
+        fs::copy(templatePath, projPath, fs::copy_options::recursive | fs::copy_options::overwrite_existing, ec);
+        if (ec)
+        {
+            events.error("Error copying template: " + ec.message());
+            return false;
+        }
+        fs::remove(projPath / TEMPLATE_BASE_FILE, ec);
+        return true;
+    }
+
+    bool addProject(Project &proj, const std::string &templateName, bool initGit)
+    {
+        if (proj.name.empty() || proj.folderName.empty())
+        {
+            events.error("A project needs a name and a folder name.");
+            return false;
+        }
+        if (!validPathName(proj.name))
+        {
+            events.error("'" + proj.name + "' is not a valid project name.");
+            return false;
+        }
+        if (!validPathName(proj.folderName))
+        {
+            events.error("'" + proj.folderName + "' is not a valid folder name.");
+            return false;
+        }
+        if (std::find(languages.begin(), languages.end(), proj.lang) == languages.end())
+        {
+            events.error("Language '" + proj.lang + "' does not exist.");
+            return false;
+        }
+        if (findProjectByName(projects, proj.name))
+        {
+            events.error("A project named '" + proj.name + "' already exists.");
+            return false;
+        }
+
+        fs::path projPath = projectsPath / proj.lang / proj.folderName;
+        std::error_code ec;
+        if (fs::exists(projPath, ec) || findProject(proj))
+        {
+            events.error("The folder " + projPath.string() + " already exists.");
+            return false;
+        }
+        fs::create_directories(projPath, ec);
+        if (ec)
+        {
+            events.error("Error creating project directory: " + ec.message());
+            return false;
+        }
+        if (!templateName.empty())
+        {
+            if (!applyTemplate(proj.lang, templateName, projPath))
+                return false;
+            events.info(u8"✨ Template '" + templateName + "' applied to project.");
+        }
+        if (initGit)
+        {
+            fs::path gitTemplate = Config::getOr("git_template", "/usr/share/git-core/templates");
+            if (Git::Init(projPath, Config::getOr("git_branch", "master"), gitTemplate))
+                events.info(u8"🐙 Git repository initialized in " + projPath.string());
+            else
+                events.error("Failed to initialize Git repository in " + projPath.string());
+        }
+
+        if (proj.createdBy.empty())
+            proj.createdBy = getCurrentUser();
+        if (!proj.createdAt)
+            proj.createdAt = std::time(nullptr);
+        scanProject(proj);
+        FileIndex::Save();
+
+        projects.push_back(proj);
+        users.insert(proj.createdBy);
+        devmapData["Projects"].push_back(projectToJson(proj));
+        devmapData["Users"] = users;
+        return save();
+    }
+
+    bool deleteProject(const Project &proj)
+    {
+        const Project *stored = findProject(proj);
+        if (!stored)
+        {
+            events.error("Project '" + proj.name + "' does not exist.");
+            return false;
+        }
+        fs::path projPath = projectsPath / stored->lang / stored->folderName;
+        std::error_code ec;
+        auto removedCount = fs::remove_all(projPath, ec);
+        if (ec)
+        {
+            events.error("Failed to delete project directory '" + projPath.string() + "'. Error: " + ec.message());
+            return false;
+        }
+        events.info("Deleted " + std::to_string(removedCount) + " items from " + projPath.string());
+
+        nlohmann::json remaining = nlohmann::json::array();
+        for (const auto &projData : devmapData["Projects"])
+        {
+            if (projData.value("folderName", "") != stored->folderName || projData.value("lang", "") != stored->lang)
+                remaining.push_back(projData);
+        }
+        devmapData["Projects"] = remaining;
+        Project removed = *stored;
+        projects.erase(std::remove_if(projects.begin(), projects.end(), [&](const Project &p) { return sameFolder(p, removed); }),
+                       projects.end());
+        std::set<std::string> projectKeys;
+        for (const auto &p : projects)
+            projectKeys.insert(p.lang + "/" + p.folderName);
+        FileIndex::Prune(projectKeys);
+        FileIndex::Save();
+        return save();
+    }
+} // namespace DevMap
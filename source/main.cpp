@@ -1,18 +1,34 @@
 #include "../dependencies/Canvas.hpp"
 #include "../dependencies/Config.hpp"
-#include "../include/DevMap.hpp"
+#include "../include/Build.hpp"
+#include "../include/Clean.hpp"
+#include "../include/CompDb.hpp"
+#include "../include/CompileCache.hpp"
+#include "../include/DevCore.hpp"
+#include "../include/Dupes.hpp"
 #include "../include/Main.hpp"
+#include "../include/Grep.hpp"
+#include "../include/Maintenance.hpp"
+#include "../include/Open.hpp"
+#include "../include/Process.hpp"
+#include "../include/Projects.hpp"
+#include "../include/Query.hpp"
+#include "../include/Search.hpp"
+#include "../include/Symbols.hpp"
+#include "../include/Update.hpp"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <cstdint>
+#include <stdexcept>
 
 
 
 
-void PrintHelp() {
-    Canvas::PrintTitle("DevCore | Help Menu", Canvas::Color::CYAN);
-    std::string helpText =
+// The help menu, also searched for the commands related to an invalid one.
+std::string HelpText() {
+    return
         Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore config get <key>                        " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Get a config value\n" +
         Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore config set <key> <value>                " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Set a config value\n" +
         Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore config reset                            " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Reset config to default\n" +
@@ -28,25 +44,94 @@ void PrintHelp() {
         Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore delete-lang <lang>                      " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Delete a language (if empty)\n\n" +
 
         Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore list [projects|users|languages]         " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - List items\n" +
-        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore list-all projects                       " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - List all projects with details\n\n" +
+        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore list-all projects                       " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - List all projects with details\n" +
+        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore list projects --where <q> --sort <keys> " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Filter and sort projects (--limit <n> for the top n)\n\n" +
 
         Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore add-template                            " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Add a new template\n" +
         Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore remove-template                         " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Remove an existing template\n\n" +
 
+        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore search [-i] [-e] <pattern>              " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Search all projects (indexed, -e for regex)\n" +
+        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore grep [-i] [-e] <pattern>                " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Search all projects on disk (no index)\n" +
+        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore find <glob>                             " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Find files by name in all projects\n" +
+        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore symbol <name>                           " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Find C/C++ definitions in all projects\n" +
+        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore stats [project]                         " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Lines of code per language\n" +
+        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore dupes [--min-size <bytes>] [--dedupe]   " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Find (and reflink) duplicate files across projects\n" +
+        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore du [project]                            " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Disk usage per language, or a project's largest directories and files\n" +
+        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore build [-j <jobs>] [--cache] [projects]  " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Build changed projects and their dependents in parallel\n" +
+        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore depends <project> [add|remove <deps>]   " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Show or edit the projects a project depends on\n" +
+        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore compdb [projects...]                    " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Write compile_commands.json for C/C++ projects\n" +
+        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore cc [--stats|--clear|<compiler> <args>]  " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Compile through the shared object cache\n" +
+        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore clean [--dry-run] [-y] [projects...]    " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Delete build outputs (build/, target/, node_modules, ...)\n" +
+        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore git-maintenance [--all|--dry-run]       " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Garbage collect repositories that need it\n\n" +
+
+        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore open [query]                            " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Open the best matching (most used) project in the editor\n" +
         Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore github                                  " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Open the GitHub repository\n" +
-        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore update                                  " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Update DevCore (wiht build)\n" +
+        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore update [--source <checkout>]            " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Update DevCore (offline from a checkout, or from GitHub)\n" +
+        Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore version                                 " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Show when and how this binary was built\n" +
         Canvas::ColorToAnsi(Canvas::Color::YELLOW) + "devcore --help                                  " + Canvas::ColorToAnsi(Canvas::Color::MAGENTA) + " - Display this help menu";
+}
 
-    Canvas::PrintBox(helpText, Canvas::ColorToAnsi(Canvas::Color::CYAN) + " 🛈 Usage ", Canvas::Color::CYAN, 3);
+void PrintHelp() {
+    Canvas::PrintTitle("DevCore | Help Menu", Canvas::Color::CYAN);
+    Canvas::PrintBox(HelpText(), Canvas::ColorToAnsi(Canvas::Color::CYAN) + " 🛈 Usage ", Canvas::Color::CYAN, 3);
 }
 
 
 
+// Install the default configuration file (from a clone of the DevCore
+// repository) at filename, overwriting what is there.
+bool InstallConfig(const std::string &filename)
+{
+    Canvas::PrintInfo("Checking for required directories");
+    fs::path configPath = filename;
+    std::error_code ec;
+    fs::create_directories(configPath.parent_path(), ec);
+
+    // Always clone and overwrite the configuration file
+    Canvas::PrintInfo("Cloning the DevCore repository to retrieve the default config.");
+    const fs::path cloneDir = "/tmp/devcore_repo";
+    fs::remove_all(cloneDir, ec);
+    if (Process::Run({"git", "clone", "--quiet", "--depth", "1", Config::github, cloneDir.string()}) != 0)
+    {
+        Canvas::PrintError("Failed to clone repository from " + Canvas::LinkText(Config::github));
+        return false;
+    }
+
+    fs::path sourceConfig = cloneDir / "devcore.conf";
+    if (!fs::exists(sourceConfig, ec))
+    {
+        Canvas::PrintError("Default configuration file not found in the cloned repository.");
+        fs::remove_all(cloneDir, ec);
+        return false;
+    }
+    Canvas::PrintInfo("Copying the new config to '" + Canvas::LinkText(filename, Canvas::Color::CYAN) + "'");
+    fs::copy_file(sourceConfig, configPath, fs::copy_options::overwrite_existing, ec);
+    Canvas::PrintInfo("Removing the temporary cloned repository.");
+    fs::remove_all(cloneDir);
+    if (ec)
+    {
+        Canvas::PrintError("Unable to write " + filename + ": " + ec.message());
+        return false;
+    }
+    Canvas::PrintSuccess(Canvas::BoldText("Done installing the default config.") + Canvas::ColorToAnsi(Canvas::Color::GREEN) + "\n    You can edit the config by running `devcore config set <key> <value>`. \n    Or editing the config file manually at '" + Canvas::LinkText(filename, Canvas::Color::GREEN) + "'");
+    return true;
+}
+
+// Offer to install the default config when there is none yet.
+void SetupConfig(const std::string &filename)
+{
+    Canvas::ClearConsole();
+    Canvas::PrintTitle("DevCore | Setup Zone");
+    Canvas::PrintWarning("It seems like you do not yet have a config file. Would you like to install a default config? \n    If not check out '" + Canvas::LinkText(filename, Canvas::Color::YELLOW) + "' to configure one manually.");
+    if (Canvas::GetBoolInput("    ") && InstallConfig(filename))
+        Config::load(filename);
+}
+
 int HandleConfig(int argc, char const *argv[])
 {
     if (argc < 3)
     {
-        Canvas::PrintCommandError(argc, argv);
+        Canvas::PrintCommandError(argc, argv, HelpText());
         return 0;
     }
     
@@ -69,7 +154,9 @@ int HandleConfig(int argc, char const *argv[])
         if (Canvas::GetBoolInput(""))
         {
             Canvas::PrintInfo("Resetting your config, this may take a while.");
-            Config::load(Main::HOME_PATH + Main::CONFIG_PATH, true);
+            if (!InstallConfig(Main::HOME_PATH + Main::CONFIG_PATH))
+                return 1;
+            Config::load(Main::HOME_PATH + Main::CONFIG_PATH);
             Canvas::PrintSuccess("Your config has been reset to its default state.");
             Canvas::PrintBox(Config::GetKeyValueString(), " devcore.conf ", Canvas::Color::GREEN);
         }
@@ -82,17 +169,27 @@ int HandleConfig(int argc, char const *argv[])
     }
     else
     {
-        Canvas::PrintCommandError(argc, argv);
+        Canvas::PrintCommandError(argc, argv, HelpText());
     }
 
     return 0;
 }
 
+// libdevcore reports what it notices to these callbacks instead of printing
+// itself.
+DevCore::Callbacks TerminalCallbacks()
+{
+    DevCore::Callbacks ui;
+    ui.info = [](const std::string &message) { Canvas::PrintInfo(message); };
+    ui.error = [](const std::string &message) { Canvas::PrintError(message); };
+    return ui;
+}
+
 int HandleDevMap(int argc, char const *argv[])
 {
     if (argc < 3)
     {
-        Canvas::PrintCommandError(argc, argv);
+        Canvas::PrintCommandError(argc, argv, HelpText());
         return 0;
     }
 
@@ -102,24 +199,25 @@ int HandleDevMap(int argc, char const *argv[])
     {
         Canvas::PrintTitle("DevCore | Danger Zone", Canvas::Color::RED);
         Canvas::PrintWarning("This is your current DevMap, are you sure you want to reset it to the default DevMap?");
-        Canvas::PrintBox(DevMap::GetStringRepresentation(), " devmap.json ", Canvas::Color::RED);
+        Canvas::PrintBox(DevCore::DevMapText(), " devmap.json ", Canvas::Color::RED);
         if (Canvas::GetBoolInput(""))
         {
             Canvas::PrintInfo("Resetting your DevMap, this may take a while.");
-            DevMap::load(Main::HOME_PATH + Main::DEVMAP_PATH, true);
+            if (!DevCore::CreateDevMap() || !DevCore::Open("", "", TerminalCallbacks()))
+                return 1;
             Canvas::PrintSuccess("Your DevMap has been reset to its default state.");
-            Canvas::PrintBox(DevMap::GetStringRepresentation(), " devmap.json ", Canvas::Color::GREEN);
+            Canvas::PrintBox(DevCore::DevMapText(), " devmap.json ", Canvas::Color::GREEN);
         }
     }
     else if (command == "view" && argc == 3)
     {
         Canvas::PrintTitle("DevCore | DevMap Zone", Canvas::Color::CYAN);
         Canvas::PrintInfo("This is your current DevMap. You can find it here: '" + Canvas::LinkText(Main::HOME_PATH + Main::DEVMAP_PATH, Canvas::Color::CYAN) + "'");
-        Canvas::PrintBox(DevMap::GetStringRepresentation(), " devmap.json ", Canvas::Color::GREEN);
+        Canvas::PrintBox(DevCore::DevMapText(), " devmap.json ", Canvas::Color::GREEN);
     }
     else
     {
-        Canvas::PrintCommandError(argc, argv);
+        Canvas::PrintCommandError(argc, argv, HelpText());
     }
 
     return 0;
@@ -129,36 +227,61 @@ int HandleList(int argc, char const *argv[])
 {
     if (argc < 3)
     {
-        Canvas::PrintCommandError(argc, argv);
+        Canvas::PrintCommandError(argc, argv, HelpText());
         return 0;
     }
 
     std::string command = argv[1];
     std::string param1 = argv[2];
+    bool all = command == "list-all" || command == "-la";
+
+    // list projects --where <query> --sort <keys> --limit <n>
+    if (argc > 3 && (param1 == "projects" || param1 == "-p"))
+    {
+        std::string where, sort;
+        uint64_t limit = 0;
+        for (int i = 3; i < argc; i++)
+        {
+            std::string arg = argv[i];
+            if (arg == "--where" && i + 1 < argc)
+                where = where.empty() ? argv[++i] : "(" + where + ") and (" + argv[++i] + ")";
+            else if (arg == "--sort" && i + 1 < argc)
+                sort = argv[++i];
+            else if (arg == "--limit" && i + 1 < argc && Strings::ParseCount(argv[i + 1], limit, SIZE_MAX))
+                i++;
+            else
+            {
+                Canvas::PrintCommandError(argc, argv, HelpText());
+                return 0;
+            }
+        }
+        Query::ListProjects(where, sort, limit, all);
+        return 0;
+    }
 
     if ((command == "list" || command == "-l") && argc == 3)
     {
         if (param1 == "projects" || param1 == "-p")
-            DevMap::ListProjects();
+            Projects::ListProjects();
         else if (param1 == "users" || param1 == "-u")
-            DevMap::ListUsers();
+            Projects::ListUsers();
         else if (param1 == "languages" || param1 == "lang" || param1 == "-l" )
-            DevMap::ListLanguages();
+            Projects::ListLanguages();
         else if (param1 == "templates" || param1 == "templ" || param1 == "-t" )
-            DevMap::ListTemplates();
+            Projects::ListTemplates();
         else
-            Canvas::PrintCommandError(argc, argv);
+            Canvas::PrintCommandError(argc, argv, HelpText());
     }
-    else if ((command == "list-all" || command == "-la") && argc == 3)
+    else if (all && argc == 3)
     {
         if (param1 == "projects" || param1 == "-p")
-            DevMap::ListProjects(true);
+            Projects::ListProjects(true);
         else
-            Canvas::PrintCommandError(argc, argv);
+            Canvas::PrintCommandError(argc, argv, HelpText());
     }
     else
     {
-        Canvas::PrintCommandError(argc, argv);
+        Canvas::PrintCommandError(argc, argv, HelpText());
     }
 
     return 0;
@@ -168,11 +291,11 @@ int HandleCreateProject(int argc, char const *argv[])
 {
     if (argc != 2)
     {
-        Canvas::PrintCommandError(argc, argv);
+        Canvas::PrintCommandError(argc, argv, HelpText());
         return 0;
     }
 
-    DevMap::CreateProjectWizard();
+    Projects::CreateProjectWizard();
 
     return 0;
 }
@@ -181,11 +304,11 @@ int HandleDeleteProject(int argc, char const *argv[])
 {
     if (argc != 2)
     {
-        Canvas::PrintCommandError(argc, argv);
+        Canvas::PrintCommandError(argc, argv, HelpText());
         return 0;
     }
 
-    DevMap::DeleteProjectWizard();
+    Projects::DeleteProjectWizard();
 
     return 0;
 }
@@ -194,13 +317,11 @@ int HandleCreateLang(int argc, char const *argv[])
 {
     if (argc != 3)
     {
-        Canvas::PrintCommandError(argc, argv);
+        Canvas::PrintCommandError(argc, argv, HelpText());
         return 0;
     }
 
-    std::string lang = argv[2];
-
-    DevMap::CreateLang(lang);
+    Projects::CreateLang(argv[2]);
 
     return 0;
 }
@@ -209,13 +330,11 @@ int HandleDeleteLang(int argc, char const *argv[])
 {
     if (argc != 3)
     {
-        Canvas::PrintCommandError(argc, argv);
+        Canvas::PrintCommandError(argc, argv, HelpText());
         return 0;
     }
 
-    std::string lang = argv[2];
-
-    DevMap::DeleteLanguage(lang);
+    Projects::DeleteLanguage(argv[2]);
 
     return 0;
 }
@@ -224,11 +343,11 @@ int HandleAddTemplate(int argc, char const *argv[])
 {
     if (argc != 2)
     {
-        Canvas::PrintCommandError(argc, argv);
+        Canvas::PrintCommandError(argc, argv, HelpText());
         return 0;
     }
 
-    DevMap::AddTemplate();
+    Projects::AddTemplate();
 
     return 0;
 }
@@ -237,159 +356,469 @@ int HandleRemoveTemplate(int argc, char const *argv[])
 {
     if (argc != 2)
     {
-        Canvas::PrintCommandError(argc, argv);
+        Canvas::PrintCommandError(argc, argv, HelpText());
         return 0;
     }
 
-    DevMap::RemoveTemplate();
+    Projects::RemoveTemplate();
 
     return 0;
 }
 
-int main(int argc, char const *argv[]) {
-    if (!Config::load(Main::HOME_PATH + Main::CONFIG_PATH))
-        Config::setup(Main::HOME_PATH + Main::CONFIG_PATH);
-
-    if (!DevMap::load(Main::HOME_PATH + Main::DEVMAP_PATH))
-        DevMap::setup(Main::HOME_PATH + Main::DEVMAP_PATH);
+int HandleGrep(int argc, char const *argv[])
+{
+    Grep::Options options;
+    for (int i = 2; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "-i" || arg == "--ignore-case")
+            options.ignoreCase = true;
+        else if (arg == "-e" || arg == "--regex")
+            options.regex = true;
+        else if (options.pattern.empty())
+            options.pattern = arg;
+        else
+        {
+            Canvas::PrintCommandError(argc, argv, HelpText());
+            return 0;
+        }
+    }
 
-    if (argc < 2)
+    if (options.pattern.empty())
     {
-        Canvas::PrintCommandError(argc, argv);
-        return 1;
+        Canvas::PrintCommandError(argc, argv, HelpText());
+        return 0;
     }
 
-    std::string command = argv[1];
+    Grep::Run(options);
 
+    return 0;
+}
 
-    if (command == "config")
+int HandleFind(int argc, char const *argv[])
+{
+    if (argc != 3)
     {
-        return HandleConfig(argc, argv);
+        Canvas::PrintCommandError(argc, argv, HelpText());
+        return 0;
     }
-    else if (command == "devmap")
+
+    Projects::FindFiles(argv[2]);
+
+    return 0;
+}
+
+int HandleSymbol(int argc, char const *argv[])
+{
+    if (argc != 3)
     {
-        return HandleDevMap(argc, argv);
+        Canvas::PrintCommandError(argc, argv, HelpText());
+        return 0;
     }
-    else if (command == "-l" || command == "-la" || command == "list" || command == "list-all")
+
+    Symbols::Run(argv[2]);
+
+    return 0;
+}
+
+int HandleStats(int argc, char const *argv[])
+{
+    if (argc > 3)
     {
-        return HandleList(argc, argv);
+        Canvas::PrintCommandError(argc, argv, HelpText());
+        return 0;
     }
-    else if (command == "create-project")
-    {
-        return HandleCreateProject(argc, argv);
+
+    Projects::ShowStats(argc == 3 ? argv[2] : "");
+
+    return 0;
+}
+
+int HandleDupes(int argc, char const *argv[])
+{
+    uint64_t minSize = 4096;
+    bool dedupe = false;
+    for (int i = 2; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--dedupe")
+            dedupe = true;
+        else if (arg == "--min-size" && i + 1 < argc && Strings::ParseCount(argv[i + 1], minSize))
+            i++;
+        else
+        {
+            Canvas::PrintCommandError(argc, argv, HelpText());
+            return 0;
+        }
     }
-    else if (command == "delete-project")
+
+    Dupes::Run(minSize, dedupe);
+
+    return 0;
+}
+
+int HandleDiskUsage(int argc, char const *argv[])
+{
+    if (argc == 2)
     {
-        return HandleDeleteProject(argc, argv);
+        Projects::DiskUsage();
+        return 0;
     }
-    else if (command == "create-lang")
+    if (argc != 3)
     {
-        return HandleCreateLang(argc, argv);
+        Canvas::PrintCommandError(argc, argv, HelpText());
+        return 0;
     }
-    else if (command == "delete-lang")
+
+    DevCore::Project project;
+    if (!DevCore::FindProject(argv[2], project))
     {
-        return HandleDeleteLang(argc, argv);
+        Canvas::PrintError("Project '" + std::string(argv[2]) + "' does not exist.");
+        return 0;
     }
-    else if (command == "add-template")
-    {
-        return HandleAddTemplate(argc, argv);
+    Projects::DiskUsage(project);
+
+    return 0;
+}
+
+int HandleBuild(int argc, char const *argv[])
+{
+    unsigned jobs = 0;
+    bool cache = Config::getOr("build_cache", "false") == "true";
+    bool force = false;
+    std::vector<std::string> names;
+    for (int i = 2; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--cache")
+            cache = true;
+        else if (arg == "--force")
+            force = true;
+        else if (arg == "--no-cache")
+            cache = false;
+        else if (arg == "-j")
+        {
+            uint64_t value = 0;
+            if (i + 1 >= argc || !Strings::ParseCount(argv[i + 1], value, Build::MAX_JOBS) || value == 0)
+            {
+                Canvas::PrintError("-j takes a number of jobs between 1 and " + std::to_string(Build::MAX_JOBS) + ".");
+                return 0;
+            }
+            jobs = static_cast<unsigned>(value);
+            i++;
+        }
+        else if (arg.rfind("-", 0) == 0)
+        {
+            Canvas::PrintCommandError(argc, argv, HelpText());
+            return 0;
+        }
+        else
+            names.push_back(arg);
     }
-    else if (command == "remove-template")
+
+    return Build::Run(names, jobs ? jobs : Build::JobSlots(), cache, force);
+}
+
+// Runs before the DevMap is loaded: the wrapper is started for every
+// compilation and must not scan the projects each time.
+int HandleCompilerCache(int argc, char const *argv[])
+{
+    std::string arg = argc > 2 ? argv[2] : "";
+    if (argc == 3 && arg == "--stats")
+        CompileCache::PrintStats();
+    else if (argc == 3 && arg == "--clear")
+        CompileCache::Clear();
+    else if (argc > 2 && arg[0] != '-')
+        return CompileCache::Compile(std::vector<std::string>(argv + 2, argv + argc));
+    else
+        Canvas::PrintCommandError(argc, argv, HelpText());
+    return 0;
+}
+
+int HandleDepends(int argc, char const *argv[])
+{
+    if (argc < 3 || (argc > 3 && argc < 5))
     {
-        return HandleRemoveTemplate(argc, argv);
+        Canvas::PrintCommandError(argc, argv, HelpText());
+        return 0;
     }
-    else if (argc == 2 && command == "--help")
+    DevCore::Project project;
+    if (!DevCore::FindProject(argv[2], project))
     {
-        PrintHelp();
+        Canvas::PrintError("Project '" + std::string(argv[2]) + "' does not exist.");
         return 0;
     }
-    else if (argc == 2 && command == "github")
+    if (argc == 3)
     {
-        Canvas::PrintBox(Canvas::ColorToAnsi(Canvas::Color::GREEN) + Canvas::BoldText("Follow the github repository and give it a star!") + "\n" + Canvas::LinkText("https://github.com/mathlon26/DevCore-project-manager"), " Give DevCore a star ⭐ ", Canvas::Color::PINK, 1);
+        Projects::ShowDependencies(project);
         return 0;
     }
-    else if (argc == 2 && command == "update")
+
+    std::string action = argv[3];
+    if (action != "add" && action != "remove")
     {
-        // Define paths for convenience.
-        std::string homeDir         = Main::HOME_PATH;
-        std::string repoUrl         = "https://github.com/mathlon26/DevCore-project-manager.git";
-        std::string tempRepoDir     = homeDir + "/DevCore-project-manager-temp";
-        std::string installScriptPath = homeDir + "/install.sh";
-        std::string installedRepoDir  = homeDir + "/DevCore-project-manager";
+        Canvas::PrintCommandError(argc, argv, HelpText());
+        return 0;
+    }
+    Projects::EditDependencies(project, std::vector<std::string>(argv + 4, argv + argc), action == "add");
 
-        // Clone the repository to a temporary directory.
-        std::string cloneCmd = "git clone " + repoUrl + " " + tempRepoDir;
-        if (system(cloneCmd.c_str()) != 0)
+    return 0;
+}
+
+int HandleCompDb(int argc, char const *argv[])
+{
+    std::vector<std::string> names(argv + 2, argv + argc);
+    for (const auto &name : names)
+    {
+        if (name[0] == '-')
         {
-            Canvas::PrintError("Failed to clone the repository.");
-            system(("rm -rf " + tempRepoDir).c_str());
-            return 1;
+            Canvas::PrintCommandError(argc, argv, HelpText());
+            return 0;
         }
+    }
+
+    CompDb::Run(names);
+
+    return 0;
+}
 
-        // Move install.sh from the temporary repository to the home directory.
-        std::string moveCmd = "mv " + tempRepoDir + "/install.sh " + homeDir;
-        if (system(moveCmd.c_str()) != 0)
+int HandleClean(int argc, char const *argv[])
+{
+    bool dryRun = false;
+    bool assumeYes = false;
+    std::vector<std::string> names;
+    for (int i = 2; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--dry-run")
+            dryRun = true;
+        else if (arg == "-y" || arg == "--yes")
+            assumeYes = true;
+        else if (arg.rfind("-", 0) == 0)
         {
-            Canvas::PrintError("Failed to move install.sh to the home directory.");
-            system(("rm -rf " + tempRepoDir).c_str());
-            system(("rm -f " + installScriptPath).c_str());
-            return 1;
+            Canvas::PrintCommandError(argc, argv, HelpText());
+            return 0;
         }
+        else
+            names.push_back(arg);
+    }
+
+    Clean::Run(names, dryRun, assumeYes);
+
+    return 0;
+}
+
+int HandleOpen(int argc, char const *argv[])
+{
+    // Everything after "open" is the query, so names with spaces need no quotes.
+    std::string query;
+    for (int i = 2; i < argc; i++)
+        query += (i > 2 ? " " : "") + std::string(argv[i]);
+
+    return Open::Run(query);
+}
 
-        // Clean up the temporary repository directory.
-        system(("rm -rf " + tempRepoDir).c_str());
+int HandleUpdate(int argc, char const *argv[])
+{
+    std::string source;
+    if (argc == 4 && std::string(argv[2]) == "--source")
+        source = argv[3];
+    else if (argc != 2)
+    {
+        Canvas::PrintCommandError(argc, argv, HelpText());
+        return 0;
+    }
 
-        // Remove any existing installed repository to avoid conflicts.
-        system(("rm -rf " + installedRepoDir).c_str());
+    return Update::Run(source);
+}
 
-        // Set executable permissions on install.sh.
-        std::string chmodCmd = "chmod +x " + installScriptPath;
-        if (system(chmodCmd.c_str()) != 0)
+int HandleGitMaintenance(int argc, char const *argv[])
+{
+    bool all = false;
+    bool dryRun = false;
+    for (int i = 2; i < argc; i++)
+    {
+        std::string flag = argv[i];
+        if (flag == "--all")
+            all = true;
+        else if (flag == "--dry-run")
+            dryRun = true;
+        else
         {
-            Canvas::PrintError("Failed to update permissions of install.sh.");
-            system(("rm -f " + installScriptPath).c_str());
-            return 1;
+            Canvas::PrintCommandError(argc, argv, HelpText());
+            return 0;
         }
+    }
+
+    Maintenance::Run(all, dryRun);
 
-        setenv("HOME_TEMP", getenv("HOME"), 0);
-        setenv("HOME_TEMP", getenv("HOME"), 1);
+    return 0;
+}
 
-        // Run install.sh using sudo.
-        std::string installCmd = installScriptPath;
-        if (system(installCmd.c_str()) != 0)
+int HandleSearch(int argc, char const *argv[])
+{
+    bool ignoreCase = false;
+    bool regex = false;
+    std::string pattern;
+    for (int i = 2; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "-i" || arg == "--ignore-case")
+            ignoreCase = true;
+        else if (arg == "-e" || arg == "--regex")
+            regex = true;
+        else if (pattern.empty())
+            pattern = arg;
+        else
         {
-            Canvas::PrintError("Failed to run install.sh.");
-            // Cleanup in case of failure: remove install.sh and any installed repository.
-            system(("rm -f " + installScriptPath).c_str());
-            system(("rm -rf " + installedRepoDir).c_str());
-            return 1;
+            Canvas::PrintCommandError(argc, argv, HelpText());
+            return 0;
         }
+    }
 
-        // Remove install.sh after it has been executed.
-        system(("rm -f " + installScriptPath).c_str());
-
-        Canvas::PrintInfo("Update complete.");
+    if (pattern.empty())
+    {
+        Canvas::PrintCommandError(argc, argv, HelpText());
         return 0;
     }
-    else if (argc == 2 && command == "open")
-    {
-        DevMap::ListProjects();
 
-        std::string projectName = Canvas::GetStringInput("👉 What project do you want to open? ");
+    Search::Run(pattern, regex, ignoreCase);
 
-        const DevMap::Project *project = DevMap::findProjectByName(DevMap::projects, projectName);
-        std::string editor = Config::get("editor");
-        std::string openCodeCmd = editor + " " + std::string(DevMap::projectsPath / project->lang / project->folderName);
-        if (std::system(openCodeCmd.c_str()) != 0)
-        {
-            Canvas::PrintError(u8"❌ Failed to open the project in Visual Studio Code, make sure its installed and added to your PATH.");
-        }
+    return 0;
+}
+
+int main(int argc, char const *argv[]) {
+    if (!Config::load(Main::HOME_PATH + Main::CONFIG_PATH))
+        SetupConfig(Main::HOME_PATH + Main::CONFIG_PATH);
+
+    if (argc >= 2 && std::string(argv[1]) == "cc")
+        return HandleCompilerCache(argc, argv);
 
+    // Opens no DevMap, so `devcore update` can use it as a smoke test.
+    if (argc == 2 && std::string(argv[1]) == "version")
+    {
+        std::cout << "DevCore (built " << __DATE__ << " " << __TIME__ << " with " << __VERSION__ << ")" << std::endl;
+        return 0;
     }
 
+    // The config commands work without a DevMap, e.g. to fix projects_path.
+    if (argc >= 2 && std::string(argv[1]) == "config")
+        return HandleConfig(argc, argv);
+
+    // Every other command goes through the project store in libdevcore.
+    std::string devmapPath = Main::HOME_PATH + Main::DEVMAP_PATH;
+    if (!fs::exists(devmapPath) && !Projects::Setup(devmapPath))
+        return 0;
+    if (!DevCore::Open(Main::HOME_PATH + Main::CONFIG_PATH, devmapPath, TerminalCallbacks()))
+        return 1;
+
+    if (argc < 2)
+    {
+        Canvas::PrintCommandError(argc, argv, HelpText());
+        return 1;
+    }
 
+    std::string command = argv[1];
 
 
-    Canvas::PrintCommandError(argc, argv);
+    if (command == "devmap")
+    {
+        return HandleDevMap(argc, argv);
+    }
+    else if (command == "-l" || command == "-la" || command == "list" || command == "list-all")
+    {
+        return HandleList(argc, argv);
+    }
+    else if (command == "create-project")
+    {
+        return HandleCreateProject(argc, argv);
+    }
+    else if (command == "delete-project")
+    {
+        return HandleDeleteProject(argc, argv);
+    }
+    else if (command == "create-lang")
+    {
+        return HandleCreateLang(argc, argv);
+    }
+    else if (command == "delete-lang")
+    {
+        return HandleDeleteLang(argc, argv);
+    }
+    else if (command == "add-template")
+    {
+        return HandleAddTemplate(argc, argv);
+    }
+    else if (command == "remove-template")
+    {
+        return HandleRemoveTemplate(argc, argv);
+    }
+    else if (command == "search")
+    {
+        return HandleSearch(argc, argv);
+    }
+    else if (command == "grep")
+    {
+        return HandleGrep(argc, argv);
+    }
+    else if (command == "find")
+    {
+        return HandleFind(argc, argv);
+    }
+    else if (command == "symbol")
+    {
+        return HandleSymbol(argc, argv);
+    }
+    else if (command == "stats")
+    {
+        return HandleStats(argc, argv);
+    }
+    else if (command == "dupes")
+    {
+        return HandleDupes(argc, argv);
+    }
+    else if (command == "du")
+    {
+        return HandleDiskUsage(argc, argv);
+    }
+    else if (command == "build")
+    {
+        return HandleBuild(argc, argv);
+    }
+    else if (command == "depends")
+    {
+        return HandleDepends(argc, argv);
+    }
+    else if (command == "compdb")
+    {
+        return HandleCompDb(argc, argv);
+    }
+    else if (command == "clean")
+    {
+        return HandleClean(argc, argv);
+    }
+    else if (command == "open")
+    {
+        return HandleOpen(argc, argv);
+    }
+    else if (command == "git-maintenance")
+    {
+        return HandleGitMaintenance(argc, argv);
+    }
+    else if (argc == 2 && command == "--help")
+    {
+        PrintHelp();
+        return 0;
+    }
+    else if (argc == 2 && command == "github")
+    {
+        Canvas::PrintBox(Canvas::ColorToAnsi(Canvas::Color::GREEN) + Canvas::BoldText("Follow the github repository and give it a star!") + "\n" + Canvas::LinkText("https://github.com/mathlon26/DevCore-project-manager"), " Give DevCore a star ⭐ ", Canvas::Color::PINK, 1);
+        return 0;
+    }
+    else if (command == "update")
+    {
+        return HandleUpdate(argc, argv);
+    }
+    Canvas::PrintCommandError(argc, argv, HelpText());
     return 1;
 }
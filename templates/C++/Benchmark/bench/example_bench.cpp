@@ -0,0 +1,29 @@
+#include "bench.hpp"
+#include "example.hpp"
+
+#include <numeric>
+#include <vector>
+
+// Example benchmarks: replace them with your own. Every *.cpp file in bench/
+// is its own executable, linked with the project objects except main.
+
+BENCHMARK(sum_loop)
+{
+    std::vector<int> values(4096, 1);
+    state.SetItemsProcessed(values.size());
+    while (state.Running())
+        bench::DoNotOptimize(example::Sum(values));
+}
+
+BENCHMARK(sum_accumulate)
+{
+    std::vector<int> values(4096, 1);
+    state.SetItemsProcessed(values.size());
+    while (state.Running())
+    {
+        bench::DoNotOptimize(values.data());
+        bench::DoNotOptimize(std::accumulate(values.begin(), values.end(), 0L));
+    }
+}
+
+BENCHMARK_MAIN()
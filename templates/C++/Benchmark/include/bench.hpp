@@ -0,0 +1,397 @@
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+// A small self-contained micro-benchmark harness.
+//
+//     #include "bench.hpp"
+//
+//     BENCHMARK(vector_push_back)
+//     {
+//         while (state.Running())
+//         {
+//             std::vector<int> v;
+//             v.push_back(42);
+//             bench::DoNotOptimize(v.data());
+//         }
+//     }
+//
+//     BENCHMARK_MAIN()
+//
+// Every benchmark is calibrated until one sample takes at least --min-time,
+// warmed up, then measured --repetitions times. The process is pinned to a
+// single CPU so samples do not migrate between cores. Results are printed as
+// a table and written as JSON with --json=FILE.
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace bench
+{
+    // Keep the compiler from optimizing away a value (or the computation that
+    // produced it) without adding any instructions of its own.
+    template <typename T>
+    inline void DoNotOptimize(T const &value)
+    {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    template <typename T>
+    inline void DoNotOptimize(T &value)
+    {
+        asm volatile("" : "+r,m"(value) : : "memory");
+    }
+
+    // Force pending writes to memory to be considered observable.
+    inline void ClobberMemory()
+    {
+        asm volatile("" : : : "memory");
+    }
+
+    class State
+    {
+    public:
+        explicit State(uint64_t iterations) : iterations(iterations), remaining(iterations) {}
+
+        // True while the benchmark loop should run another iteration.
+        bool Running()
+        {
+            if (remaining == 0)
+                return false;
+            remaining--;
+            return true;
+        }
+
+        // Work per iteration, reported as throughput when set.
+        void SetItemsProcessed(uint64_t items) { itemsPerIteration = items; }
+        void SetBytesProcessed(uint64_t bytes) { bytesPerIteration = bytes; }
+
+        const uint64_t iterations;
+        uint64_t itemsPerIteration = 0;
+        uint64_t bytesPerIteration = 0;
+
+    private:
+        uint64_t remaining;
+    };
+
+    struct Benchmark
+    {
+        std::string name;
+        std::function<void(State &)> function;
+    };
+
+    inline std::vector<Benchmark> &Registry()
+    {
+        static std::vector<Benchmark> benchmarks;
+        return benchmarks;
+    }
+
+    struct Registrar
+    {
+        Registrar(const char *name, void (*function)(State &)) { Registry().push_back({name, function}); }
+    };
+
+#ifdef __linux__
+    const int MAX_CPU = CPU_SETSIZE - 1; // Highest CPU a cpu_set_t can hold.
+#else
+    const int MAX_CPU = 1023;
+#endif
+
+    struct Options
+    {
+        std::string filter;     // Substring of the benchmark names to run.
+        std::string json;       // Where to write the results, if anywhere.
+        int repetitions = 10;   // Measured samples per benchmark.
+        int warmup = 2;         // Discarded samples before measuring.
+        double minTime = 0.01;  // Seconds per sample.
+        int cpu = -1;           // CPU to pin to; -1 picks the current one.
+        bool pin = true;
+    };
+
+    struct Result
+    {
+        std::string name;
+        uint64_t iterations = 0;
+        std::vector<double> samples; // Nanoseconds per iteration.
+        double min = 0, median = 0, mean = 0, stddev = 0, max = 0;
+        uint64_t itemsPerIteration = 0;
+        uint64_t bytesPerIteration = 0;
+    };
+
+    // Seconds taken by one sample of the given number of iterations.
+    inline double Sample(const Benchmark &benchmark, uint64_t iterations, State *last = nullptr)
+    {
+        State state(iterations);
+        auto start = std::chrono::steady_clock::now();
+        benchmark.function(state);
+        auto end = std::chrono::steady_clock::now();
+        if (last)
+        {
+            last->itemsPerIteration = state.itemsPerIteration;
+            last->bytesPerIteration = state.bytesPerIteration;
+        }
+        return std::chrono::duration<double>(end - start).count();
+    }
+
+    // Grow the iteration count until one sample takes at least minTime.
+    inline uint64_t Calibrate(const Benchmark &benchmark, double minTime)
+    {
+        uint64_t iterations = 1;
+        while (iterations < (uint64_t(1) << 40))
+        {
+            double seconds = Sample(benchmark, iterations);
+            if (seconds >= minTime)
+                break;
+            // Aim a little past the target, at most ten times further per step.
+            double factor = seconds > 0 ? std::min(10.0, 1.2 * minTime / seconds) : 10.0;
+            iterations = std::max(iterations + 1, uint64_t(double(iterations) * factor));
+        }
+        return iterations;
+    }
+
+    inline Result Measure(const Benchmark &benchmark, const Options &options)
+    {
+        Result result;
+        result.name = benchmark.name;
+        result.iterations = Calibrate(benchmark, options.minTime);
+        for (int i = 0; i < options.warmup; i++)
+            Sample(benchmark, result.iterations);
+
+        State last(0);
+        for (int i = 0; i < options.repetitions; i++)
+            result.samples.push_back(Sample(benchmark, result.iterations, &last) * 1e9 / double(result.iterations));
+        result.itemsPerIteration = last.itemsPerIteration;
+        result.bytesPerIteration = last.bytesPerIteration;
+
+        std::vector<double> sorted(result.samples);
+        std::sort(sorted.begin(), sorted.end());
+        size_t n = sorted.size();
+        result.min = sorted.front();
+        result.max = sorted.back();
+        result.median = n % 2 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+        for (double sample : sorted)
+            result.mean += sample / double(n);
+        for (double sample : sorted)
+            result.stddev += (sample - result.mean) * (sample - result.mean);
+        result.stddev = n > 1 ? std::sqrt(result.stddev / double(n - 1)) : 0;
+        return result;
+    }
+
+    // Pin the process to one CPU. Returns the CPU, or -1 when not pinned.
+    inline int PinToCpu(int cpu)
+    {
+#ifdef __linux__
+        if (cpu < 0)
+            cpu = sched_getcpu();
+        if (cpu < 0)
+            return -1;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        if (sched_setaffinity(0, sizeof(set), &set) != 0)
+        {
+            std::fprintf(stderr, "warning: unable to pin to CPU %d\n", cpu);
+            return -1;
+        }
+        return cpu;
+#else
+        (void)cpu;
+        return -1;
+#endif
+    }
+
+    // "12.3 ns", "4.56 us", ... for a duration in nanoseconds.
+    inline std::string FormatTime(double ns)
+    {
+        const char *units[] = {"ns", "us", "ms", "s"};
+        int unit = 0;
+        while (ns >= 1000 && unit < 3)
+        {
+            ns /= 1000;
+            unit++;
+        }
+        char text[32];
+        std::snprintf(text, sizeof(text), "%.3g %s", ns, units[unit]);
+        return text;
+    }
+
+    inline std::string JsonString(const std::string &text)
+    {
+        std::string out = "\"";
+        for (char c : text)
+        {
+            if (c == '"' || c == '\\')
+                out += '\\';
+            out += c;
+        }
+        return out + "\"";
+    }
+
+    inline bool WriteJson(const std::string &path, const std::vector<Result> &results, const Options &options, int cpu)
+    {
+        FILE *file = std::fopen(path.c_str(), "w");
+        if (!file)
+            return false;
+        char date[32];
+        std::time_t now = std::time(nullptr);
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+        std::fprintf(file, "{\n  \"context\": {\"date\": \"%s\", \"cpu\": %d, \"repetitions\": %d, \"warmup\": %d, \"min_time\": %g},\n",
+                     date, cpu, options.repetitions, options.warmup, options.minTime);
+        std::fprintf(file, "  \"benchmarks\": [");
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            const Result &r = results[i];
+            std::fprintf(file, "%s\n    {\"name\": %s, \"iterations\": %llu, \"min_ns\": %g, \"median_ns\": %g, \"mean_ns\": %g, \"stddev_ns\": %g, \"max_ns\": %g",
+                         i ? "," : "", JsonString(r.name).c_str(), (unsigned long long)r.iterations, r.min, r.median, r.mean, r.stddev, r.max);
+            if (r.itemsPerIteration)
+                std::fprintf(file, ", \"items_per_second\": %g", double(r.itemsPerIteration) * 1e9 / r.median);
+            if (r.bytesPerIteration)
+                std::fprintf(file, ", \"bytes_per_second\": %g", double(r.bytesPerIteration) * 1e9 / r.median);
+            std::fprintf(file, ", \"samples_ns\": [");
+            for (size_t s = 0; s < r.samples.size(); s++)
+                std::fprintf(file, "%s%g", s ? ", " : "", r.samples[s]);
+            std::fprintf(file, "]}");
+        }
+        std::fprintf(file, "\n  ]\n}\n");
+        return std::fclose(file) == 0;
+    }
+
+    // A whole decimal number in [min, max]; anything else is an error.
+    inline bool ParseInt(const char *text, int min, int max, int &value)
+    {
+        char *end;
+        errno = 0;
+        long parsed = std::strtol(text, &end, 10);
+        if (end == text || *end != '\0' || errno == ERANGE || parsed < min || parsed > max)
+            return false;
+        value = static_cast<int>(parsed);
+        return true;
+    }
+
+    // A finite number of seconds greater than 0 and at most max.
+    inline bool ParseSeconds(const char *text, double max, double &value)
+    {
+        char *end;
+        errno = 0;
+        double parsed = std::strtod(text, &end);
+        if (end == text || *end != '\0' || errno == ERANGE || !(parsed > 0) || parsed > max)
+            return false;
+        value = parsed;
+        return true;
+    }
+
+    inline bool ParseOptions(int argc, char **argv, Options &options)
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            std::string arg = argv[i];
+            auto value = [&](const char *prefix) -> const char * {
+                size_t length = std::strlen(prefix);
+                return arg.compare(0, length, prefix) == 0 ? argv[i] + length : nullptr;
+            };
+            auto invalid = [&](const char *v, const std::string &expected) {
+                std::fprintf(stderr, "error: invalid value '%s' in %s: expected %s\n", v, argv[i], expected.c_str());
+                return false;
+            };
+            if (const char *v = value("--filter="))
+                options.filter = v;
+            else if (const char *v = value("--json="))
+                options.json = v;
+            else if (const char *v = value("--repetitions="))
+            {
+                if (!ParseInt(v, 1, 1000000, options.repetitions))
+                    return invalid(v, "a whole number from 1 to 1000000");
+            }
+            else if (const char *v = value("--warmup="))
+            {
+                if (!ParseInt(v, 0, 1000000, options.warmup))
+                    return invalid(v, "a whole number from 0 to 1000000");
+            }
+            else if (const char *v = value("--min-time="))
+            {
+                if (!ParseSeconds(v, 3600, options.minTime))
+                    return invalid(v, "seconds greater than 0 and at most 3600");
+            }
+            else if (const char *v = value("--cpu="))
+            {
+                if (!ParseInt(v, 0, MAX_CPU, options.cpu))
+                    return invalid(v, "a CPU number from 0 to " + std::to_string(MAX_CPU));
+            }
+            else if (arg == "--no-pin")
+                options.pin = false;
+            else
+            {
+                std::fprintf(stderr,
+                             "Usage: %s [--filter=TEXT] [--repetitions=N] [--warmup=N] [--min-time=SECONDS]\n"
+                             "          [--cpu=N | --no-pin] [--json=FILE]\n",
+                             argv[0]);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    inline int Main(int argc, char **argv)
+    {
+        Options options;
+        if (!ParseOptions(argc, argv, options))
+            return 2;
+        int cpu = options.pin ? PinToCpu(options.cpu) : -1;
+
+        std::vector<Result> results;
+        std::printf("%-32s %12s %12s %12s %12s %8s\n", "Benchmark", "Iterations", "Min", "Median", "Mean", "CV");
+        for (const Benchmark &benchmark : Registry())
+        {
+            if (benchmark.name.find(options.filter) == std::string::npos)
+                continue;
+            Result r = Measure(benchmark, options);
+            std::printf("%-32s %12llu %12s %12s %12s %7.1f%%", r.name.c_str(), (unsigned long long)r.iterations,
+                        FormatTime(r.min).c_str(), FormatTime(r.median).c_str(), FormatTime(r.mean).c_str(),
+                        r.mean > 0 ? 100 * r.stddev / r.mean : 0.0);
+            if (r.itemsPerIteration)
+                std::printf("  %.3g items/s", double(r.itemsPerIteration) * 1e9 / r.median);
+            if (r.bytesPerIteration)
+                std::printf("  %.3g MB/s", double(r.bytesPerIteration) * 1e3 / r.median);
+            std::printf("\n");
+            std::fflush(stdout);
+            results.push_back(r);
+        }
+
+        if (!options.json.empty() && !WriteJson(options.json, results, options, cpu))
+        {
+            std::fprintf(stderr, "error: unable to write %s\n", options.json.c_str());
+            return 1;
+        }
+        return 0;
+    }
+} // namespace bench
+
+#define BENCH_CONCAT_(a, b) a##b
+#define BENCH_CONCAT(a, b) BENCH_CONCAT_(a, b)
+
+// Define and register a benchmark; the body receives `bench::State &state`.
+#define BENCHMARK(name)                                                                   \
+    static void name(bench::State &state);                                                \
+    static bench::Registrar BENCH_CONCAT(bench_registrar_, __LINE__)(#name, name);        \
+    static void name([[maybe_unused]] bench::State &state)
+
+#define BENCHMARK_MAIN()                        \
+    int main(int argc, char **argv)             \
+    {                                           \
+        return bench::Main(argc, argv);         \
+    }
+
+#endif // BENCH_HPP
@@ -0,0 +1,11 @@
+#ifndef EXAMPLE_HPP
+#define EXAMPLE_HPP
+
+#include <vector>
+
+namespace example
+{
+    long Sum(const std::vector<int> &values);
+}
+
+#endif // EXAMPLE_HPP
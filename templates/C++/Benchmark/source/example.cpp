@@ -0,0 +1,12 @@
+#include "example.hpp"
+
+namespace example
+{
+    long Sum(const std::vector<int> &values)
+    {
+        long sum = 0;
+        for (int value : values)
+            sum += value;
+        return sum;
+    }
+}
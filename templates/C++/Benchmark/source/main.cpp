@@ -0,0 +1,9 @@
+#include "example.hpp"
+
+#include <iostream>
+
+int main()
+{
+    std::cout << example::Sum({1, 2, 3}) << std::endl;
+    return 0;
+}
@@ -0,0 +1,141 @@
+/* The C ABI of libdevcore (include/devcore.h), called from C: opening the
+ * store, the query functions, the list accessors and the error reporting. */
+#include "../include/devcore.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+static int failures = 0;
+
+#define CHECK(expression) \
+    do \
+    { \
+        if (!(expression)) \
+        { \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #expression); \
+            failures++; \
+        } \
+    } while (0)
+
+static void WriteFile(const char *relative, const char *content)
+{
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/Coding/Projects/%s", getenv("HOME"), relative);
+    for (char *slash = strchr(path + 1, '/'); slash; slash = strchr(slash + 1, '/'))
+    {
+        *slash = '\0';
+        mkdir(path, 0755);
+        *slash = '/';
+    }
+    FILE *file = fopen(path, "w");
+    if (file)
+    {
+        fputs(content, file);
+        fclose(file);
+    }
+}
+
+static int EndsWith(const char *text, const char *suffix)
+{
+    size_t length = strlen(text), suffixLength = strlen(suffix);
+    return length >= suffixLength && strcmp(text + length - suffixLength, suffix) == 0;
+}
+
+struct Seen
+{
+    int progress;
+    int errors;
+};
+
+static void OnError(const char *message, void *user)
+{
+    fprintf(stderr, "error: %s\n", message);
+    ((struct Seen *)user)->errors++;
+}
+
+static void OnProgress(size_t done, size_t total, void *user)
+{
+    if (done <= total)
+        ((struct Seen *)user)->progress++;
+}
+
+int main(void)
+{
+    const char *sandbox = getenv("DEVCORE_TEST_HOME");
+    if (!sandbox || !getenv("HOME") || strcmp(sandbox, getenv("HOME")) != 0)
+    {
+        fprintf(stderr, "Run the tests through tests/run.sh.\n");
+        return 1;
+    }
+
+    /* Nothing works before the store is open, and the reason is kept. */
+    CHECK(!devcore_is_open());
+    CHECK(!devcore_sync(NULL));
+    CHECK(strlen(devcore_last_error()) > 0);
+    CHECK(devcore_list_size(NULL) == 0);
+    CHECK(devcore_list_data(NULL) == NULL);
+    CHECK(devcore_list_get(NULL, 0) == NULL);
+    devcore_list_free(NULL);
+
+    WriteFile("C++/alpha/src/main.cpp", "int main() { return 0; }\n");
+    WriteFile("C++/beta/include/beta.hpp", "struct Beta {};\n");
+    WriteFile("Python/tool/run.py", "print('hi')\n");
+
+    struct Seen seen = {0, 0};
+    devcore_callbacks callbacks = {NULL, OnError, OnProgress, &seen};
+    CHECK(devcore_open(NULL, NULL, &callbacks));
+    CHECK(devcore_is_open());
+    CHECK(seen.errors == 0);
+    CHECK(EndsWith(devcore_projects_path(), "/Coding/Projects/"));
+
+    devcore_list *all = devcore_projects();
+    CHECK(all && devcore_list_size(all) == 3);
+    for (size_t i = 0; i < devcore_list_size(all); i++)
+        CHECK(devcore_list_get(all, i) == devcore_list_data(all) + i);
+    CHECK(devcore_list_get(all, devcore_list_size(all)) == NULL);
+
+    devcore_list *cpp = devcore_projects_by_language("C++");
+    CHECK(devcore_list_size(cpp) == 2);
+    for (size_t i = 0; i < devcore_list_size(cpp); i++)
+        CHECK(strcmp(devcore_list_get(cpp, i)->lang, "C++") == 0);
+    devcore_list_free(cpp);
+    cpp = devcore_projects_by_language("Cobol");
+    CHECK(cpp && devcore_list_size(cpp) == 0);
+    devcore_list_free(cpp);
+
+    devcore_list *found = devcore_find_project("alpha");
+    CHECK(devcore_list_size(found) == 1);
+    const devcore_project *alpha = devcore_list_get(found, 0);
+    if (alpha)
+    {
+        CHECK(strcmp(alpha->name, "alpha") == 0);
+        CHECK(strcmp(alpha->folder_name, "alpha") == 0);
+        CHECK(EndsWith(alpha->path, "/C++/alpha"));
+        CHECK(alpha->size == strlen("int main() { return 0; }\n"));
+        CHECK(alpha->file_count == 1);
+        CHECK(!alpha->uses_git && strcmp(alpha->git_branch, "") == 0);
+        CHECK(alpha->dependency_count == 0);
+    }
+    devcore_list_free(found);
+    found = devcore_find_project("missing");
+    CHECK(found && devcore_list_size(found) == 0);
+    devcore_list_free(found);
+    found = devcore_find_project(NULL);
+    CHECK(found && devcore_list_size(found) == 0);
+    devcore_list_free(found);
+
+    /* A list is a snapshot: it stays readable after the store changes. */
+    WriteFile("C++/gamma/main.c", "int main(void) { return 0; }\n");
+    CHECK(devcore_sync(&callbacks));
+    CHECK(seen.progress >= 3); /* Projects already in the DevMap. */
+    CHECK(devcore_list_size(all) == 3);
+    CHECK(strlen(devcore_list_get(all, 0)->name) > 0);
+    devcore_list_free(all);
+    all = devcore_projects();
+    CHECK(devcore_list_size(all) == 4);
+    devcore_list_free(all);
+
+    printf("CApiTest: %s\n", failures ? "FAILED" : "ok");
+    return failures ? 1 : 0;
+}
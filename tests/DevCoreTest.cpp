@@ -0,0 +1,42 @@
+#include "Test.hpp"
+#include "../include/DevCore.hpp"
+
+// Creating projects through the store: names that are not a single folder
+// and folders that are already there are refused without touching disk.
+
+int main()
+{
+    if (!Test::SandboxHome())
+        return 1;
+
+    fs::path projects = fs::path(Main::HOME_PATH) / "Coding/Projects";
+    Test::WriteFile(projects / "C++/alpha/main.cpp", "int main() { return 0; }\n");
+    std::string error;
+    DevCore::Callbacks callbacks;
+    callbacks.error = [&error](const std::string &message) { error = message; };
+    CHECK(DevCore::Open("", "", callbacks));
+
+    CHECK(DevCore::CreateProject("beta", "C++"));
+    CHECK(fs::is_directory(projects / "C++/beta"));
+    DevCore::Project beta;
+    CHECK(DevCore::FindProject("beta", beta));
+
+    for (const char *name : {".", "..", "a/b", "../escape"})
+    {
+        error.clear();
+        CHECK(!DevCore::CreateProject(name, "C++"));
+        CHECK(!error.empty());
+        CHECK(!DevCore::CreateProject("gamma", "C++", name));
+    }
+    CHECK(!fs::exists(projects / "escape"));
+    CHECK(!fs::exists(projects / "C++/a"));
+
+    // A folder on disk or in the DevMap is never reused under another name.
+    fs::create_directories(projects / "C++/stray");
+    CHECK(!DevCore::CreateProject("stray", "C++"));
+    CHECK(!DevCore::CreateProject("other", "C++", "beta"));
+    CHECK(!DevCore::CreateProject("beta", "C++", "delta"));
+    CHECK(!fs::exists(projects / "C++/delta"));
+    CHECK(DevCore::Projects().size() == 2);
+    return Test::Result("DevCoreTest");
+}
@@ -0,0 +1,105 @@
+#include "Test.hpp"
+#include "../include/Dupes.hpp"
+
+// The stages of `devcore dupes`: the edge hash only separates files that
+// differ near their ends, the content hash separates the rest, and Refine
+// keeps only groups that still have more than one file.
+
+static Dupes::File Make(const std::string &name, const std::string &content)
+{
+    fs::path path = fs::path(Main::HOME_PATH) / "dupes" / name;
+    Test::WriteFile(path, content);
+    return {0, name, path.string(), content.size(), 0, 0};
+}
+
+static std::vector<std::string> Names(const std::vector<std::vector<Dupes::File>> &groups)
+{
+    std::vector<std::string> names;
+    for (const auto &group : groups)
+    {
+        std::vector<std::string> members;
+        for (const auto &file : group)
+            members.push_back(file.relative);
+        std::sort(members.begin(), members.end());
+        std::string joined;
+        for (const auto &member : members)
+            joined += (joined.empty() ? "" : "+") + member;
+        names.push_back(joined);
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+static void Edges()
+{
+    // Larger than two blocks: the middle is not part of the edge hash.
+    std::string big(3 * Dupes::EDGE_BLOCK, 'x');
+    std::string middle = big, head = big, tail = big;
+    middle[big.size() / 2] = 'y';
+    head[0] = 'y';
+    tail[big.size() - 1] = 'y';
+    Dupes::File a = Make("big", big), b = Make("middle", middle), c = Make("head", head), d = Make("tail", tail);
+    for (auto *file : {&a, &b, &c, &d})
+        CHECK(Dupes::HashEdges(*file));
+    CHECK(a.hash == b.hash);
+    CHECK(a.hash != c.hash && a.hash != d.hash && c.hash != d.hash);
+
+    // Up to two blocks the edges are the whole file.
+    std::string small(2 * Dupes::EDGE_BLOCK, 'x');
+    std::string changed = small;
+    changed[Dupes::EDGE_BLOCK] = 'y';
+    Dupes::File e = Make("small", small), f = Make("changed", changed);
+    CHECK(Dupes::HashEdges(e) && Dupes::HashEdges(f));
+    CHECK(e.hash != f.hash);
+
+    // Empty files and missing files.
+    Dupes::File empty = Make("empty", "");
+    CHECK(Dupes::HashEdges(empty));
+    Dupes::File gone = Make("gone", "content");
+    fs::remove(gone.path);
+    CHECK(!Dupes::HashEdges(gone));
+    CHECK(!Dupes::HashContent(gone));
+}
+
+static void Content()
+{
+    std::string big(Dupes::READ_BLOCK + 12345, 'x'); // More than one read.
+    std::string middle = big;
+    middle[Dupes::READ_BLOCK + 1] = 'y';
+    Dupes::File a = Make("big", big), b = Make("copy", big), c = Make("middle", middle);
+    for (auto *file : {&a, &b, &c})
+        CHECK(Dupes::HashContent(*file));
+    CHECK(a.hash == b.hash);
+    CHECK(a.hash != c.hash);
+}
+
+static void Stages()
+{
+    std::string big(3 * Dupes::EDGE_BLOCK, 'x');
+    std::string middle = big, head = big;
+    middle[big.size() / 2] = 'y';
+    head[0] = 'y';
+    Dupes::File gone = Make("gone", big);
+    std::vector<std::vector<Dupes::File>> bySize{
+        {Make("a", big), Make("b", big), Make("middle", middle), Make("head", head), gone},
+        {Make("lonely", "only one of its size")},
+        {Make("c", "same"), Make("d", "same")},
+    };
+    fs::remove(gone.path);
+
+    auto edges = Dupes::Refine(bySize, Dupes::HashEdges);
+    CHECK(Names(edges) == (std::vector<std::string>{"a+b+middle", "c+d"}));
+    auto content = Dupes::Refine(edges, Dupes::HashContent);
+    CHECK(Names(content) == (std::vector<std::string>{"a+b", "c+d"}));
+    CHECK(Dupes::Refine({}, Dupes::HashContent).empty());
+}
+
+int main()
+{
+    if (!Test::SandboxHome())
+        return 1;
+    Edges();
+    Content();
+    Stages();
+    return Test::Result("DupesTest");
+}
@@ -0,0 +1,164 @@
+#include "Test.hpp"
+#include "../include/FileCache.hpp"
+#include <algorithm>
+
+// The per-project file caches shared by Stats and Symbols, through a format
+// whose payload is the number of lines: the header and per-file fields
+// survive a reload, only changed files are read again, and a damaged or
+// truncated cache is dropped instead of read.
+
+namespace
+{
+    struct Entry
+    {
+        std::string path;
+        int64_t mtime = 0;
+        uint64_t size = 0;
+        uint32_t lines = 0;
+    };
+
+    struct Format
+    {
+        using Entry = ::Entry;
+        static constexpr const char *MAGIC = "DCTT";
+        static constexpr const char *DIRECTORY = "test";
+        static const uint32_t VERSION = 1;
+
+        static void Put(std::string &out, const Entry &entry)
+        {
+            Binary::Put<uint32_t>(out, entry.lines);
+        }
+
+        static bool Get(const char *data, size_t size, size_t &pos, Entry &entry)
+        {
+            return Binary::Get(data, size, pos, entry.lines);
+        }
+
+        static void Read(const std::string &path, Entry &entry)
+        {
+            std::string content = Test::ReadFile(path);
+            entry.lines = static_cast<uint32_t>(std::count(content.begin(), content.end(), '\n'));
+        }
+    };
+} // namespace
+
+static const std::string KEY = "C++/alpha";
+
+static fs::path Root()
+{
+    return fs::path(Main::HOME_PATH) / "Coding/Projects" / KEY;
+}
+
+static std::vector<Entry> Update(size_t &refreshed, std::vector<std::string> paths = {"a.txt", "dir/b.txt"})
+{
+    FileCache::Project project{KEY, Root(), std::move(paths)};
+    return FileCache::Update<Format>({project}, refreshed).at(0);
+}
+
+static void RoundTrip()
+{
+    Test::WriteFile(Root() / "a.txt", "one\n");
+    Test::WriteFile(Root() / "dir/b.txt", "one\ntwo\n");
+    Test::SetMTime(Root() / "a.txt", 1700000000, 100);
+
+    size_t refreshed;
+    std::vector<Entry> files = Update(refreshed);
+    CHECK(refreshed == 2);
+    CHECK(files.size() == 2);
+    CHECK(files[0].path == "a.txt" && files[0].size == 4 && files[0].lines == 1);
+    CHECK(files[0].mtime == int64_t(1700000000) * 1000000000 + 100);
+    CHECK(files[1].path == "dir/b.txt" && files[1].lines == 2);
+
+    const std::string index = Test::ReadFile(FileCache::IndexPath<Format>(KEY));
+    CHECK(index.compare(0, 4, "DCTT") == 0);
+    CHECK(index.compare(4, 4, Test::Bytes<uint32_t>(Format::VERSION)) == 0);
+    CHECK(index.compare(8, 4, Test::Bytes<uint32_t>(2)) == 0);
+
+    std::vector<Entry> loaded = FileCache::Load<Format>(KEY);
+    CHECK(loaded.size() == files.size());
+    for (size_t i = 0; i < std::min(loaded.size(), files.size()); i++)
+    {
+        CHECK(loaded[i].path == files[i].path);
+        CHECK(loaded[i].mtime == files[i].mtime);
+        CHECK(loaded[i].size == files[i].size);
+        CHECK(loaded[i].lines == files[i].lines);
+    }
+
+    // Unchanged files come from the cache.
+    files = Update(refreshed);
+    CHECK(refreshed == 0);
+    CHECK(files[1].lines == 2);
+
+    // A same-size edit within the same second is still seen.
+    Test::WriteFile(Root() / "a.txt", "o\nn\n");
+    Test::SetMTime(Root() / "a.txt", 1700000000, 200);
+    files = Update(refreshed);
+    CHECK(refreshed == 1);
+    CHECK(files[0].lines == 2);
+
+    // A file that left the project leaves the cache.
+    files = Update(refreshed, {"dir/b.txt"});
+    CHECK(refreshed == 0);
+    CHECK(FileCache::Load<Format>(KEY).size() == 1);
+    Update(refreshed);
+    CHECK(refreshed == 1);
+}
+
+// The walk already stat'ed the files: entries with the cached mtime and
+// size are reused, the others are read.
+static void FromScan()
+{
+    std::vector<Entry> cached = FileCache::Load<Format>(KEY);
+    CHECK(cached.size() == 2);
+    std::vector<Entry> found = cached;
+    for (auto &entry : found)
+        entry.lines = 0;
+    found[1].size++;
+
+    size_t refreshed;
+    std::vector<Entry> files = FileCache::UpdateProject<Format>({KEY, Root(), {}}, found, refreshed);
+    CHECK(refreshed == 1);
+    CHECK(files.size() == 2 && files[0].lines == 2 && files[1].lines == 2);
+    CHECK(FileCache::Load<Format>(KEY)[1].size == cached[1].size + 1);
+}
+
+static void Damaged()
+{
+    const std::string path = FileCache::IndexPath<Format>(KEY);
+    const std::string full = Test::ReadFile(path);
+    CHECK(FileCache::Load<Format>(KEY).size() == 2);
+
+    for (size_t size = 0; size < full.size(); size++)
+    {
+        Test::WriteFile(path, full.substr(0, size));
+        CHECK(FileCache::Load<Format>(KEY).empty());
+    }
+
+    auto patched = [&](size_t offset, const std::string &bytes) {
+        Test::WritePatched(path, full, offset, bytes);
+        return FileCache::Load<Format>(KEY);
+    };
+    CHECK(patched(0, "XXXX").empty());
+    CHECK(patched(4, Test::Bytes<uint32_t>(Format::VERSION + 1)).empty());
+    CHECK(patched(8, Test::Bytes<uint32_t>(0xffffffff)).empty()); // fileCount larger than the file.
+    CHECK(patched(8, Test::Bytes<uint32_t>(3)).empty());          // One record more than written.
+    CHECK(patched(12, "\xff\xff\xff\xff\x0f").empty());            // First path longer than the file.
+
+    // A damaged cache is rewritten by the next update.
+    size_t refreshed;
+    patched(0, "XXXX");
+    Update(refreshed);
+    CHECK(refreshed == 2);
+    CHECK(Test::ReadFile(path).compare(0, 4, "DCTT") == 0);
+    CHECK(FileCache::Load<Format>(KEY).size() == 2);
+}
+
+int main()
+{
+    if (!Test::SandboxHome())
+        return 1;
+    RoundTrip();
+    FromScan();
+    Damaged();
+    return Test::Result("FileCacheTest");
+}
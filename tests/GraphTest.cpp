@@ -0,0 +1,105 @@
+#include "Test.hpp"
+#include "../include/Graph.hpp"
+
+// The project dependency graph: edges from dependency names, cycle
+// detection and the up- and downstream closures `devcore build` uses.
+
+struct Node
+{
+    std::string name;
+    std::vector<std::string> dependencies;
+};
+
+static Graph::Dag Dag(const std::vector<Node> &nodes, std::vector<std::string> &missing)
+{
+    return Graph::FromProjects(nodes, missing);
+}
+
+// A cycle is valid when it starts and ends at the same node and every step
+// follows a dependency edge.
+static bool IsCycle(const Graph::Dag &dag, const std::vector<size_t> &cycle)
+{
+    if (cycle.size() < 2 || cycle.front() != cycle.back())
+        return false;
+    for (size_t i = 0; i + 1 < cycle.size(); i++)
+    {
+        const auto &edges = dag.dependencies[cycle[i]];
+        if (std::find(edges.begin(), edges.end(), cycle[i + 1]) == edges.end())
+            return false;
+    }
+    return true;
+}
+
+static void Edges()
+{
+    std::vector<std::string> missing;
+    std::vector<Node> nodes{{"app", {"core", "ui", "gone"}}, {"core", {}}, {"ui", {"core"}}};
+    Graph::Dag dag = Dag(nodes, missing);
+    CHECK(dag.dependencies[0] == (std::vector<size_t>{1, 2}));
+    CHECK(dag.dependencies[2] == (std::vector<size_t>{1}));
+    CHECK(dag.dependents[1] == (std::vector<size_t>{0, 2}));
+    CHECK(missing == (std::vector<std::string>{"app -> gone"}));
+    CHECK(Graph::FindCycle(dag).empty());
+}
+
+static void Cycles()
+{
+    std::vector<std::string> missing;
+
+    // A diamond shares a dependency but has no cycle.
+    std::vector<Node> diamond{{"a", {"b", "c"}}, {"b", {"d"}}, {"c", {"d"}}, {"d", {}}};
+    CHECK(Graph::FindCycle(Dag(diamond, missing)).empty());
+
+    std::vector<Node> self{{"a", {}}, {"b", {"b"}}};
+    Graph::Dag dag = Dag(self, missing);
+    CHECK(Graph::FindCycle(dag) == (std::vector<size_t>{1, 1}));
+    CHECK(Graph::CycleToString(self, Graph::FindCycle(dag)) == "b -> b");
+
+    std::vector<Node> two{{"a", {"b"}}, {"b", {"a"}}};
+    dag = Dag(two, missing);
+    CHECK(Graph::CycleToString(two, Graph::FindCycle(dag)) == "a -> b -> a");
+
+    // A cycle reached through an acyclic part, after a finished branch.
+    std::vector<Node> tail{{"root", {"done", "x"}}, {"done", {}}, {"x", {"y"}}, {"y", {"z"}}, {"z", {"x"}}};
+    dag = Dag(tail, missing);
+    std::vector<size_t> cycle = Graph::FindCycle(dag);
+    CHECK(IsCycle(dag, cycle));
+    CHECK(Graph::CycleToString(tail, cycle) == "x -> y -> z -> x");
+
+    // A long chain, then closed at the end: the search is iterative, so the
+    // depth is not limited by the stack.
+    const size_t length = 100000;
+    dag = Graph::Dag();
+    dag.dependencies.resize(length);
+    for (size_t i = 0; i + 1 < length; i++)
+        dag.dependencies[i] = {i + 1};
+    CHECK(Graph::FindCycle(dag).empty());
+    dag.dependencies.back() = {0};
+    cycle = Graph::FindCycle(dag);
+    CHECK(cycle.size() == length + 1);
+    CHECK(IsCycle(dag, cycle));
+}
+
+static void Closures()
+{
+    std::vector<std::string> missing;
+    std::vector<Node> nodes{{"app", {"ui"}}, {"ui", {"core"}}, {"core", {}}, {"tool", {"core"}}, {"other", {}}};
+    Graph::Dag dag = Dag(nodes, missing);
+    CHECK(Graph::Closure(dag.dependencies, {0}) == (std::set<size_t>{0, 1, 2}));
+    CHECK(Graph::Closure(dag.dependents, {2}) == (std::set<size_t>{0, 1, 2, 3}));
+    CHECK(Graph::Closure(dag.dependents, {4}) == (std::set<size_t>{4}));
+    CHECK(Graph::Closure(dag.dependencies, {}).empty());
+
+    // Terminates on cycles.
+    std::vector<Node> two{{"a", {"b"}}, {"b", {"a"}}};
+    dag = Dag(two, missing);
+    CHECK(Graph::Closure(dag.dependencies, {0}) == (std::set<size_t>{0, 1}));
+}
+
+int main()
+{
+    Edges();
+    Cycles();
+    Closures();
+    return Test::Result("GraphTest");
+}
@@ -0,0 +1,46 @@
+#include "Test.hpp"
+#include "../include/Ignore.hpp"
+
+// The ignore rules every project walk uses: VCS metadata always, the usual
+// build and editor directories unless the project's ignore files say
+// otherwise, then the project's own patterns.
+
+static fs::path Root()
+{
+    return fs::path(Main::HOME_PATH) / "Coding/Projects/C++/alpha";
+}
+
+int main()
+{
+    if (!Test::SandboxHome())
+        return 1;
+
+    Test::WriteFile(Root() / ".gitignore", "*.o\nout/\n/docs/*.tmp\n");
+    Ignore::Rules rules = Ignore::Load(Root());
+    CHECK(rules.Matches(".git", true));
+    CHECK(rules.Matches("vendor/lib/.git", true));
+    CHECK(rules.Matches("build", true));
+    CHECK(rules.Matches("src/build", true));
+    CHECK(rules.Matches("web/node_modules", true));
+    CHECK(!rules.Matches("build", false)); // A file named build is kept.
+    CHECK(!rules.Matches("src/builder", true));
+    CHECK(rules.Matches("src/main.o", false));
+    CHECK(rules.Matches("out", true) && !rules.Matches("out", false));
+    CHECK(rules.Matches("docs/a.tmp", false) && !rules.Matches("src/docs/a.tmp", false));
+    CHECK(!rules.Matches("src/main.cpp", false));
+
+    // Negation brings default directories back, but never VCS metadata.
+    Test::WriteFile(Root() / ".devcoreignore", "!build/\n!.git/\n!/tools/target/\n");
+    rules = Ignore::Load(Root());
+    CHECK(!rules.Matches("build", true));
+    CHECK(!rules.Matches("src/build", true));
+    CHECK(!rules.Matches("tools/target", true));
+    CHECK(rules.Matches("target", true));
+    CHECK(rules.Matches(".git", true));
+
+    // Without ignore files only VCS metadata is skipped.
+    Ignore::Rules none;
+    CHECK(none.Matches(".svn", true));
+    CHECK(!none.Matches("build", true));
+    return Test::Result("IgnoreTest");
+}
@@ -0,0 +1,135 @@
+#include "Test.hpp"
+#include "../include/Query.hpp"
+
+// The --where/--sort/--limit language of `devcore list projects`: what a
+// query selects, in which order, and which queries are rejected.
+
+static std::vector<DevCore::Project> Sample()
+{
+    auto project = [](const std::string &name, const std::string &lang, const std::string &user, uint64_t size, bool git, bool dirty) {
+        DevCore::Project proj;
+        proj.name = name;
+        proj.folderName = name;
+        proj.lang = lang;
+        proj.createdBy = user;
+        proj.size = size;
+        proj.usesGit = git;
+        proj.gitDirty = dirty;
+        return proj;
+    };
+    std::vector<DevCore::Project> projects{
+        project("engine", "C++", "alice", 300ull << 20, true, true),  // 0
+        project("tools", "Python", "bob", 2ull << 20, true, false),   // 1
+        project("webapp", "TypeScript", "alice", 50ull << 20, false, false), // 2
+        project("Engine2", "C++", "carol", 1ull << 30, true, false),  // 3
+    };
+    time_t now = std::time(nullptr);
+    projects[0].lastActivity = now - 3600;        // 1 hour ago.
+    projects[1].lastActivity = now - 40 * 86400;  // 40 days ago.
+    projects[2].lastActivity = 0;                 // Unknown.
+    projects[3].lastActivity = now - 10 * 86400;  // 10 days ago.
+    projects[3].dependencies = {"engine", "tools"};
+    return projects;
+}
+
+// The rows a query selects, or {99} when it does not compile.
+static std::vector<size_t> Select(const std::string &where, const std::string &sort = "", size_t limit = 0)
+{
+    static const std::vector<DevCore::Project> projects = Sample();
+    Query::Plan plan;
+    std::string error;
+    if (!Query::Compile(where, sort, limit, plan, error))
+        return {99};
+    Query::Columns columns(projects);
+    return Query::Select(plan, columns);
+}
+
+static std::string Error(const std::string &where, const std::string &sort = "")
+{
+    Query::Plan plan;
+    std::string error;
+    Query::Compile(where, sort, 0, plan, error);
+    return error;
+}
+
+static void Comparisons()
+{
+    using Rows = std::vector<size_t>;
+    CHECK(Select("") == (Rows{0, 1, 2, 3}));
+    CHECK(Select("lang=C++") == (Rows{0, 3}));
+    CHECK(Select("lang != C++") == (Rows{1, 2}));
+    CHECK(Select("name~ENGINE") == (Rows{0, 3}));  // Case-insensitive substring.
+    CHECK(Select("name=engine") == (Rows{0}));     // Exact.
+    CHECK(Select("name='Engine2'") == (Rows{3}));  // Quoted values.
+    CHECK(Select("size>100M") == (Rows{0, 3}));
+    CHECK(Select("size>=1G") == (Rows{3}));
+    CHECK(Select("size<2MiB") == (Rows{}));
+    CHECK(Select("size<=2MiB") == (Rows{1}));
+    CHECK(Select("deps>=2") == (Rows{3}));
+    CHECK(Select("git") == (Rows{0, 1, 3}));       // A flag alone means yes.
+    CHECK(Select("git=no") == (Rows{2}));
+    CHECK(Select("dirty") == (Rows{0}));
+    CHECK(Select("idle>30d") == (Rows{1}));
+    CHECK(Select("idle<2h and activity>2000-01-01") == (Rows{0}));
+}
+
+static void Combinations()
+{
+    using Rows = std::vector<size_t>;
+    CHECK(Select("lang=C++ and git and not dirty") == (Rows{3}));
+    CHECK(Select("user=alice or user=bob") == (Rows{0, 1, 2}));
+    // and binds tighter than or.
+    CHECK(Select("user=bob or user=alice and git") == (Rows{0, 1}));
+    CHECK(Select("(user=bob or user=alice) and git") == (Rows{0, 1}));
+    CHECK(Select("(user=bob or user=alice) and not git") == (Rows{2}));
+    CHECK(Select("NOT (lang=C++ OR lang=Python)") == (Rows{2})); // Keywords in any case.
+    CHECK(Select("not not dirty") == (Rows{0}));
+}
+
+static void Sorting()
+{
+    using Rows = std::vector<size_t>;
+    CHECK(Select("", "size") == (Rows{1, 2, 0, 3}));
+    CHECK(Select("", "-size") == (Rows{3, 0, 2, 1}));
+    CHECK(Select("", "-size", 2) == (Rows{3, 0}));
+    CHECK(Select("git", "-size", 1) == (Rows{3}));
+    CHECK(Select("", "-lang,name") == (Rows{2, 1, 3, 0})); // Then by name: "Engine2" < "engine".
+    CHECK(Select("", "user", 10) == (Rows{0, 2, 1, 3}));   // Ties keep DevMap order.
+    CHECK(Select("", "", 3) == (Rows{0, 1, 2}));
+}
+
+static void Errors()
+{
+    CHECK(Select("lang=") == std::vector<size_t>{99});
+    CHECK(Error("colour=red").find("Unknown field 'colour'") == 0);
+    CHECK(Error("size").find("Expected an operator after 'size'") == 0);
+    CHECK(Error("size>lots").find("'lots' is not a size like 100M for 'size'") == 0);
+    CHECK(Error("size>nan").find("'nan' is not a size") == 0);
+    CHECK(Error("size>inf").find("'inf' is not a size") == 0);
+    CHECK(Error("size>1e30T").find("'1e30T' is not a size") == 0);
+    CHECK(Error("lines>9223372036854775807").find("is not a number") != std::string::npos); // Rounds to 2^63.
+    CHECK(Error("idle>1e30d").find("'1e30d' is not a duration") == 0);
+    CHECK(Error("idle>nan").find("is not a duration") != std::string::npos);
+    CHECK(Error("idle>-1d").find("is not a duration") != std::string::npos);
+    CHECK(Error("size~1M").find("'~' only applies to text fields") == 0);
+    CHECK(Error("created>2024-13-45").find("is not a date") != std::string::npos);
+    CHECK(Error("idle>3y").find("is not a duration") != std::string::npos);
+    CHECK(Error("git=maybe").find("is not yes or no") != std::string::npos);
+    CHECK(Error("name<>x").find("Expected a value after '<'") == 0);
+    CHECK(Error("(lang=C++").find("Expected ')'") == 0);
+    CHECK(Error("lang=C++)").find("Unexpected ')'") == 0);
+    CHECK(Error("lang=C++ and").find("Expected a field") == 0);
+    CHECK(Error("name='abc").find("Unterminated string") == 0);
+    CHECK(Error("lang=C++ git") == "Unexpected 'git' at column 10 of the query.");
+    CHECK(Error("", "-colour").find("Unknown sort field 'colour'") == 0);
+    CHECK(Error("", ",").find("Unknown sort field ''") == 0);
+}
+
+int main()
+{
+    Comparisons();
+    Combinations();
+    Sorting();
+    Errors();
+    return Test::Result("QueryTest");
+}
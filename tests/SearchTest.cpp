@@ -0,0 +1,123 @@
+#include "Test.hpp"
+#include "../include/Search.hpp"
+
+// The trigram index of `devcore search`: what WriteIndex writes LoadIndex and
+// Candidates read back, and a damaged index is rejected instead of read.
+
+static Search::FileEntry Entry(const std::string &path, const std::string &content, bool binary = false)
+{
+    Search::FileEntry file;
+    file.path = path;
+    file.mtime = 1700000000123456789;
+    file.size = content.size();
+    file.binary = binary;
+    if (!binary)
+        file.trigrams = Search::EncodeSorted(Search::ExtractTrigrams(content.data(), content.size()));
+    return file;
+}
+
+static std::vector<uint32_t> Candidates(const std::string &literal, bool &narrowed)
+{
+    Binary::MappedFile index(Search::IndexPath());
+    Search::Header header;
+    std::vector<uint32_t> ids;
+    narrowed = index.isOpen() && Search::ReadHeader(index.data(), index.size(), header) &&
+               Search::Candidates(index, header, {literal}, ids);
+    return ids;
+}
+
+static void RoundTrip()
+{
+    std::vector<Search::FileEntry> files{
+        Entry("C++/alpha/src/main.cpp", "int main() { return Widget().size(); }\n"),
+        Entry("C++/alpha/src/widget.hpp", "struct Widget { int size() const; };\n"),
+        Entry("C++/beta/logo.png", "", true),
+        Entry("C++/beta/notes.txt", "Nothing to see here.\n"),
+    };
+    CHECK(Search::WriteIndex(files));
+
+    std::vector<Search::FileEntry> loaded = Search::LoadIndex();
+    CHECK(loaded.size() == files.size());
+    for (size_t i = 0; i < std::min(loaded.size(), files.size()); i++)
+    {
+        CHECK(loaded[i].path == files[i].path);
+        CHECK(loaded[i].mtime == files[i].mtime);
+        CHECK(loaded[i].size == files[i].size);
+        CHECK(loaded[i].binary == files[i].binary);
+        CHECK(loaded[i].trigrams == files[i].trigrams);
+    }
+
+    bool narrowed;
+    CHECK((Candidates("Widget", narrowed) == std::vector<uint32_t>{0, 1}) && narrowed);
+    CHECK((Candidates("WIDGET", narrowed) == std::vector<uint32_t>{0, 1}) && narrowed); // Case folded.
+    CHECK((Candidates("see here", narrowed) == std::vector<uint32_t>{3}) && narrowed);
+    CHECK(Candidates("not in any file", narrowed).empty() && narrowed);
+    Candidates("ab", narrowed);
+    CHECK(!narrowed); // Too short to have a trigram.
+}
+
+// Every prefix of the index: either rejected as a whole or read without
+// going past the end. A complete file table means the header was intact.
+static void Truncated()
+{
+    std::string full = Test::ReadFile(Search::IndexPath());
+    Search::Header header;
+    CHECK(Search::ReadHeader(full.data(), full.size(), header));
+    for (size_t size = 0; size < full.size(); size++)
+    {
+        Test::WriteFile(Search::IndexPath(), full.substr(0, size));
+        std::vector<Search::FileEntry> loaded = Search::LoadIndex();
+        if (size < header.postingsOffset)
+            CHECK(loaded.empty());
+        else
+            CHECK(loaded.size() == header.fileCount);
+        bool narrowed;
+        Candidates("Widget", narrowed); // Must stay inside the mapping.
+    }
+    Test::WriteFile(Search::IndexPath(), full);
+}
+
+static void Damaged()
+{
+    const std::string full = Test::ReadFile(Search::IndexPath());
+    auto patched = [&](size_t offset, const std::string &bytes) {
+        Test::WritePatched(Search::IndexPath(), full, offset, bytes);
+        return Search::LoadIndex();
+    };
+    auto u32 = Test::Bytes<uint32_t>;
+    auto u64 = Test::Bytes<uint64_t>;
+
+    CHECK(patched(0, "XXXX").empty());                           // Magic.
+    CHECK(patched(4, u32(Search::INDEX_VERSION + 1)).empty());   // Version.
+    CHECK(patched(8, u32(1000000)).empty());                     // fileCount beyond the file table.
+    CHECK(patched(12, u32(1000000)).empty());                    // trigramCount beyond the table.
+    CHECK(patched(16, u64(0)).empty());                          // filesOffset inside the header.
+    CHECK(patched(24, u64(Search::HEADER_SIZE - 1)).empty());    // Sections out of order.
+    CHECK(patched(40, u64(full.size() + 1)).empty());            // postingsOffset past the end.
+    CHECK(patched(Search::HEADER_SIZE, "\xff\xff\xff\xff\x0f").empty()); // First path longer than the file.
+
+    // A posting list pointing past the end of the file: the index cannot
+    // narrow the search, so every file stays a candidate.
+    Search::Header header;
+    CHECK(Search::ReadHeader(full.data(), full.size(), header));
+    std::string copy = full;
+    for (uint32_t i = 0; i < header.trigramCount; i++)
+        copy.replace(header.tableOffset + i * Search::TABLE_ENTRY_SIZE + 8, 8, u64(full.size()));
+    Test::WriteFile(Search::IndexPath(), copy);
+    bool narrowed;
+    Candidates("Widget", narrowed);
+    CHECK(!narrowed);
+
+    Test::WriteFile(Search::IndexPath(), full);
+    CHECK(Search::LoadIndex().size() == header.fileCount);
+}
+
+int main()
+{
+    if (!Test::SandboxHome())
+        return 1;
+    RoundTrip();
+    Truncated();
+    Damaged();
+    return Test::Result("SearchTest");
+}
@@ -0,0 +1,120 @@
+#include "Test.hpp"
+#include "../include/Stats.hpp"
+
+// Line counting and the payload of its cache (Stats::Format). The cache
+// itself is covered by FileCacheTest.
+
+static const std::string KEY = "C++/alpha";
+
+static fs::path Root()
+{
+    return fs::path(Main::HOME_PATH) / "Coding/Projects" / KEY;
+}
+
+static std::vector<Stats::FileEntry> Update(size_t &recounted)
+{
+    FileCache::Project project{KEY, Root(), {"src/main.cpp", "run", "README"}};
+    return FileCache::Update<Stats::Format>({project}, recounted).at(0);
+}
+
+// code, comment, blank
+static bool Counted(const std::string &text, const std::string &language, size_t code, size_t comment, size_t blank)
+{
+    Stats::Counts counts = Stats::CountLines(text.data(), text.size(), Stats::Languages()[Stats::FindLanguage(language)]);
+    if (counts.code == code && counts.comment == comment && counts.blank == blank)
+        return true;
+    std::fprintf(stderr, "%zu code, %zu comment, %zu blank for: %s\n", counts.code, counts.comment, counts.blank, text.c_str());
+    return false;
+}
+
+static void Counting()
+{
+    CHECK(Counted("", "C++", 0, 0, 0));
+    CHECK(Counted("int x;\n\n  \t\n// note\n", "C++", 1, 1, 2));
+    CHECK(Counted("int x;", "C++", 1, 0, 0)); // No final newline.
+    // Block comments that start after code, end before code or span lines.
+    CHECK(Counted("int x; /* start\n more comment\n end */\nint y;\n", "C++", 2, 2, 0));
+    CHECK(Counted("/* hdr */ int main() { return 0; }\n", "C++", 1, 0, 0));
+    CHECK(Counted("/* a\n b */ int y;\n", "C++", 1, 1, 0));
+    CHECK(Counted("/* a */ /* b */\n", "C++", 0, 1, 0));
+    CHECK(Counted("int a; /* one */ int b; /* two\n\n */\n", "C++", 1, 2, 0));
+    CHECK(Counted("/*\n\n*/\n", "C++", 0, 3, 0)); // Blank lines inside a comment are comment.
+    CHECK(Counted("int x; /* never closed\nmore\nstill", "C++", 1, 2, 0));
+    CHECK(Counted("int x; // trailing\n", "C++", 1, 0, 0));
+    // Comment markers inside literals are code.
+    CHECK(Counted("const char *url = \"http://x/*\";\nint y;\n", "C++", 2, 0, 0));
+    CHECK(Counted("char c = '\"'; /* q */\n", "C++", 1, 0, 0));
+    CHECK(Counted("s = \"a\\\"/*\"\n", "C++", 1, 0, 0)); // Escaped quote.
+    // Languages with other markers, or none for blocks.
+    CHECK(Counted("# setup\nx = 1  # one\n\"\"\"doc\nstring\"\"\"\n", "Python", 1, 3, 0));
+    CHECK(Counted("# setup\necho hi\n", "Shell", 1, 1, 0));
+}
+
+static void RoundTrip()
+{
+    Test::WriteFile(Root() / "src/main.cpp", "// entry\n\nint main()\n{\n    return 0; /* done */\n}\n");
+    Test::WriteFile(Root() / "run", "#!/bin/sh\n# Start it.\nexec ./app\n");
+    Test::WriteFile(Root() / "README", "No language here.\n");
+
+    size_t recounted;
+    std::vector<Stats::FileEntry> files = Update(recounted);
+    CHECK(recounted == 3);
+    CHECK(files.size() == 3);
+    CHECK(files[0].language == Stats::FindLanguage("C++"));
+    CHECK(files[0].counts.code == 4 && files[0].counts.comment == 1 && files[0].counts.blank == 1);
+    CHECK(files[1].language == Stats::FindLanguage("Shell")); // From the #! line.
+    CHECK(files[1].counts.code == 1 && files[1].counts.comment == 2);
+    CHECK(files[2].language == Stats::NO_LANGUAGE);
+
+    std::vector<Stats::FileEntry> loaded = FileCache::Load<Stats::Format>(KEY);
+    CHECK(loaded.size() == files.size());
+    for (size_t i = 0; i < std::min(loaded.size(), files.size()); i++)
+    {
+        CHECK(loaded[i].language == files[i].language);
+        CHECK(loaded[i].counts.files == files[i].counts.files);
+        CHECK(loaded[i].counts.code == files[i].counts.code);
+        CHECK(loaded[i].counts.comment == files[i].counts.comment);
+        CHECK(loaded[i].counts.blank == files[i].counts.blank);
+    }
+}
+
+// A language byte past the language table is damage, not an index.
+static void Damaged()
+{
+    const std::string path = FileCache::IndexPath<Stats::Format>(KEY);
+    const std::string full = Test::ReadFile(path);
+    auto patched = [&](size_t offset, const std::string &bytes) {
+        Test::WritePatched(path, full, offset, bytes);
+        return FileCache::Load<Stats::Format>(KEY);
+    };
+
+    // The language byte of the first file, just after its path, mtime and size.
+    size_t language = 12 + 1 + std::string("src/main.cpp").size() + 8 + 8;
+    CHECK(patched(language, std::string(1, char(Stats::Languages().size()))).empty());
+    CHECK(patched(language, std::string(1, char(Stats::NO_LANGUAGE))).size() == 3);
+    Test::WriteFile(path, full);
+}
+
+// The load-time scan counts through the same cache: ignored files and
+// files no language claims are left out.
+static void Scanned()
+{
+    Test::WriteFile(Root() / "build/generated.cpp", "int generated;\n");
+    Test::WriteFile(Root() / "data.bin", "int not_counted;\n");
+    Stats::LineCountVisitor visitor;
+    Scan::Walk(Root().string(), Ignore::Load(Root()), {&visitor});
+    CHECK(visitor.files.size() == 3);
+    CHECK(visitor.Finish(KEY, Root()) == 4 + 1); // src/main.cpp and run.
+    CHECK(FileCache::Load<Stats::Format>(KEY).size() == 3);
+}
+
+int main()
+{
+    if (!Test::SandboxHome())
+        return 1;
+    Counting();
+    RoundTrip();
+    Damaged();
+    Scanned();
+    return Test::Result("StatsTest");
+}
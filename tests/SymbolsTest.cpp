@@ -0,0 +1,165 @@
+#include "Test.hpp"
+#include "../include/Symbols.hpp"
+
+// The definitions `devcore symbol` finds and the payload of its cache
+// (Symbols::Format). The cache itself is covered by FileCacheTest.
+
+static const std::string KEY = "C++/alpha";
+static const std::string SOURCE = "#define LIMIT 8\n"
+                                  "namespace app {\n"
+                                  "class Widget { public: int size() const; };\n"
+                                  "int Widget::size() const { return LIMIT; }\n"
+                                  "}\n";
+
+static fs::path Root()
+{
+    return fs::path(Main::HOME_PATH) / "Coding/Projects" / KEY;
+}
+
+static std::vector<Symbols::FileEntry> Update(size_t &reparsed)
+{
+    FileCache::Project project{KEY, Root(), {"include/empty.hpp", "src/widget.cpp"}};
+    return FileCache::Update<Symbols::Format>({project}, reparsed).at(0);
+}
+
+static bool Has(const std::vector<Symbols::Symbol> &symbols, const std::string &name, Symbols::Kind kind, uint32_t line)
+{
+    for (const auto &symbol : symbols)
+    {
+        if (symbol.name == name && symbol.kind == kind && symbol.line == line)
+            return true;
+    }
+    return false;
+}
+
+static std::vector<Symbols::Symbol> Parsed(const std::string &source)
+{
+    return Symbols::Parse(source.data(), source.size());
+}
+
+static void Parsing()
+{
+    using Kind = Symbols::Kind;
+    std::vector<Symbols::Symbol> symbols = Parsed("template <typename T, int N = 3>\n"
+                                                  "struct Array { T data[N]; };\n"
+                                                  "template <typename T>\n"
+                                                  "T Max(T a, T b) { return a > b ? a : b; }\n"
+                                                  "template <>\n"
+                                                  "int Max<int>(int a, int b) { return a; }\n"
+                                                  "template <typename T> class Box<T *> {};\n");
+    CHECK(symbols.size() == 4);
+    CHECK(Has(symbols, "Array", Kind::Struct, 2));
+    CHECK(Has(symbols, "Max", Kind::Function, 4));
+    CHECK(Has(symbols, "Max", Kind::Function, 6)); // Explicit specialization.
+    CHECK(Has(symbols, "Box", Kind::Class, 7));    // Partial specialization.
+
+    symbols = Parsed("struct Vec {\n"
+                     "    bool operator==(const Vec &o) const { return true; }\n"
+                     "    int operator()(int x) const { return x; }\n"
+                     "    explicit operator bool() const { return true; }\n"
+                     "    bool operator<(const Vec &o) const { return false; }\n"
+                     "    int operator[](int i) const { return i; }\n"
+                     "};\n"
+                     "bool operator!=(const Vec &a, const Vec &b) { return !(a == b); }\n");
+    CHECK(symbols.size() == 7);
+    CHECK(Has(symbols, "Vec::operator==", Kind::Function, 2));
+    CHECK(Has(symbols, "Vec::operator()", Kind::Function, 3));
+    CHECK(Has(symbols, "Vec::operator bool", Kind::Function, 4));
+    CHECK(Has(symbols, "Vec::operator<", Kind::Function, 5));
+    CHECK(Has(symbols, "Vec::operator[]", Kind::Function, 6));
+    CHECK(Has(symbols, "operator!=", Kind::Function, 8));
+
+    symbols = Parsed("auto Sum(int a, int b) -> int { return a + b; }\n"
+                     "auto Vec::Length() const -> double { return 0; }\n"
+                     "template <typename T> auto Wrap(T t) -> std::vector<T> { return {t}; }\n");
+    CHECK(symbols.size() == 3);
+    CHECK(Has(symbols, "Sum", Kind::Function, 1));
+    CHECK(Has(symbols, "Vec::Length", Kind::Function, 2));
+    CHECK(Has(symbols, "Wrap", Kind::Function, 3));
+
+    // Brace initializers in an init list neither open a scope nor hide the
+    // definitions after them.
+    symbols = Parsed("class Widget {\n"
+                     "    Widget(int w, int h) : width{w}, height(h), items{1, 2, 3} { Init(); }\n"
+                     "    Widget() : Widget{1, 2} {}\n"
+                     "    int width, height;\n"
+                     "};\n"
+                     "Widget::Widget(const Widget &o) : width{o.width}, items(o.items) {\n"
+                     "    Copy();\n"
+                     "}\n"
+                     "void Widget::Draw() {}\n");
+    CHECK(symbols.size() == 5);
+    CHECK(Has(symbols, "Widget::Widget", Kind::Function, 2));
+    CHECK(Has(symbols, "Widget::Widget", Kind::Function, 3));
+    CHECK(Has(symbols, "Widget::Widget", Kind::Function, 6));
+    CHECK(Has(symbols, "Widget::Draw", Kind::Function, 9));
+
+    // Braces and keywords inside raw strings are text, and their lines count.
+    symbols = Parsed("const char *Text() { return R\"(int fake() { } struct Fake {)\"; }\n"
+                     "const char *More() { return R\"x(\n"
+                     "} namespace evil { )\" )x\"; }\n"
+                     "int After() { return 0; }\n");
+    CHECK(symbols.size() == 3);
+    CHECK(Has(symbols, "Text", Kind::Function, 1));
+    CHECK(Has(symbols, "More", Kind::Function, 2));
+    CHECK(Has(symbols, "After", Kind::Function, 4));
+}
+
+static void RoundTrip()
+{
+    Test::WriteFile(Root() / "include/empty.hpp", "");
+    Test::WriteFile(Root() / "src/widget.cpp", SOURCE);
+
+    size_t reparsed;
+    std::vector<Symbols::FileEntry> files = Update(reparsed);
+    CHECK(reparsed == 2);
+    CHECK(files.size() == 2);
+    CHECK(files[0].symbols.empty());
+    const std::vector<Symbols::Symbol> symbols = files[1].symbols;
+    CHECK(Has(symbols, "LIMIT", Symbols::Kind::Macro, 1));
+    CHECK(Has(symbols, "app", Symbols::Kind::Namespace, 2));
+    CHECK(Has(symbols, "app::Widget", Symbols::Kind::Class, 3));
+    CHECK(Has(symbols, "app::Widget::size", Symbols::Kind::Function, 4));
+
+    std::vector<Symbols::FileEntry> loaded = FileCache::Load<Symbols::Format>(KEY);
+    CHECK(loaded.size() == files.size());
+    for (size_t i = 0; i < std::min(loaded.size(), files.size()); i++)
+    {
+        CHECK(loaded[i].symbols.size() == files[i].symbols.size());
+        for (size_t s = 0; s < std::min(loaded[i].symbols.size(), files[i].symbols.size()); s++)
+        {
+            CHECK(loaded[i].symbols[s].name == files[i].symbols[s].name);
+            CHECK(loaded[i].symbols[s].kind == files[i].symbols[s].kind);
+            CHECK(loaded[i].symbols[s].line == files[i].symbols[s].line);
+        }
+    }
+}
+
+// A symbol count or kind the format cannot hold is damage, not an index.
+static void Damaged()
+{
+    const std::string path = FileCache::IndexPath<Symbols::Format>(KEY);
+    const std::string full = Test::ReadFile(path);
+    auto patched = [&](size_t offset, const std::string &bytes) {
+        Test::WritePatched(path, full, offset, bytes);
+        return FileCache::Load<Symbols::Format>(KEY);
+    };
+
+    // The second file's payload: its symbol count, then kind, line and name.
+    size_t second = 12 + (1 + std::string("include/empty.hpp").size() + 8 + 8 + 1);
+    size_t count = second + 1 + std::string("src/widget.cpp").size() + 8 + 8;
+    CHECK(patched(count, "\xff\xff\xff\xff\x0f").empty());                                     // More symbols than bytes.
+    CHECK(patched(count + 1, std::string(1, char(int(Symbols::Kind::Macro) + 1))).empty()); // Unknown kind.
+    CHECK(patched(count + 1, std::string(1, char(Symbols::Kind::Function))).size() == 2);
+    Test::WriteFile(path, full);
+}
+
+int main()
+{
+    if (!Test::SandboxHome())
+        return 1;
+    Parsing();
+    RoundTrip();
+    Damaged();
+    return Test::Result("SymbolsTest");
+}
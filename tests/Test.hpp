@@ -0,0 +1,88 @@
+#ifndef TEST_HPP
+#define TEST_HPP
+
+#include "../include/Binary.hpp"
+#include "../include/Main.hpp"
+#include <cstdio>
+#include <string>
+#include <filesystem>
+#include <fcntl.h>
+#include <sys/stat.h>
+namespace fs = std::filesystem;
+
+// A minimal harness for the programs in tests/: CHECK records a failure and
+// goes on, main returns Test::Result(). tests/run.sh builds every program and
+// runs it with HOME set to an empty temporary directory, so caches and the
+// DevMap written by a test never touch the user's own.
+namespace Test
+{
+    inline int &Failures()
+    {
+        static int failures = 0;
+        return failures;
+    }
+
+    inline void Check(bool ok, const char *expression, const char *file, int line)
+    {
+        if (ok)
+            return;
+        std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", file, line, expression);
+        Failures()++;
+    }
+
+    inline int Result(const char *name)
+    {
+        std::printf("%s: %s\n", name, Failures() ? "FAILED" : "ok");
+        return Failures() ? 1 : 0;
+    }
+
+    inline std::string ReadFile(const std::string &path)
+    {
+        std::string content;
+        Binary::ReadInto(path, content);
+        return content;
+    }
+
+    inline void WriteFile(const fs::path &path, const std::string &content)
+    {
+        std::error_code ec;
+        fs::create_directories(path.parent_path(), ec);
+        Binary::WriteAtomic(path.string(), content);
+    }
+
+    inline void SetMTime(const fs::path &path, time_t seconds, long nanoseconds)
+    {
+        struct timespec times[2] = {{seconds, nanoseconds}, {seconds, nanoseconds}};
+        utimensat(AT_FDCWD, path.c_str(), times, 0);
+    }
+
+    // A value as Binary::Put stores it, to patch into a cache file.
+    template <typename T>
+    inline std::string Bytes(T value)
+    {
+        std::string out;
+        Binary::Put<T>(out, value);
+        return out;
+    }
+
+    // Write content to path with bytes replacing the ones at offset.
+    inline void WritePatched(const fs::path &path, std::string content, size_t offset, const std::string &bytes)
+    {
+        content.replace(offset, bytes.size(), bytes);
+        WriteFile(path, content);
+    }
+
+    // The temporary HOME of tests/run.sh; refuse to run against a real one.
+    inline bool SandboxHome()
+    {
+        const char *sandbox = std::getenv("DEVCORE_TEST_HOME");
+        if (sandbox && Main::HOME_PATH == sandbox)
+            return true;
+        std::fprintf(stderr, "Run the tests through tests/run.sh.\n");
+        return false;
+    }
+} // namespace Test
+
+#define CHECK(expression) Test::Check((expression), #expression, __FILE__, __LINE__)
+
+#endif // TEST_HPP
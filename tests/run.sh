@@ -0,0 +1,48 @@
+set -e
+cd "$(dirname "$0")/.."
+CXX=${CXX:-g++}
+CC=${CC:-gcc}
+
+# Builds and runs every test in tests/ against the libraries run.sh built,
+# so run that first. HOME points to an empty directory holding only the
+# default config, which gives each program a fresh DevMap and cache.
+if [ ! -f build/libdevcore.a ]; then
+    echo "build/libdevcore.a not found, run run.sh first." >&2
+    exit 1
+fi
+mkdir -p build/tests
+export HOME=$(mktemp -d)
+export DEVCORE_TEST_HOME=$HOME
+trap 'rm -rf "$DEVCORE_TEST_HOME"' EXIT
+
+failed=0
+run() {
+    rm -rf "$HOME"/.config "$HOME"/.cache "$HOME"/Coding
+    mkdir -p "$HOME"/.config/devcore "$HOME"/Coding/Projects
+    cp devcore.conf devmap.json "$HOME"/.config/devcore/
+    "$@" || failed=1
+}
+
+for test in tests/*.cpp; do
+    name=$(basename "$test" .cpp)
+    $CXX -O1 $CXXFLAGS "$test" build/libdevcore.a -o build/tests/$name $LDFLAGS -lz -pthread
+    run build/tests/$name
+done
+
+# The C ABI, called from C.
+for test in tests/*.c; do
+    name=$(basename "$test" .c)
+    $CC -O1 -Wall -Wextra -c "$test" -o build/tests/$name.o
+    $CXX build/tests/$name.o build/libdevcore.a -o build/tests/$name $LDFLAGS -lz -pthread
+    run build/tests/$name
+done
+
+# The Python bindings, over build/libdevcore.so.
+if command -v python3 >/dev/null; then
+    export DEVCORE_LIB=$PWD/build/libdevcore.so
+    run python3 tests/test_devcore.py
+else
+    echo "python3 not found, skipping tests/test_devcore.py." >&2
+fi
+
+exit $failed
@@ -0,0 +1,78 @@
+"""The Python bindings (python/devcore.py) over build/libdevcore.so.
+
+Run through tests/run.sh, which points HOME to an empty directory.
+"""
+
+import os
+import sys
+import unittest
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "python"))
+import devcore  # noqa: E402
+
+PROJECTS = os.path.join(os.environ["HOME"], "Coding", "Projects")
+
+
+def write(relative, content):
+    path = os.path.join(PROJECTS, relative)
+    os.makedirs(os.path.dirname(path), exist_ok=True)
+    with open(path, "w") as file:
+        file.write(content)
+
+
+class BindingsTest(unittest.TestCase):
+    # The tests share one store and run in name order.
+
+    @classmethod
+    def setUpClass(cls):
+        if os.environ.get("DEVCORE_TEST_HOME") != os.environ["HOME"]:
+            raise unittest.SkipTest("Run the tests through tests/run.sh.")
+
+    def test_1_closed(self):
+        self.assertFalse(devcore.is_open())
+        with self.assertRaises(devcore.Error) as raised:
+            devcore.sync()
+        self.assertTrue(str(raised.exception))
+
+    def test_2_open(self):
+        write("C++/alpha/src/main.cpp", "int main() { return 0; }\n")
+        write("Python/tool/run.py", "print('hi')\n")
+        errors = []
+        devcore.open_devcore(on_error=errors.append)
+        self.assertTrue(devcore.is_open())
+        self.assertEqual(errors, [])
+        self.assertTrue(devcore.projects_path().endswith("/Coding/Projects/"))
+
+    def test_3_queries(self):
+        self.assertEqual(sorted(p.name for p in devcore.projects()), ["alpha", "tool"])
+        self.assertEqual([p.name for p in devcore.projects_by_language("Python")], ["tool"])
+        self.assertEqual(devcore.projects_by_language("Cobol"), [])
+        self.assertEqual(devcore.projects_by_user("nobody-at-all"), [])
+
+        alpha = devcore.find_project("alpha")
+        self.assertIsNotNone(alpha)
+        self.assertEqual((alpha.lang, alpha.folder_name), ("C++", "alpha"))
+        self.assertTrue(alpha.path.endswith("/C++/alpha"))
+        self.assertEqual(alpha.size, len("int main() { return 0; }\n"))
+        self.assertEqual(alpha.file_count, 1)
+        self.assertIs(alpha.uses_git, False)
+        self.assertEqual(alpha.dependencies, [])
+        self.assertIn("alpha", repr(alpha))
+        self.assertIsNone(devcore.find_project("missing"))
+        self.assertIsNone(devcore.find_project(None))
+        self.assertEqual(len(devcore.projects_by_user(alpha.created_by)), 2)
+
+    def test_4_sync(self):
+        write("C++/beta/beta.hpp", "struct Beta {};\n")
+        progress = []
+        devcore.sync(on_progress=lambda done, total: progress.append((done, total)))
+        self.assertEqual(sorted(progress), [(1, 2), (2, 2)])  # The projects already in the DevMap.
+        self.assertEqual(sorted(p.name for p in devcore.projects()), ["alpha", "beta", "tool"])
+
+    def test_5_no_builtin_shadowed(self):
+        self.assertNotIn("open", devcore.__all__)
+        self.assertFalse(hasattr(devcore, "open"))
+
+
+if __name__ == "__main__":
+    unittest.main()